@@ -38,6 +38,8 @@
 #include <ros/ros.h>
 
 #include <string>
+#include <vector>
+#include <unordered_map>
 #include <ctype.h>
 
 #include <dbc/DbcMessage.h>
@@ -48,17 +50,39 @@ namespace NewEagle
   {
     public:
       Dbc();
+      Dbc(const Dbc &other);
+      Dbc(Dbc &&other);
       ~Dbc();
 
-      void AddMessage(std::string messageName, NewEagle::DbcMessage message);
-      NewEagle::DbcMessage* GetMessage(std::string messageName);
+      Dbc& operator=(const Dbc &other);
+      Dbc& operator=(Dbc &&other);
+
+      void AddMessage(const std::string &messageName, const NewEagle::DbcMessage &message);
+      void AddMessage(const std::string &messageName, NewEagle::DbcMessage &&message);
+      NewEagle::DbcMessage* GetMessage(const std::string &messageName);
       NewEagle::DbcMessage* GetMessageById(uint32_t id);
+      NewEagle::DbcMessage* GetMessageById(uint32_t id, NewEagle::IdType idType);
+      const NewEagle::DbcMessage* GetMessage(const std::string &messageName) const;
+      const NewEagle::DbcMessage* GetMessageById(uint32_t id) const;
+      const NewEagle::DbcMessage* GetMessageById(uint32_t id, NewEagle::IdType idType) const;
+      NewEagle::DbcMessage* ResolveMessage(const std::string &messageName);
+      NewEagle::DbcMessage* ResolveMessageById(uint32_t id);
+      const NewEagle::DbcMessage* ResolveMessage(const std::string &messageName) const;
+      const NewEagle::DbcMessage* ResolveMessageById(uint32_t id) const;
       uint16_t GetMessageCount();
       std::map<std::string, NewEagle::DbcMessage>* GetMessages();
 
     private:
       std::map<std::string, NewEagle::DbcMessage> _messages;
 
+      // CAN ID index into _messages.  11-bit IDs use a dense table, 29-bit IDs a hash.
+      //  Points into _messages, so it is rebuilt after a copy.
+      std::vector<NewEagle::DbcMessage*> _standardIndex;
+      std::unordered_map<uint32_t, NewEagle::DbcMessage*> _extendedIndex;
+
+      void IndexMessage(NewEagle::DbcMessage* message);
+      void BuildIndex();
+
   };
 }
 
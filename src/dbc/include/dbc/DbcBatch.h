@@ -0,0 +1,77 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _NEW_EAGLE_DBC_BATCH_H
+#define _NEW_EAGLE_DBC_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <dbc/DbcMessage.h>
+
+namespace NewEagle
+{
+  // Decoded values of one message over many frames, one column per signal.
+  //  Columns follow the message's signal order (by name).  A multiplexed signal
+  //  is NaN in the rows where the switch selects another page.
+  struct SignalColumns
+  {
+    std::vector<std::string> Names;
+    std::vector<std::vector<double> > Values;
+    size_t FrameCount;
+
+    const std::vector<double>* GetColumn(const std::string &signalName) const;
+  };
+
+  enum BatchKernel
+  {
+    BATCH_SCALAR = 0,
+    BATCH_SSE4 = 1,
+    BATCH_AVX2 = 2
+  };
+
+  // Widest kernel the CPU supports.
+  BatchKernel GetBatchKernel();
+
+  // Decodes n payloads of the same message into columns.  Values are bit-identical
+  //  to SetFrame followed by GetResult.  Does not touch the message's own state.
+  //  Classic 8 byte messages only; a CAN FD message throws std::runtime_error.
+  void DecodeBatch(const NewEagle::DbcMessage &message, const uint8_t (*frames)[8], size_t n, NewEagle::SignalColumns &columns);
+  void DecodeBatch(const NewEagle::DbcMessage &message, const uint8_t (*frames)[8], size_t n, NewEagle::SignalColumns &columns, BatchKernel kernel);
+}
+
+#endif // _NEW_EAGLE_DBC_BATCH_H
@@ -31,13 +31,14 @@
  *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  *  POSSIBILITY OF SUCH DAMAGE.
  *********************************************************************/
- 
+
 #ifndef _NEW_EAGLE_DBCBUILDER_H
 #define _NEW_EAGLE_DBCBUILDER_H
 
 #include <ros/ros.h>
 
 #include <string>
+#include <vector>
 
 #include <dbc/Dbc.h>
 
@@ -58,7 +59,33 @@ namespace NewEagle
     uint32_t Id;
     std::string ObjectType;
     std::string SignalName;
-    std::string Value;
+    double Value;
+  };
+
+  enum DbcCollisionType
+  {
+    ID_COLLISION = 0,
+    NAME_COLLISION = 1
+  };
+
+  // A message left out of a merge because an earlier file already defined its
+  //  CAN ID or its name.  The first definition, in file order, is the one kept.
+  struct DbcCollision
+  {
+    NewEagle::DbcCollisionType Type;
+    uint32_t Id;
+    NewEagle::IdType IdType;
+    std::string KeptFile;
+    std::string KeptMessage;
+    std::string DroppedFile;
+    std::string DroppedMessage;
+  };
+
+  struct DbcMergeReport
+  {
+    std::vector<NewEagle::DbcCollision> Collisions;
+
+    std::string ToString() const;
   };
 
   class DbcBuilder
@@ -67,7 +94,21 @@ namespace NewEagle
       DbcBuilder();
       ~DbcBuilder();
 
+      // Parses the contents of a DBC file, not its path.
       NewEagle::Dbc NewDbc(const std::string &dbcFile);
+      NewEagle::Dbc NewDbc(const char* data, size_t size);
+
+      // Maps the DBC file at path and parses it in place, without reading it into a
+      //  string first.  Throws std::runtime_error when the file cannot be read.
+      NewEagle::Dbc NewDbcFromFile(const std::string &path);
+
+      // Parses the files concurrently, up to threads at a time (0 for one per core),
+      //  and merges them into one Dbc.  Messages whose ID or name is already taken are
+      //  dropped and listed in report, except VECTOR__INDEPENDENT_SIG_MSG, which every
+      //  Vector DBC has and which is just dropped.  Throws std::runtime_error if a file
+      //  cannot be read.
+      NewEagle::Dbc NewDbcFromFiles(const std::vector<std::string> &paths, NewEagle::DbcMergeReport &report);
+      NewEagle::Dbc NewDbcFromFiles(const std::vector<std::string> &paths, NewEagle::DbcMergeReport &report, size_t threads);
 
     private:
       std::string MessageToken;
@@ -78,85 +119,136 @@ namespace NewEagle
       std::string SignalValueTypeToken;
   };
 
+      // The Read* helpers return false on a malformed statement instead of throwing,
+      //  so a bad line costs no more than a good one.
 
-      static NewEagle::DbcSignalValueType ReadSignalValueType(NewEagle::LineParser parser)
+      static bool ReadSignalValueType(NewEagle::LineParser &parser, NewEagle::DbcSignalValueType &signalValueType)
       {
-        NewEagle::DbcSignalValueType signalValueType;
+        NewEagle::LineToken name;
+        uint32_t type;
+
+        if (!parser.TryReadUInt(signalValueType.Id) ||
+            !parser.TryReadCIdentifier(name) ||
+            !parser.TrySeekSeparator(':') ||
+            !parser.TryReadUInt(type))
+        {
+          return false;
+        }
 
-        signalValueType.Id = parser.ReadUInt("id");
-        signalValueType.SignalName = parser.ReadCIdentifier();
-        parser.SeekSeparator(':');
-        signalValueType.Type = parser.ReadUInt("DataType") == 1 ? NewEagle::FLOAT : NewEagle::DOUBLE;
+        signalValueType.SignalName = name.ToString();
+        signalValueType.Type = type == 1 ? NewEagle::FLOAT : NewEagle::DOUBLE;
 
-        return signalValueType;
+        return true;
       }
 
-      static NewEagle::DbcAttribute ReadAttribute(NewEagle::LineParser parser)
+      // Only GenSigStartValue on signals is read; for anything else ObjectType stays empty.
+      static bool ReadAttribute(NewEagle::LineParser &parser, NewEagle::DbcAttribute &attribute)
       {
-        NewEagle::DbcAttribute attribute;
+        NewEagle::LineToken attributeName;
 
-        try
+        if (!parser.TryReadQuotedString(attributeName))
         {
-          attribute.AttributeName = parser.ReadQuotedString();
-          if (attribute.AttributeName == "GenSigStartValue")
-          {
-              attribute.ObjectType = parser.ReadCIdentifier();
-              attribute.Id = parser.ReadUInt("id");
-              if (attribute.ObjectType == "SG_")
-              {
-                attribute.SignalName = parser.ReadCIdentifier();
-
-                std::ostringstream sstream;
-                sstream << parser.ReadDouble();
-                attribute.Value = sstream.str();
-              }
-          }
+          return false;
         }
-        catch(std::exception& ex)
+
+        attribute.AttributeName = attributeName.ToString();
+
+        if (attribute.AttributeName == "GenSigStartValue")
         {
-          throw;
+          NewEagle::LineToken objectType;
+          NewEagle::LineToken signalName;
+
+          if (!parser.TryReadCIdentifier(objectType) || !parser.TryReadUInt(attribute.Id))
+          {
+            return false;
+          }
+
+          attribute.ObjectType = objectType.ToString();
+
+          if (attribute.ObjectType == "SG_")
+          {
+            if (!parser.TryReadCIdentifier(signalName) || !parser.TryReadDouble(attribute.Value))
+            {
+              return false;
+            }
+
+            attribute.SignalName = signalName.ToString();
+          }
         }
 
-        return attribute;
+        return true;
       }
 
-      static NewEagle::DbcMessageComment ReadMessageComment(NewEagle::LineParser parser)
+      static bool ReadMessageComment(NewEagle::LineParser &parser, NewEagle::DbcMessageComment &comment)
       {
-        NewEagle::DbcMessageComment comment;
-        comment.Id = parser.ReadUInt("id");
-        comment.Comment = parser.ReadQuotedString();
+        NewEagle::LineToken text;
 
-        return comment;
+        if (!parser.TryReadUInt(comment.Id) || !parser.TryReadQuotedString(text))
+        {
+          return false;
+        }
+
+        comment.Comment = text.ToString();
+
+        return true;
       }
 
-      static NewEagle::DbcSignalComment ReadSignalComment(NewEagle::LineParser parser)
+      static bool ReadSignalComment(NewEagle::LineParser &parser, NewEagle::DbcSignalComment &comment)
       {
-        NewEagle::DbcSignalComment comment;
-        comment.Id = parser.ReadUInt("id");
-        comment.SignalName = parser.ReadCIdentifier();
-        comment.Comment = parser.ReadQuotedString();
+        NewEagle::LineToken name;
+        NewEagle::LineToken text;
+
+        if (!parser.TryReadUInt(comment.Id) || !parser.TryReadCIdentifier(name) || !parser.TryReadQuotedString(text))
+        {
+          return false;
+        }
 
-        return comment;
+        comment.SignalName = name.ToString();
+        comment.Comment = text.ToString();
+
+        return true;
       }
 
-      static NewEagle::DbcMessage ReadMessage(NewEagle::LineParser parser)
+      static bool ReadMessage(NewEagle::LineParser &parser, NewEagle::DbcMessage &msg)
       {
-        uint32_t canId = parser.ReadUInt("message id");
+        uint32_t canId;
+        uint32_t size;
+        NewEagle::LineToken name;
+        NewEagle::LineToken sendingNode;
+
+        if (!parser.TryReadUInt(canId) ||
+            !parser.TryReadCIdentifier(name) ||
+            !parser.TrySeekSeparator(':') ||
+            !parser.TryReadUInt(size) ||
+            !parser.TryReadCIdentifier(sendingNode))
+        {
+          return false;
+        }
+
+        if (size > NewEagle::MAX_PAYLOAD_SIZE)
+        {
+          ROS_ERROR("DBC message is longer than a CAN FD frame: %s", name.ToString().c_str());
+          return false;
+        }
+
         IdType idType = ((canId & 0x80000000u) > 0) ? NewEagle::EXT : NewEagle::STD;
-        std::string name(parser.ReadCIdentifier("message name"));
-        parser.SeekSeparator(':');
-        uint8_t dlc = parser.ReadUInt("size");
-        std::string sendingNode(parser.ReadCIdentifier("transmitter"));
         uint32_t id = (uint32_t)(canId & 0x3FFFFFFFu);
 
-        NewEagle::DbcMessage msg(dlc, id, idType, name, canId);
-        return msg;
+        msg = NewEagle::DbcMessage((uint8_t)size, id, idType, name.ToString(), canId);
+
+        return true;
       }
 
-      static NewEagle::DbcSignal ReadSignal(NewEagle::LineParser parser)
+      static bool ReadSignal(NewEagle::LineParser &parser, uint8_t dlc, std::vector<NewEagle::DbcSignal> &signals)
       {
-        std::string name = parser.ReadCIdentifier();
-        char mux = parser.ReadNextChar("mux");
+        NewEagle::LineToken name;
+        char mux;
+
+        if (!parser.TryReadCIdentifier(name) || !parser.TryReadNextChar(mux))
+        {
+          return false;
+        }
+
         NewEagle::MultiplexerMode multiplexMode = NewEagle::NONE;
         int32_t muxSwitch = 0;
 
@@ -166,25 +258,36 @@ namespace NewEagle
             break;
           case 'M':
             multiplexMode = NewEagle::MUX_SWITCH;
-            parser.SeekSeparator(':');
+            if (!parser.TrySeekSeparator(':'))
+            {
+              return false;
+            }
             break;
           case 'm':
             multiplexMode = NewEagle::MUX_SIGNAL;
-            muxSwitch = parser.ReadInt();
-            parser.SeekSeparator(':');
+            if (!parser.TryReadInt(muxSwitch) || !parser.TrySeekSeparator(':'))
+            {
+              return false;
+            }
             break;
           default:
-            throw std::runtime_error("Synxax Error: Expected \':\' " + parser.GetPosition());
+            return false;
         }
 
-        int32_t startBit = parser.ReadUInt("start bit");
-
-        parser.SeekSeparator('|');
-
-        uint8_t length = (uint8_t)parser.ReadUInt("size");
-        parser.SeekSeparator('@');
-
-        char byteOrder = parser.ReadNextChar("byte order");
+        uint32_t startBit;
+        uint32_t length;
+        char byteOrder;
+        char valType;
+
+        if (!parser.TryReadUInt(startBit) ||
+            !parser.TrySeekSeparator('|') ||
+            !parser.TryReadUInt(length) ||
+            !parser.TrySeekSeparator('@') ||
+            !parser.TryReadNextChar(byteOrder) ||
+            !parser.TryReadNextChar(valType))
+        {
+          return false;
+        }
 
         NewEagle::ByteOrder endianness;
 
@@ -196,10 +299,9 @@ namespace NewEagle
             endianness = NewEagle::BIG_END;
             break;
           default:
-            throw std::runtime_error("Synxax Error: Byte Order - Expected 0 or 1, got " + byteOrder);
+            return false;
         }
 
-        char valType = parser.ReadNextChar("value type");
         NewEagle::SignType sign;
 
         switch (valType) {
@@ -210,41 +312,38 @@ namespace NewEagle
             sign = NewEagle::SIGNED;
             break;
           default:
-            throw std::runtime_error("Synxax Error: Value Type - Expected + or -, got " + valType);
+            return false;
         }
 
-        // Set the default data type: INT.
-        //  Might be changed what parsing SIG_VALTYPE_
-        NewEagle::DataType type = NewEagle::INT;
-
-
-        parser.SeekSeparator('(');
-        double gain = parser.ReadDouble("factor");
-        parser.SeekSeparator(',');
-        double offset = parser.ReadDouble("offset");
-        parser.SeekSeparator(')');
-
-        parser.SeekSeparator('[');
-        double minimum = parser.ReadDouble("minimum");
-        parser.SeekSeparator('|');
-        double maximum = parser.ReadDouble("maximum");
-        parser.SeekSeparator(']');
-
-        // Need to include Min, Max, DataType, MuxSwitch, Unit, Receiver
-        // Find a way to include the DLC...
-        NewEagle::DbcSignal* signal;
+        double gain;
+        double offset;
+        double minimum;
+        double maximum;
+
+        if (!parser.TrySeekSeparator('(') ||
+            !parser.TryReadDouble(gain) ||
+            !parser.TrySeekSeparator(',') ||
+            !parser.TryReadDouble(offset) ||
+            !parser.TrySeekSeparator(')') ||
+            !parser.TrySeekSeparator('[') ||
+            !parser.TryReadDouble(minimum) ||
+            !parser.TrySeekSeparator('|') ||
+            !parser.TryReadDouble(maximum) ||
+            !parser.TrySeekSeparator(']'))
+        {
+          return false;
+        }
 
+        // Need to include Min, Max, Unit, Receiver.
+        //  The data type starts as INT and may be changed by SIG_VALTYPE_.
         if (NewEagle::MUX_SIGNAL == multiplexMode) {
-          //NewEagle::DbcSignal signal(8, gain, offset, startBit, endianness, length, sign, name, multiplexMode, muxSwitch);
-          signal = new NewEagle::DbcSignal(8, gain, offset, startBit, endianness, length, sign, name, multiplexMode, muxSwitch);
+          signals.push_back(NewEagle::DbcSignal(dlc, gain, offset, (uint16_t)startBit, endianness, (uint8_t)length, sign, name.ToString(), multiplexMode, muxSwitch));
         }
         else {
-          //NewEagle::DbcSignal signal(8, gain, offset, startBit, endianness, length, sign, name, multiplexMode);
-          signal = new NewEagle::DbcSignal(8, gain, offset, startBit, endianness, length, sign, name, multiplexMode);
+          signals.push_back(NewEagle::DbcSignal(dlc, gain, offset, (uint16_t)startBit, endianness, (uint8_t)length, sign, name.ToString(), multiplexMode));
         }
 
-        signal->SetDataType(type);
-        return NewEagle::DbcSignal(*signal);
+        return true;
       }
 }
 
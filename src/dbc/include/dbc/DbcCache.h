@@ -0,0 +1,89 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _NEW_EAGLE_DBC_CACHE_H
+#define _NEW_EAGLE_DBC_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <string>
+
+#include <dbc/Dbc.h>
+
+namespace NewEagle
+{
+  // SHA-256 of a DBC text.
+  typedef std::array<uint8_t, 32> DbcDigest;
+
+  // Built Dbc objects saved in a binary image, one file per DBC text, named by the SHA-256
+  //  of that text and holding it in its header.  The first load of a DBC parses it and
+  //  writes the image.  Later loads map the image and rebuild the DbcMessage and DbcSignal
+  //  objects from its fixed-size records, with no text parsing; the records are copied
+  //  out, not used in place.  A missing, stale or damaged image just falls back to parsing.
+  class DbcCache
+  {
+    public:
+      // An empty directory disables the cache, so Load always parses.
+      DbcCache(const std::string &directory);
+      ~DbcCache();
+
+      NewEagle::Dbc Load(const std::string &dbcFile);
+      NewEagle::Dbc Load(const char* data, size_t size);
+
+      // Maps the DBC file at path and hashes and parses it in place.  Throws
+      //  std::runtime_error when the file cannot be read.
+      NewEagle::Dbc LoadFile(const std::string &path);
+
+      std::string GetPath(const char* data, size_t size) const;
+
+      // $ROS_HOME/dbc_cache, or ~/.ros/dbc_cache when ROS_HOME is not set.
+      static std::string DefaultDirectory();
+
+      // SHA-256 of the DBC text.  Names the image file and is checked against the copy in
+      //  its header, so two texts never share an image.
+      static NewEagle::DbcDigest Hash(const char* data, size_t size);
+
+    private:
+      std::string _directory;
+
+      std::string GetPath(const NewEagle::DbcDigest &hash) const;
+
+      bool Read(const std::string &path, const NewEagle::DbcDigest &hash, size_t size, NewEagle::Dbc &dbc) const;
+      bool Write(const std::string &path, const NewEagle::DbcDigest &hash, size_t size, NewEagle::Dbc &dbc) const;
+  };
+}
+
+#endif // _NEW_EAGLE_DBC_CACHE_H
@@ -0,0 +1,252 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _NEW_EAGLE_DBC_CODEC_H
+#define _NEW_EAGLE_DBC_CODEC_H
+
+#include <stdint.h>
+#include <cmath>
+#include <ratio>
+
+#include <dbc/DbcSignal.h>
+
+// Bit helpers shared by DbcSignal's runtime plan, the Signal template below and
+//  codecs generated by dbc_codegen, so all three agree bit for bit.
+namespace NewEagle
+{
+  namespace Codec
+  {
+    // Motorola bits counted from the MSB of byte 0 down, so a signal's bits are consecutive.
+    //  Returns the count of its LSB.
+    constexpr int32_t MotorolaLsb(uint16_t startBit, uint8_t length)
+    {
+      return ((int32_t)startBit / 8) * 8 + 7 - (int32_t)startBit % 8 + (int32_t)length - 1;
+    }
+
+    // A frame of 8 bytes or less is read as one 64-bit word.  Longer CAN FD payloads
+    //  are read through an 8 byte window that starts at the signal's first byte (Intel)
+    //  or ends at its last byte (Motorola), clamped to the payload.
+    constexpr uint8_t WindowOffset(uint16_t startBit, uint8_t length, bool bigEndian, uint8_t frameSize)
+    {
+      return (frameSize <= 8) ? 0
+        : bigEndian
+          ? (uint8_t)(MotorolaLsb(startBit, length) / 8 < 7 ? 0
+            : MotorolaLsb(startBit, length) / 8 - 7 < frameSize - 8 ? MotorolaLsb(startBit, length) / 8 - 7 : frameSize - 8)
+          : (uint8_t)((int32_t)startBit / 8 < frameSize - 8 ? (int32_t)startBit / 8 : frameSize - 8);
+    }
+
+    // Position of the signal's LSB in the window word.  Intel start bits are the LSB
+    //  of the little-endian word; Motorola start bits are the MSB, so convert to the
+    //  big-endian word and walk down to the LSB.
+    constexpr int32_t LsbPosition(uint16_t startBit, uint8_t length, bool bigEndian, uint8_t offset = 0)
+    {
+      return bigEndian
+        ? ((int32_t)offset + 8) * 8 - 1 - MotorolaLsb(startBit, length)
+        : (int32_t)startBit - (int32_t)offset * 8;
+    }
+
+    // Whether the signal fits in its window word.
+    constexpr bool Fits(int32_t lsb, uint8_t length)
+    {
+      return (length > 0) && (lsb >= 0) && (lsb + (int32_t)length <= 64);
+    }
+
+    // Whether the signal lies inside a payload of frameSize bytes.  A signal of more
+    //  than 57 bits that is not byte aligned can fit the payload but spill out of its window.
+    constexpr bool FitsFrame(uint16_t startBit, uint8_t length, bool bigEndian, uint8_t frameSize)
+    {
+      return (length > 0) && (length <= 64) && (bigEndian
+        ? MotorolaLsb(startBit, length) < (int32_t)frameSize * 8
+        : (int32_t)startBit + (int32_t)length <= (int32_t)frameSize * 8);
+    }
+
+    constexpr uint64_t LengthMask(uint8_t length)
+    {
+      return (length >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << length) - 1);
+    }
+
+    constexpr uint64_t SignBit(uint8_t length, bool isSigned)
+    {
+      return (isSigned && length > 0) ? ((uint64_t)1 << (length - 1)) : 0;
+    }
+
+    // Frame bytes read as a little-endian word (Intel signals).
+    constexpr uint64_t LoadIntel(const uint8_t* data)
+    {
+      return (uint64_t)data[0] | ((uint64_t)data[1] << 8) | ((uint64_t)data[2] << 16) | ((uint64_t)data[3] << 24) |
+        ((uint64_t)data[4] << 32) | ((uint64_t)data[5] << 40) | ((uint64_t)data[6] << 48) | ((uint64_t)data[7] << 56);
+    }
+
+    // Frame bytes read as a big-endian word (Motorola signals).
+    constexpr uint64_t LoadMotorola(const uint8_t* data)
+    {
+      return ((uint64_t)data[0] << 56) | ((uint64_t)data[1] << 48) | ((uint64_t)data[2] << 40) | ((uint64_t)data[3] << 32) |
+        ((uint64_t)data[4] << 24) | ((uint64_t)data[5] << 16) | ((uint64_t)data[6] << 8) | (uint64_t)data[7];
+    }
+
+    constexpr uint64_t Extract(uint64_t word, uint8_t shift, uint64_t mask)
+    {
+      return (word >> shift) & mask;
+    }
+
+    constexpr int64_t SignExtend(uint64_t raw, uint64_t signBit)
+    {
+      return (int64_t)((raw ^ signBit) - signBit);
+    }
+
+    inline void Insert(uint64_t &word, uint8_t shift, uint64_t mask, uint64_t raw)
+    {
+      word &= ~(mask << shift);
+      word |= (raw & mask) << shift;
+    }
+
+    inline void StoreIntel(uint8_t* data, uint64_t word)
+    {
+      for (int i = 0; i < 8; i++)
+      {
+        data[i] = (uint8_t)(word >> (8 * i));
+      }
+    }
+
+    inline void StoreMotorola(uint8_t* data, uint64_t word)
+    {
+      for (int i = 0; i < 8; i++)
+      {
+        data[i] = (uint8_t)(word >> (8 * (7 - i)));
+      }
+    }
+
+    // Read-modify-write of one signal's window in a CAN FD payload.
+    inline void InsertWindow(uint8_t* data, uint8_t offset, bool bigEndian, uint8_t shift, uint64_t mask, uint64_t raw)
+    {
+      uint64_t word = bigEndian ? LoadMotorola(data + offset) : LoadIntel(data + offset);
+      Insert(word, shift, mask, raw);
+
+      if (bigEndian)
+      {
+        StoreMotorola(data + offset, word);
+      }
+      else
+      {
+        StoreIntel(data + offset, word);
+      }
+    }
+
+    // Merges the two words back into the frame, the inverse of the loads above.
+    inline void Store(uint8_t* data, uint64_t intelWord, uint64_t motorolaWord)
+    {
+      for (int i = 0; i < 8; i++)
+      {
+        data[i] = (uint8_t)(intelWord >> (8 * i)) | (uint8_t)(motorolaWord >> (8 * (7 - i)));
+      }
+    }
+
+    // A scaled value in raw steps, before it is truncated to the raw bits.  A value within
+    //  floating point error of a step is taken as that step, so a decoded value encodes
+    //  back to the raw it came from instead of the step below.
+    inline double ScaledRaw(double value, double gain, double offset)
+    {
+      double raw = (value - offset) / gain;
+      double step = std::round(raw);
+      return (std::fabs(raw - step) < 1e-6) ? step : raw;
+    }
+
+    // A signal whose layout and scaling are fixed at compile time, for hand-written
+    //  hot paths.  Gain and Offset are std::ratio types, e.g.
+    //
+    //    typedef Signal<8, 16, LITTLE_END, UNSIGNED, std::ratio<1, 10> > PedalInput;
+    //    double pedal = PedalInput::Unpack(frame.data.elems);
+    //
+    //  Unpack and Pack produce the same bits as the runtime Unpack/Pack for a
+    //  DbcSignal with the same definition.  FrameSize is the DBC message size, up
+    //  to 64 bytes for CAN FD.
+    template <uint16_t StartBit, uint8_t Length, NewEagle::ByteOrder Order, NewEagle::SignType Sign,
+      typename Gain = std::ratio<1>, typename Offset = std::ratio<0>, uint8_t FrameSize = 8>
+    struct Signal
+    {
+      static constexpr bool BigEndian = (NewEagle::BIG_END == Order);
+      static constexpr uint8_t Window = WindowOffset(StartBit, Length, BigEndian, FrameSize);
+      static constexpr int32_t Lsb = LsbPosition(StartBit, Length, BigEndian, Window);
+
+      static_assert(FitsFrame(StartBit, Length, BigEndian, FrameSize < 8 ? 8 : FrameSize), "signal does not fit in the frame");
+      static_assert(Fits(Lsb, Length), "signal spans 9 bytes, only the runtime codec handles it");
+
+      static constexpr uint8_t Shift = (uint8_t)Lsb;
+      static constexpr uint64_t Mask = LengthMask(Length);
+      static constexpr uint64_t SignBitMask = SignBit(Length, NewEagle::SIGNED == Sign);
+      static constexpr bool Scaled = (Gain::num != Gain::den) || (Offset::num != 0);
+      static constexpr double GainValue = (double)Gain::num / (double)Gain::den;
+      static constexpr double OffsetValue = (double)Offset::num / (double)Offset::den;
+
+      static constexpr uint64_t Load(const uint8_t* data)
+      {
+        return BigEndian ? LoadMotorola(data + Window) : LoadIntel(data + Window);
+      }
+
+      // Raw bits, sign-extended for signed signals.
+      static constexpr int64_t UnpackRaw(const uint8_t* data)
+      {
+        return SignBitMask
+          ? SignExtend(Extract(Load(data), Shift, Mask), SignBitMask)
+          : (int64_t)Extract(Load(data), Shift, Mask);
+      }
+
+      static constexpr double Unpack(const uint8_t* data)
+      {
+        return Scaled
+          ? (double)UnpackRaw(data) * GainValue + OffsetValue
+          : (double)UnpackRaw(data);
+      }
+
+      static void PackRaw(uint8_t* data, uint64_t raw)
+      {
+        InsertWindow(data, Window, BigEndian, Shift, Mask, raw);
+      }
+
+      static void Pack(uint8_t* data, double value)
+      {
+        if (Scaled)
+        {
+          value = ScaledRaw(value, GainValue, OffsetValue);
+        }
+
+        // Truncated through 64 bits, as the runtime Pack does.
+        uint64_t raw = SignBitMask ? (uint64_t)(int64_t)value : (uint64_t)value;
+        PackRaw(data, raw);
+      }
+    };
+  }
+}
+
+#endif // _NEW_EAGLE_DBC_CODEC_H
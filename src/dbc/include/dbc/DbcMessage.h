@@ -36,6 +36,7 @@
 #define _NEW_EAGLE_DBC_MESSAGE_H
 
 #include <string>
+#include <vector>
 #include <can_msgs/Frame.h>
 
 #include <dbc/DbcSignal.h>
@@ -65,6 +66,34 @@ namespace NewEagle
     uint8_t :8;
   } EmptyData;
 
+  // Counts of frames given to SetFrame, and of those that repeated the last payload
+  //  and so were not decoded again.
+  struct DbcFrameStats
+  {
+    uint64_t Frames;
+    uint64_t Repeats;
+  };
+
+  // Signal values for one frame, owned by the caller and indexed by DbcSignal::GetIndex.
+  //  Decode and Encode only read the message, so many threads can share one const Dbc.
+  struct DecodedFrame
+  {
+    std::vector<double> Values;
+
+    double GetValue(const NewEagle::DbcSignal* signal) const;
+    void SetValue(const NewEagle::DbcSignal* signal, double value);
+
+    // Raw value of a signal, unscaled as with DbcSignal::GetRaw and SetRaw.
+    int64_t GetRaw(const NewEagle::DbcSignal* signal) const;
+    void SetRaw(const NewEagle::DbcSignal* signal, int64_t raw);
+
+    template <class T>
+    T GetRawAs(const NewEagle::DbcSignal* signal) const
+    {
+      return static_cast<T>(GetRaw(signal));
+    }
+  };
+
   class DbcMessage
   {
     public:
@@ -76,33 +105,117 @@ namespace NewEagle
         std::string name,
         uint32_t rawId
      );
+     DbcMessage(const DbcMessage &other);
+     DbcMessage(DbcMessage &&other);
 
      ~DbcMessage();
 
-     uint8_t GetDlc();
-     uint32_t GetId();
-     IdType GetIdType();
-     std::string GetName();
+     DbcMessage& operator=(const DbcMessage &other);
+     DbcMessage& operator=(DbcMessage &&other);
+
+     uint8_t GetDlc() const;
+     uint32_t GetId() const;
+     IdType GetIdType() const;
+     std::string GetName() const;
      can_msgs::Frame GetFrame();
-     uint32_t GetSignalCount();
-     void SetFrame(const can_msgs::Frame::ConstPtr& msg);
+     void EncodeFrame(can_msgs::Frame &frame);
+     void EncodeFrame(uint8_t* data);
+     // Puts every signal back to its initial value (GenSigStartValue) by copying a
+     //  payload built from them, so a command only has to set the signals it uses.
+     void ResetToDefaults();
+     // Same for a frame of the caller's, which gets a value for every signal, as Encode needs.
+     void ResetToDefaults(NewEagle::DecodedFrame &frame) const;
+     uint32_t GetSignalCount() const;
+     // Returns false when the payload repeats the last one and the signals still hold
+     //  its decode, in which case nothing is decoded again.
+     bool SetFrame(const can_msgs::Frame::ConstPtr& msg);
+     bool SetFrame(const uint8_t* data, size_t length);
+     NewEagle::DbcFrameStats GetFrameStats() const;
+     void ResetFrameStats();
+     void Decode(const uint8_t* data, NewEagle::DecodedFrame &frame) const;
+     void Decode(const can_msgs::Frame &msg, NewEagle::DecodedFrame &frame) const;
+     void Encode(const NewEagle::DecodedFrame &frame, uint8_t* data) const;
+     void Encode(const NewEagle::DecodedFrame &frame, can_msgs::Frame &msg) const;
      void AddSignal(std::string signalName, NewEagle::DbcSignal signal);
-     NewEagle::DbcSignal* GetSignal(std::string signalName);
+     void AddSignals(const std::vector<NewEagle::DbcSignal> &signals);
+     NewEagle::DbcSignal* GetSignal(const std::string &signalName);
+     NewEagle::DbcSignal* ResolveSignal(const std::string &signalName);
+     const NewEagle::DbcSignal* GetSignal(const std::string &signalName) const;
+     const NewEagle::DbcSignal* ResolveSignal(const std::string &signalName) const;
      void SetRawText(std::string rawText);
-     uint32_t GetRawId();
+     uint32_t GetRawId() const;
      void SetComment(NewEagle::DbcMessageComment comment);
+     NewEagle::DbcMessageComment GetComment() const;
      std::map<std::string, NewEagle::DbcSignal>* GetSignals();
+     const std::map<std::string, NewEagle::DbcSignal>* GetSignals() const;
      bool AnyMultiplexedSignals();
+     void SetLazyDecode(bool lazy);
+     bool GetLazyDecode();
 
    private:
      std::map<std::string, NewEagle::DbcSignal> _signals;
-     uint8_t _data[8];
+     uint8_t _data[NewEagle::MAX_PAYLOAD_SIZE]; // CAN FD messages encode into this instead of the frame words
      uint8_t _dlc;
      uint32_t _id;
      IdType _idType;
      std::string _name;
      uint32_t _rawId;
      NewEagle::DbcMessageComment _comment;
+
+     // Signals flattened so the frame loops walk an array instead of the tree.
+     //  Points into _signals, so it is rebuilt after a copy or AddSignal.  Kept
+     //  current eagerly so the const Decode/Encode never have to build it.
+     std::vector<NewEagle::DbcSignal*> _compiledSignals;
+     size_t _baseSignalCount;
+     NewEagle::DbcSignal* _muxSwitch;
+
+     // Bit plans of _compiledSignals in the same order, copied into one array so a
+     //  frame walk reads contiguous memory instead of chasing each signal's map node.
+     std::vector<NewEagle::DbcSignalPlan> _plans;
+
+     // Multiplexed signals are compiled sorted by switch value, one [Begin, End) range
+     //  of _compiledSignals per page, so a frame touches only the page its switch selects.
+     //  Compact switch ranges also get a direct lookup table, indexed by value - first value.
+     struct MuxPage
+     {
+       int32_t Value;
+       uint32_t Begin;
+       uint32_t End;
+     };
+
+     std::vector<MuxPage> _muxPages;
+     std::vector<uint16_t> _muxPageTable; // page index + 1, 0 for no page
+
+     // In lazy mode SetFrame only stores the frame words; each signal decodes
+     //  itself from _frameState on its first GetResult after the frame arrives.
+     bool _lazyDecode;
+     NewEagle::DbcFrameState _frameState;
+
+     // Last payload decoded by SetFrame, and _frameState.Edits right after that decode.
+     uint8_t _lastPayload[NewEagle::MAX_PAYLOAD_SIZE];
+     bool _hasLastPayload;
+     uint32_t _lastPayloadEdits;
+     NewEagle::DbcFrameStats _frameStats;
+
+     // Words from the last encode.  EncodeFrame re-packs only the signals in
+     //  _frameState.DirtyMask on top of them, unless signals share bits and pack order matters.
+     uint64_t _encodedIntelWord;
+     uint64_t _encodedMotorolaWord;
+     bool _signalsOverlap;
+
+     // Payload and raw values of every signal at its initial value, built on the first
+     //  reset after a Compile or a change of initial value (_frameState.DefaultsStale).
+     std::vector<int64_t> _defaultRaws;
+     uint64_t _defaultIntelWord;
+     uint64_t _defaultMotorolaWord;
+     uint8_t _defaultData[NewEagle::MAX_PAYLOAD_SIZE];
+
+     void Compile();
+     void CompileDefaults();
+     void CompileMuxPages();
+     const MuxPage* FindMuxPage(double muxValue) const;
+     size_t PayloadSize() const;
+     void CheckClassic() const;
   };
 }
 #endif // _NEW_EAGLE_DBC_UTILITIES_H
@@ -0,0 +1,69 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _NEW_EAGLE_DBC_REGISTRY_H
+#define _NEW_EAGLE_DBC_REGISTRY_H
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+#include <dbc/Dbc.h>
+
+namespace NewEagle
+{
+  // Process-wide table of built DBCs, handed out read-only.  Nodelets in one manager
+  //  that load the same DBC text get the same Dbc, keyed by DbcCache::Hash of the text
+  //  and its size, so it is parsed and stored once.  An entry lives as long as someone
+  //  holds it; the next load after that builds it again, through DbcCache.
+  //
+  //  A shared Dbc is only read: decode with the const DbcMessage::Decode into, and
+  //  Encode from, a DecodedFrame of your own.
+  class DbcRegistry
+  {
+    public:
+      // cacheDirectory is passed to DbcCache when the DBC has to be built.
+      static std::shared_ptr<const NewEagle::Dbc> Load(const std::string &dbcFile, const std::string &cacheDirectory);
+      static std::shared_ptr<const NewEagle::Dbc> Load(const char* data, size_t size, const std::string &cacheDirectory);
+
+      // Throws std::runtime_error when the file cannot be read.
+      static std::shared_ptr<const NewEagle::Dbc> LoadFile(const std::string &path, const std::string &cacheDirectory);
+
+      // DBCs currently held by someone in this process.
+      static size_t GetCount();
+  };
+}
+
+#endif // _NEW_EAGLE_DBC_REGISTRY_H
@@ -37,6 +37,7 @@
 
 #include <ros/ros.h>
 
+#include <memory>
 #include <string>
 
 namespace NewEagle
@@ -74,13 +75,59 @@ namespace NewEagle
     MUX_SIGNAL = 2
   };
 
+  // Largest payload a message can declare, the CAN FD maximum.
+  const uint8_t MAX_PAYLOAD_SIZE = 64;
+
+  // Bit extraction plan, computed once when the signal is built.
+  //  Shift is the position of the signal's LSB within the 64-bit frame word,
+  //  read little-endian for Intel signals and big-endian for Motorola signals.
+  //  In a CAN FD message (Windowed) the word is the 8 bytes starting at byte Window
+  //  instead of the whole frame, and a Wide signal takes its top bits from the
+  //  byte just past the window.
+  //  The flags sit with Window and Shift so a plan packs into 40 bytes.
+  struct DbcSignalPlan
+  {
+    uint8_t Window;
+    uint8_t Shift;
+    bool BigEndian;
+    bool Scaled;
+    bool Windowed;
+    bool Wide;
+    bool Valid;
+    uint64_t Mask;
+    uint64_t SignBit;
+    double Gain;
+    double Offset;
+  };
+
+  // Per-message state shared with its signals.  In lazy decode mode the frame words
+  //  are kept here and Sequence changes on every SetFrame, so a signal can tell whether
+  //  its memoized value is current.  DirtyMask has bit i set when the signal with
+  //  index i changed since the last encode (all bits for indexes past 63).  Edits
+  //  counts signal changes, so SetFrame can tell whether the signals still hold
+  //  the decode of the last payload.  DefaultsStale is set when an initial value
+  //  changes, so the message rebuilds its default payload before the next reset.
+  struct DbcFrameState
+  {
+    uint64_t IntelWord;
+    uint64_t MotorolaWord;
+    uint8_t Payload[MAX_PAYLOAD_SIZE]; // CAN FD messages only
+    double MuxValue;
+    uint32_t Sequence;
+    uint32_t Edits;
+    uint64_t DirtyMask;
+    bool DefaultsStale;
+  };
+
+  class DbcMessage;
+
   class DbcSignal {
     public:
       DbcSignal(
         uint8_t dlc,
         double gain,
         double offset,
-        uint8_t startBit,
+        uint16_t startBit,
         ByteOrder endianness,
         uint8_t length,
         SignType sign,
@@ -91,7 +138,7 @@ namespace NewEagle
         uint8_t dlc,
         double gain,
         double offset,
-        uint8_t startBit,
+        uint16_t startBit,
         ByteOrder endianness,
         uint8_t length,
         SignType sign,
@@ -105,35 +152,81 @@ namespace NewEagle
       double GetResult() const;
       double GetGain() const;
       double GetOffset() const;
-      uint8_t GetStartBit() const;
+      uint16_t GetStartBit() const;
       ByteOrder GetEndianness() const;
       uint8_t GetLength() const;
       SignType GetSign() const;
       std::string GetName() const;
       void SetResult(double result);
+
+      // The value as an integer on the wire: sign-extended, without gain and offset.
+      //  After SetResult it is the raw value the result encodes to.
+      int64_t GetRaw() const;
+      void SetRaw(int64_t raw);
+
+      template<typename T>
+      T GetRawAs() const
+      {
+        return static_cast<T>(GetRaw());
+      }
+
       void SetComment(NewEagle::DbcSignalComment comment);
+      NewEagle::DbcSignalComment GetComment() const;
       void SetInitialValue(double value);
       double GetInitialValue();
       DataType GetDataType();
       void SetDataType(DataType type);
       MultiplexerMode GetMultiplexerMode() const;
       int32_t GetMultiplexerSwitch() const;      
+      const NewEagle::DbcSignalPlan& GetPlan() const;
+      void BindFrame(NewEagle::DbcFrameState* frame, bool multiplexed);
+      uint32_t GetIndex() const;
+      void SetIndex(uint32_t index);
 
     private:
+      // Link to the owning message's frame state, for lazy decode and dirty tracking.
+      //  A copy starts unbound, since the state belongs to the message it was copied from.
+      struct FrameBinding
+      {
+        NewEagle::DbcFrameState* Frame;
+        uint32_t Sequence;
+        bool Multiplexed;
+
+        FrameBinding() : Frame(NULL), Sequence(0), Multiplexed(false) {}
+        FrameBinding(const FrameBinding &) : Frame(NULL), Sequence(0), Multiplexed(false) {}
+        FrameBinding& operator=(const FrameBinding &) { Frame = NULL; Sequence = 0; Multiplexed = false; return *this; }
+      };
+
+      // Fields read on every frame first, descriptive ones after.
+      NewEagle::DbcSignalPlan _plan;
+      mutable double _result;
+      mutable int64_t _raw; // always the raw value of _result
+      mutable FrameBinding _binding;
+      uint32_t _index; // position in the owning message, set by DbcMessage
+      int32_t _multiplexerSwitch;
+      MultiplexerMode _multiplexerMode;
+      ByteOrder _endianness;
+      SignType _sign;
+      DataType _type;
+      uint16_t _startBit;
+      uint8_t _length;
       uint8_t _dlc;
-      double _result;
       double _gain;
       double _offset;
-      uint8_t _startBit;
-      ByteOrder _endianness;
-      uint8_t _length;
-      SignType _sign;
-      std::string _name;
-      NewEagle::DbcSignalComment _comment;
       double _initialValue;
-      DataType _type;
-      MultiplexerMode _multiplexerMode;
-      int32_t _multiplexerSwitch;
+      std::string _name;
+
+      // Most signals have no comment, so it is kept out of line and shared between copies.
+      std::shared_ptr<const NewEagle::DbcSignalComment> _comment;
+
+      void CompilePlan();
+      void Settle() const;
+      bool IsSettled() const;
+      void MarkDirty();
+
+      // Used by DbcMessage::ResetToDefaults, which rewrites the encoded payload itself.
+      friend class DbcMessage;
+      void RestoreRaw(int64_t raw);
   };
 }
 
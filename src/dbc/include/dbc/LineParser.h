@@ -71,6 +71,17 @@ namespace NewEagle
     }
   };
 
+  // A run of characters inside the text being parsed.  Does not own the text, so it
+  //  is only valid while the text is.
+  struct LineToken
+  {
+    const char* Data;
+    size_t Length;
+
+    bool Equals(const char* text) const;
+    std::string ToString() const;
+  };
+
   enum ReadDoubleState
   {
     READING_WHOLE_NUMBER = 0,
@@ -84,8 +95,12 @@ namespace NewEagle
   {
     public:
       LineParser(const std::string &line);
+      LineParser(const char* begin, const char* end);
+      LineParser(const LineParser &other);
       ~LineParser();
 
+      LineParser& operator=(const LineParser &other);
+
       int32_t GetPosition();
       std::string ReadCIdentifier();
       std::string ReadCIdentifier(std::string fieldName);
@@ -99,13 +114,26 @@ namespace NewEagle
       std::string ReadQuotedString();
       uint32_t PeekUInt();
 
+      // Non-throwing readers for the DbcBuilder hot loop.  Each returns false when
+      //  the field is missing or malformed; the position is then unspecified.
+      bool TryReadCIdentifier(NewEagle::LineToken &token);
+      bool TryReadUInt(uint32_t &value);
+      bool TryReadInt(int32_t &value);
+      bool TryReadDouble(double &value);
+      bool TryReadQuotedString(NewEagle::LineToken &token);
+      bool TryReadNextChar(char &value);
+      bool TrySeekSeparator(char separator);
+
     private:
+      std::string _line; // only set by the std::string constructor, _begin points into it
+      const char* _begin;
+      const char* _end;
       int32_t _position;
-      std::string _line;
 
       void SkipWhitespace();
       bool AtEOL();
       char ReadNextChar();
+      size_t ScanDouble();
   };
 }
 
@@ -34,31 +34,132 @@
 
 #include <dbc/Dbc.h>
 
+#include <sstream>
+#include <stdexcept>
+
 namespace NewEagle
 {
   ////
+  static const uint32_t STANDARD_ID_COUNT = 0x800;
+
   Dbc::Dbc()
   {
   }
 
+  Dbc::Dbc(const Dbc &other)
+  {
+    *this = other;
+  }
+
+  Dbc::Dbc(Dbc &&other)
+  {
+    *this = std::move(other);
+  }
+
   Dbc::~Dbc()
   {
   }
 
+  Dbc& Dbc::operator=(const Dbc &other)
+  {
+    _messages = other._messages;
+    BuildIndex();
+
+    return *this;
+  }
+
+  Dbc& Dbc::operator=(Dbc &&other)
+  {
+    // Swapping keeps every message in its map node, so the messages and any pointers
+    //  to them stay valid; only the index has to follow.
+    _messages.swap(other._messages);
+    BuildIndex();
+    other.BuildIndex();
+
+    return *this;
+  }
+
+  void Dbc::IndexMessage(NewEagle::DbcMessage* message)
+  {
+    uint32_t id = message->GetId();
+
+    if (NewEagle::STD == message->GetIdType() && id < STANDARD_ID_COUNT)
+    {
+      if (_standardIndex.empty())
+      {
+        _standardIndex.resize(STANDARD_ID_COUNT, NULL);
+      }
+
+      if (NULL == _standardIndex[id])
+      {
+        _standardIndex[id] = message;
+      }
+    }
+    else
+    {
+      _extendedIndex.insert(std::make_pair(id, message));
+    }
+  }
+
+  void Dbc::BuildIndex()
+  {
+    _standardIndex.clear();
+    _extendedIndex.clear();
+
+    for(std::map<std::string, NewEagle::DbcMessage>::iterator it = _messages.begin(); it != _messages.end(); it++)
+    {
+      IndexMessage(&it->second);
+    }
+  }
+
   std::map<std::string, NewEagle::DbcMessage>* Dbc::GetMessages()
   {
     return &_messages;
 
   }
 
-  void Dbc::AddMessage(std::string messageName, NewEagle::DbcMessage message)
+  void Dbc::AddMessage(const std::string &messageName, const NewEagle::DbcMessage &message)
+  {
+    std::pair<std::map<std::string, NewEagle::DbcMessage>::iterator, bool> result =
+      _messages.insert(std::pair<std::string, NewEagle::DbcMessage>(message.GetName(), message));
+
+    if (result.second)
+    {
+      IndexMessage(&result.first->second);
+    }
+  }
+
+  void Dbc::AddMessage(const std::string &messageName, NewEagle::DbcMessage &&message)
+  {
+    if (NULL != GetMessage(message.GetName()))
+    {
+      return;
+    }
+
+    std::map<std::string, NewEagle::DbcMessage>::iterator it =
+      _messages.insert(std::pair<std::string, NewEagle::DbcMessage>(message.GetName(), std::move(message))).first;
+
+    IndexMessage(&it->second);
+  }
+
+  NewEagle::DbcMessage* Dbc::GetMessage(const std::string &messageName)
+  {
+    return const_cast<NewEagle::DbcMessage*>(static_cast<const Dbc*>(this)->GetMessage(messageName));
+  }
+
+  NewEagle::DbcMessage* Dbc::GetMessageById(uint32_t id)
+  {
+    return const_cast<NewEagle::DbcMessage*>(static_cast<const Dbc*>(this)->GetMessageById(id));
+  }
+
+  NewEagle::DbcMessage* Dbc::GetMessageById(uint32_t id, NewEagle::IdType idType)
   {
-    _messages.insert(std::pair<std::string, NewEagle::DbcMessage>(message.GetName(), message));
+    return const_cast<NewEagle::DbcMessage*>(static_cast<const Dbc*>(this)->GetMessageById(id, idType));
   }
 
-  NewEagle::DbcMessage* Dbc::GetMessage(std::string messageName)
+  const NewEagle::DbcMessage* Dbc::GetMessage(const std::string &messageName) const
   {
-    std::map<std::string, NewEagle::DbcMessage>::iterator it;
+    std::map<std::string, NewEagle::DbcMessage>::const_iterator it;
 
     it = _messages.find(messageName);
 
@@ -67,25 +168,77 @@ namespace NewEagle
       return NULL;
     }
 
-    NewEagle::DbcMessage* message = &it->second;
+    return &it->second;
+  }
 
-    return message;
+  const NewEagle::DbcMessage* Dbc::GetMessageById(uint32_t id) const
+  {
+    if (id < _standardIndex.size() && NULL != _standardIndex[id])
+    {
+      return _standardIndex[id];
+    }
+
+    std::unordered_map<uint32_t, NewEagle::DbcMessage*>::const_iterator it = _extendedIndex.find(id);
+
+    if (_extendedIndex.end() == it)
+    {
+      return NULL;
+    }
+
+    return it->second;
   }
 
-  NewEagle::DbcMessage* Dbc::GetMessageById(uint32_t id)
+  const NewEagle::DbcMessage* Dbc::GetMessageById(uint32_t id, NewEagle::IdType idType) const
   {
-    for(std::map<std::string, NewEagle::DbcMessage>::iterator it = _messages.begin(); it != _messages.end(); it++)
+    if (NewEagle::STD == idType && id < STANDARD_ID_COUNT)
     {
-      if (it->second.GetId() == id)
-      {
-        NewEagle::DbcMessage* message = &it->second;
+      return id < _standardIndex.size() ? _standardIndex[id] : NULL;
+    }
 
-        return message;
-      }
+    std::unordered_map<uint32_t, NewEagle::DbcMessage*>::const_iterator it = _extendedIndex.find(id);
 
+    if (_extendedIndex.end() == it)
+    {
+      return NULL;
+    }
+
+    return it->second;
+  }
+
+  NewEagle::DbcMessage* Dbc::ResolveMessage(const std::string &messageName)
+  {
+    return const_cast<NewEagle::DbcMessage*>(static_cast<const Dbc*>(this)->ResolveMessage(messageName));
+  }
+
+  NewEagle::DbcMessage* Dbc::ResolveMessageById(uint32_t id)
+  {
+    return const_cast<NewEagle::DbcMessage*>(static_cast<const Dbc*>(this)->ResolveMessageById(id));
+  }
+
+  const NewEagle::DbcMessage* Dbc::ResolveMessage(const std::string &messageName) const
+  {
+    const NewEagle::DbcMessage* message = GetMessage(messageName);
+
+    if (NULL == message)
+    {
+      throw std::runtime_error("DBC message not found: " + messageName);
+    }
+
+    return message;
+  }
+
+  const NewEagle::DbcMessage* Dbc::ResolveMessageById(uint32_t id) const
+  {
+    const NewEagle::DbcMessage* message = GetMessageById(id);
+
+    if (NULL == message)
+    {
+      std::ostringstream sstream;
+      sstream << "DBC message not found: id 0x" << std::hex << id;
+      throw std::runtime_error(sstream.str());
     }
 
-    return NULL;
+    return message;
   }
 
   uint16_t Dbc::GetMessageCount()
@@ -0,0 +1,268 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <dbc/DbcBatch.h>
+
+#include <stdexcept>
+
+#include "DbcUtilities.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DBC_BATCH_X86
+#include <immintrin.h>
+#endif
+
+namespace NewEagle
+{
+  namespace
+  {
+    // The vector kernels convert through the 2^52 + 2^51 double trick, which is exact
+    //  for integers of up to 51 bits.  Wider signals go through the scalar loop.
+    const uint8_t MAX_VECTOR_LENGTH = 51;
+    const uint64_t MAGIC_BITS = 0x4338000000000000ULL;
+    const double MAGIC_DOUBLE = 6755399441055744.0;
+
+    void DecodeScalar(const uint8_t (*frames)[8], size_t begin, size_t n, const NewEagle::DbcSignalPlan &plan, double* out)
+    {
+      for (size_t i = begin; i < n; i++)
+      {
+        uint64_t word = LoadFrameWord(frames[i], plan.BigEndian);
+        out[i] = Unpack(word, word, plan);
+      }
+    }
+
+#ifdef DBC_BATCH_X86
+    __attribute__((target("avx2")))
+    void DecodeAvx2(const uint8_t (*frames)[8], size_t n, const NewEagle::DbcSignalPlan &plan, double* out)
+    {
+      const __m256i reverse = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+      const __m128i shift = _mm_cvtsi32_si128(plan.Shift);
+      const __m256i mask = _mm256_set1_epi64x((long long)plan.Mask);
+      const __m256i signBit = _mm256_set1_epi64x((long long)plan.SignBit);
+      const __m256i magicBits = _mm256_set1_epi64x((long long)MAGIC_BITS);
+      const __m256d magic = _mm256_set1_pd(MAGIC_DOUBLE);
+      const __m256d gain = _mm256_set1_pd(plan.Gain);
+      const __m256d offset = _mm256_set1_pd(plan.Offset);
+
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4)
+      {
+        __m256i word = _mm256_loadu_si256((const __m256i*)frames[i]);
+        if (plan.BigEndian)
+        {
+          word = _mm256_shuffle_epi8(word, reverse);
+        }
+
+        __m256i raw = _mm256_and_si256(_mm256_srl_epi64(word, shift), mask);
+        if (plan.SignBit)
+        {
+          raw = _mm256_sub_epi64(_mm256_xor_si256(raw, signBit), signBit);
+        }
+
+        __m256d value = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(raw, magicBits)), magic);
+        if (plan.Scaled)
+        {
+          // Multiply then add, not fused, to round exactly like the scalar path.
+          value = _mm256_add_pd(_mm256_mul_pd(value, gain), offset);
+        }
+
+        _mm256_storeu_pd(out + i, value);
+      }
+
+      DecodeScalar(frames, i, n, plan, out);
+    }
+
+    __attribute__((target("sse4.1")))
+    void DecodeSse4(const uint8_t (*frames)[8], size_t n, const NewEagle::DbcSignalPlan &plan, double* out)
+    {
+      const __m128i reverse = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+      const __m128i shift = _mm_cvtsi32_si128(plan.Shift);
+      const __m128i mask = _mm_set1_epi64x((long long)plan.Mask);
+      const __m128i signBit = _mm_set1_epi64x((long long)plan.SignBit);
+      const __m128i magicBits = _mm_set1_epi64x((long long)MAGIC_BITS);
+      const __m128d magic = _mm_set1_pd(MAGIC_DOUBLE);
+      const __m128d gain = _mm_set1_pd(plan.Gain);
+      const __m128d offset = _mm_set1_pd(plan.Offset);
+
+      size_t i = 0;
+      for (; i + 2 <= n; i += 2)
+      {
+        __m128i word = _mm_loadu_si128((const __m128i*)frames[i]);
+        if (plan.BigEndian)
+        {
+          word = _mm_shuffle_epi8(word, reverse);
+        }
+
+        __m128i raw = _mm_and_si128(_mm_srl_epi64(word, shift), mask);
+        if (plan.SignBit)
+        {
+          raw = _mm_sub_epi64(_mm_xor_si128(raw, signBit), signBit);
+        }
+
+        __m128d value = _mm_sub_pd(_mm_castsi128_pd(_mm_add_epi64(raw, magicBits)), magic);
+        if (plan.Scaled)
+        {
+          value = _mm_add_pd(_mm_mul_pd(value, gain), offset);
+        }
+
+        _mm_storeu_pd(out + i, value);
+      }
+
+      DecodeScalar(frames, i, n, plan, out);
+    }
+#endif
+
+    void DecodeColumn(const uint8_t (*frames)[8], size_t n, const NewEagle::DbcSignalPlan &plan, double* out, BatchKernel kernel)
+    {
+#ifdef DBC_BATCH_X86
+      // Vector kernels assume a little-endian host and a signal narrow enough for the exact conversion.
+      bool vectorizable = plan.Valid && ((plan.Mask >> MAX_VECTOR_LENGTH) == 0);
+
+      if (vectorizable && BATCH_AVX2 == kernel)
+      {
+        DecodeAvx2(frames, n, plan, out);
+        return;
+      }
+
+      if (vectorizable && BATCH_SSE4 == kernel)
+      {
+        DecodeSse4(frames, n, plan, out);
+        return;
+      }
+#endif
+
+      DecodeScalar(frames, 0, n, plan, out);
+    }
+  }
+
+  const std::vector<double>* SignalColumns::GetColumn(const std::string &signalName) const
+  {
+    for (size_t i = 0; i < Names.size(); i++)
+    {
+      if (Names[i] == signalName)
+      {
+        return &Values[i];
+      }
+    }
+
+    return NULL;
+  }
+
+  BatchKernel GetBatchKernel()
+  {
+#ifdef DBC_BATCH_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return BATCH_AVX2;
+    }
+
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+      return BATCH_SSE4;
+    }
+#endif
+
+    return BATCH_SCALAR;
+  }
+
+  void DecodeBatch(const NewEagle::DbcMessage &message, const uint8_t (*frames)[8], size_t n, NewEagle::SignalColumns &columns)
+  {
+    static const BatchKernel kernel = GetBatchKernel();
+
+    DecodeBatch(message, frames, n, columns, kernel);
+  }
+
+  void DecodeBatch(const NewEagle::DbcMessage &message, const uint8_t (*frames)[8], size_t n, NewEagle::SignalColumns &columns, BatchKernel kernel)
+  {
+    const std::map<std::string, NewEagle::DbcSignal>* signals = message.GetSignals();
+
+    columns.Names.clear();
+    columns.Values.resize(signals->size());
+    columns.FrameCount = n;
+
+    const NewEagle::DbcSignal* muxSwitch = NULL;
+    const std::vector<double>* muxColumn = NULL;
+
+    size_t column = 0;
+    for (std::map<std::string, NewEagle::DbcSignal>::const_iterator it = signals->begin(); it != signals->end(); it++, column++)
+    {
+      if (it->second.GetPlan().Windowed)
+      {
+        throw std::runtime_error("DecodeBatch does not take CAN FD messages, signal: " + it->first);
+      }
+
+      columns.Names.push_back(it->first);
+      columns.Values[column].resize(n);
+
+      if (n > 0)
+      {
+        DecodeColumn(frames, n, it->second.GetPlan(), &columns.Values[column][0], kernel);
+      }
+
+      if (NewEagle::MUX_SWITCH == it->second.GetMultiplexerMode())
+      {
+        muxSwitch = &it->second;
+        muxColumn = &columns.Values[column];
+      }
+    }
+
+    if (NULL == muxSwitch)
+    {
+      return;
+    }
+
+    // Blank the rows where the switch selects another page.
+    column = 0;
+    for (std::map<std::string, NewEagle::DbcSignal>::const_iterator it = signals->begin(); it != signals->end(); it++, column++)
+    {
+      if (NewEagle::MUX_SIGNAL != it->second.GetMultiplexerMode())
+      {
+        continue;
+      }
+
+      std::vector<double> &values = columns.Values[column];
+      double page = it->second.GetMultiplexerSwitch();
+
+      for (size_t i = 0; i < n; i++)
+      {
+        if ((*muxColumn)[i] != page)
+        {
+          values[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+      }
+    }
+  }
+}
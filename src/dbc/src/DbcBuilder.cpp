@@ -36,8 +36,85 @@
 #include <dbc/DbcMessage.h>
 #include <dbc/DbcSignal.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+
+#include "MappedFile.h"
+
 namespace NewEagle
 {
+  namespace
+  {
+    const std::string VECTOR_INDEPENDENT_SIG_MSG = "VECTOR__INDEPENDENT_SIG_MSG";
+
+    const char* FindLineEnd(const char* begin, const char* end)
+    {
+      const char* newline = (const char*)memchr(begin, '\n', end - begin);
+
+      return (NULL == newline) ? end : newline;
+    }
+
+    // A comment string may run over several lines, so the statement ends at the
+    //  first newline outside quotes.  An unterminated quote ends at the line instead.
+    const char* FindCommentEnd(const char* begin, const char* end)
+    {
+      bool quoted = false;
+
+      for (const char* p = begin; p < end; p++)
+      {
+        if (quoted && '\\' == *p && p + 1 < end)
+        {
+          p++;
+        }
+        else if ('"' == *p)
+        {
+          quoted = !quoted;
+        }
+        else if ('\n' == *p && !quoted)
+        {
+          return p;
+        }
+      }
+
+      return quoted ? FindLineEnd(begin, end) : end;
+    }
+
+    NewEagle::DbcSignal* FindSignal(
+      const std::unordered_map<uint32_t, NewEagle::DbcMessage*> &messages,
+      uint32_t rawId,
+      const std::string &signalName)
+    {
+      std::unordered_map<uint32_t, NewEagle::DbcMessage*>::const_iterator it = messages.find(rawId);
+
+      if (messages.end() == it)
+      {
+        return NULL;
+      }
+
+      return it->second->GetSignal(signalName);
+    }
+  }
+
+  std::string DbcMergeReport::ToString() const
+  {
+    std::ostringstream report;
+
+    for (std::vector<NewEagle::DbcCollision>::const_iterator it = Collisions.begin(); it != Collisions.end(); it++)
+    {
+      report << (NewEagle::ID_COLLISION == it->Type ? "ID" : "Name") << " collision: "
+             << it->DroppedMessage << " (0x" << std::hex << it->Id << std::dec << ") in " << it->DroppedFile
+             << " dropped, " << it->KeptMessage << " in " << it->KeptFile << " kept\n";
+    }
+
+    return report.str();
+  }
+
   DbcBuilder::DbcBuilder()
   {
     MessageToken = std::string("BO_");
@@ -54,219 +131,298 @@ namespace NewEagle
 
   NewEagle::Dbc DbcBuilder::NewDbc(const std::string &dbcFile)
   {
+    return NewDbc(dbcFile.data(), dbcFile.size());
+  }
+
+  NewEagle::Dbc DbcBuilder::NewDbcFromFile(const std::string &path)
+  {
+    NewEagle::MappedFile file(path, true);
+
+    if (!file.IsOpen())
+    {
+      throw std::runtime_error("Could not open DBC file: " + path);
+    }
 
+    return NewDbc(file.GetData(), file.GetSize());
+  }
+
+  NewEagle::Dbc DbcBuilder::NewDbc(const char* data, size_t size)
+  {
     NewEagle::Dbc dbc;
 
-    std::istringstream f(dbcFile);
-    std::string line;
-    uint32_t lineNumber = 0;
+    // Messages by the raw ID the CM_, BA_ and SIG_VALTYPE_ statements refer to them by,
+    //  built as the BO_ statements are read.
+    std::unordered_map<uint32_t, NewEagle::DbcMessage*> messagesByRawId;
 
-    NewEagle::DbcMessage currentMessage;
+    // Signals are collected until the message's last SG_ line and then added in one
+    //  batch, so each message is compiled once.
+    NewEagle::DbcMessage* currentMessage = NULL;
+    uint8_t currentDlc = 0;
+    std::vector<NewEagle::DbcSignal> signals;
 
-    int32_t cnt = 0;
+    const char* end = data + size;
+    uint32_t lineNumber = 0;
 
-    while (std::getline(f, line, '\n'))
+    for (const char* line = data; line < end; )
     {
       lineNumber++;
 
-      NewEagle::LineParser parser(line);
+      const char* lineEnd = FindLineEnd(line, end);
 
+      NewEagle::LineParser parser(line, lineEnd);
+      NewEagle::LineToken identifier;
 
-      std::string identifier;
-      try
+      if (!parser.TryReadCIdentifier(identifier))
       {
-        identifier = parser.ReadCIdentifier();
+        line = lineEnd + 1;
+        continue;
       }
-      catch(std::exception& ex)
+
+      // The bare keywords listed under NS_ carry nothing.
+      NewEagle::LineParser rest(parser);
+      char next;
+
+      if (!rest.TryReadNextChar(next))
       {
-        identifier = std::string();
+        line = lineEnd + 1;
+        continue;
       }
 
-      if (!MessageToken.compare(identifier))
+      if (identifier.Equals(CommentToken.c_str()))
       {
-        try
-        {
-          currentMessage =  ReadMessage(parser);
-          currentMessage.SetRawText(line);
-          dbc.AddMessage(currentMessage.GetName(), currentMessage);
-        }
-        catch(LineParserExceptionBase& exlp)
+        lineEnd = FindCommentEnd(line, end);
+        lineNumber += std::count(line, lineEnd, '\n');
+        parser = NewEagle::LineParser(line, lineEnd);
+        parser.TryReadCIdentifier(identifier);
+      }
+
+      if (!identifier.Equals(SignalToken.c_str()) && NULL != currentMessage)
+      {
+        currentMessage->AddSignals(signals);
+        signals.clear();
+        currentMessage = NULL;
+      }
+
+      if (identifier.Equals(MessageToken.c_str()))
+      {
+        NewEagle::DbcMessage message;
+
+        if (ReadMessage(parser, message))
         {
-          ROS_WARN("LineParser Exception: [%s]", exlp.what());
+          dbc.AddMessage(message.GetName(), message);
+
+          // A repeated name keeps the first definition, and its signals go to that message.
+          currentMessage = dbc.GetMessage(message.GetName());
+          currentDlc = message.GetDlc();
+          messagesByRawId.insert(std::make_pair(message.GetRawId(), currentMessage));
         }
-        catch(std::exception& ex)
+        else
         {
-          ROS_ERROR("DBC Message Parser Exception: [%s]", ex.what());
+          ROS_WARN("DBC line %u: malformed message, skipped", lineNumber);
         }
       }
-      else if (!SignalToken.compare(identifier))
+      else if (identifier.Equals(SignalToken.c_str()))
       {
-        try
-        {
-          NewEagle::DbcSignal signal = ReadSignal(parser);
-
-          NewEagle::DbcMessage* msg = dbc.GetMessage(currentMessage.GetName());
-          msg->AddSignal(signal.GetName(), signal);
-        }
-        catch(LineParserExceptionBase& exlp)
+        if (NULL == currentMessage)
         {
-          ROS_WARN("LineParser Exception: [%s]", exlp.what());
+          ROS_WARN("DBC line %u: signal outside of a message, skipped", lineNumber);
         }
-        catch(std::exception& ex)
+        else if (!ReadSignal(parser, currentDlc, signals))
         {
-          ROS_ERROR("DBC Signal Parser Exception: [%s]", ex.what());
+          ROS_WARN("DBC line %u: malformed signal, skipped", lineNumber);
         }
       }
-      else if (!CommentToken.compare(identifier))
+      else if (identifier.Equals(CommentToken.c_str()))
       {
-        try
+        NewEagle::LineToken token;
+        bool valid = true;
+
+        // Comments on nodes, environment variables and the network are not kept.
+        if (!parser.TryReadCIdentifier(token))
         {
-          std::string token = parser.ReadCIdentifier();
+          token.Data = NULL;
+          token.Length = 0;
+        }
 
-          if (!MessageToken.compare(token))
-          {
-            NewEagle::DbcMessageComment dbcMessageComment = ReadMessageComment(parser);
-
-            std::map<std::string, NewEagle::DbcMessage>::iterator it;
-            int32_t ttt = 0;
-
-            for (it = dbc.GetMessages()->begin(); it != dbc.GetMessages()->end(); ++it)
-            {
-              ttt++;
-              if (it->second.GetRawId() == dbcMessageComment.Id)
-              {
-                it->second.SetComment(dbcMessageComment);
-                break;
-              }
-            }
-          }
-          else if (!SignalToken.compare(token))
+        if (token.Equals(MessageToken.c_str()))
+        {
+          NewEagle::DbcMessageComment dbcMessageComment;
+          valid = ReadMessageComment(parser, dbcMessageComment);
+
+          std::unordered_map<uint32_t, NewEagle::DbcMessage*>::iterator it = messagesByRawId.find(dbcMessageComment.Id);
+          if (valid && messagesByRawId.end() != it)
           {
-            NewEagle::DbcSignalComment dbcSignalComment = ReadSignalComment(parser);
-
-            std::map<std::string, NewEagle::DbcMessage>::iterator it;
-            for (it = dbc.GetMessages()->begin(); it != dbc.GetMessages()->end(); ++it)
-            {
-              if (it->second.GetRawId() == dbcSignalComment.Id)
-              {
-                DbcMessage msg = it->second;
-                std::map<std::string, NewEagle::DbcSignal>::iterator its;
-
-                for (its = msg.GetSignals()->begin(); its != msg.GetSignals()->end(); ++its)
-                {
-                  if (its->second.GetName() == dbcSignalComment.SignalName)
-                  {
-                    its->second.SetComment(dbcSignalComment);
-                    break;
-                  }
-                }
-              }
-            }
+            it->second->SetComment(dbcMessageComment);
           }
         }
-        catch(LineParserExceptionBase& exlp)
+        else if (token.Equals(SignalToken.c_str()))
         {
-          ROS_WARN("LineParser Exception: [%s]", exlp.what());
+          NewEagle::DbcSignalComment dbcSignalComment;
+          valid = ReadSignalComment(parser, dbcSignalComment);
+
+          NewEagle::DbcSignal* signal = valid ? FindSignal(messagesByRawId, dbcSignalComment.Id, dbcSignalComment.SignalName) : NULL;
+          if (NULL != signal)
+          {
+            signal->SetComment(dbcSignalComment);
+          }
         }
-        catch(std::exception& ex)
+
+        if (!valid)
         {
-          ROS_ERROR("DBC Comment Parser Exception: [%s]", ex.what());
+          ROS_WARN("DBC line %u: malformed comment, skipped", lineNumber);
         }
       }
-      else if (!AttributeToken.compare(identifier))
+      else if (identifier.Equals(AttributeToken.c_str()))
       {
-        try
-        {
-          NewEagle::DbcAttribute dbcAttribute = ReadAttribute(parser);
+        NewEagle::DbcAttribute dbcAttribute;
 
-          if (dbc.GetMessageCount() > 0)
-          {
-            std::map<std::string, NewEagle::DbcMessage>::iterator it;
-            for (it = dbc.GetMessages()->begin(); it != dbc.GetMessages()->end(); ++it)
-            {
-              if (it->second.GetRawId() == dbcAttribute.Id)
-              {
-                std::map<std::string, NewEagle::DbcSignal>::iterator its;
-                DbcMessage msg = it->second;
-                for (its = msg.GetSignals()->begin(); its != msg.GetSignals()->end(); ++its)
-                {
-                  if (its->second.GetName() == dbcAttribute.SignalName)
-                  {
-                    NewEagle::DbcSignal sig = its->second;
-
-                    double gain = sig.GetGain();
-                    double offset = sig.GetOffset();
-
-                    double f = 0.0;
-
-                    std::stringstream ss;
-                    ss << dbcAttribute.Value;
-                    ss >> f;
-
-                    double val = gain * f + offset;
-                    sig.SetInitialValue(val);
-                    break;
-                  }
-                }
-              }
-            }
-          }
-        }
-        catch(LineParserExceptionBase& exlp)
+        if (!ReadAttribute(parser, dbcAttribute))
         {
-          ROS_WARN("LineParser Exception: [%s]", exlp.what());
+          ROS_WARN("DBC line %u: malformed attribute, skipped", lineNumber);
         }
-        catch(std::exception& ex)
+        else if (dbcAttribute.ObjectType == SignalToken)
         {
-          ROS_ERROR("DBC Signal Value Type Parser Exception: [%s]", ex.what());
+          NewEagle::DbcSignal* signal = FindSignal(messagesByRawId, dbcAttribute.Id, dbcAttribute.SignalName);
+          if (NULL != signal)
+          {
+            signal->SetInitialValue(signal->GetGain() * dbcAttribute.Value + signal->GetOffset());
+          }
         }
       }
-      else if (!EnumValueToken.compare(identifier))
+      else if (identifier.Equals(EnumValueToken.c_str()))
       {
         // Empty for now.
       }
-      else if (!SignalValueTypeToken.compare(identifier))
+      else if (identifier.Equals(SignalValueTypeToken.c_str()))
       {
-        try
+        NewEagle::DbcSignalValueType dbcSignalValueType;
+
+        if (!ReadSignalValueType(parser, dbcSignalValueType))
         {
-          NewEagle::DbcSignalValueType dbcSignalValueType = ReadSignalValueType(parser);
+          ROS_WARN("DBC line %u: malformed signal value type, skipped", lineNumber);
+        }
+        else
+        {
+          NewEagle::DbcSignal* signal = FindSignal(messagesByRawId, dbcSignalValueType.Id, dbcSignalValueType.SignalName);
+          if (NULL != signal)
+          {
+            signal->SetDataType(dbcSignalValueType.Type);
+          }
+        }
+      }
+
+      line = lineEnd + 1;
+    }
+
+    if (NULL != currentMessage)
+    {
+      currentMessage->AddSignals(signals);
+    }
+
+    ROS_INFO("dbc.size() = %d", dbc.GetMessageCount());
+
+    return dbc;
+  }
 
-          if (dbc.GetMessageCount() > 0)
+  NewEagle::Dbc DbcBuilder::NewDbcFromFiles(const std::vector<std::string> &paths, NewEagle::DbcMergeReport &report)
+  {
+    return NewDbcFromFiles(paths, report, 0);
+  }
+
+  NewEagle::Dbc DbcBuilder::NewDbcFromFiles(const std::vector<std::string> &paths, NewEagle::DbcMergeReport &report, size_t threads)
+  {
+    std::vector<NewEagle::Dbc> parsed(paths.size());
+    std::vector<std::exception_ptr> errors(paths.size());
+
+    if (0 == threads)
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, paths.size());
+
+    // Each worker takes the next unparsed file until none are left, so one large
+    //  file does not hold up the small ones queued behind it.
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < threads; t++)
+    {
+      workers.push_back(std::thread([&paths, &parsed, &errors, &next]()
+      {
+        for (size_t i = next++; i < paths.size(); i = next++)
+        {
+          try
           {
-            std::map<std::string, NewEagle::DbcMessage>::iterator it;
-            for (it = dbc.GetMessages()->begin(); it != dbc.GetMessages()->end(); ++it)
-            {
-              if (it->second.GetRawId() == dbcSignalValueType.Id)
-              {
-                std::map<std::string, NewEagle::DbcSignal>::iterator its;
-                DbcMessage msg = it->second;
-                for (its = msg.GetSignals()->begin(); its != msg.GetSignals()->end(); ++its)
-                {
-                  if (its->second.GetName() == dbcSignalValueType.SignalName)
-                  {
-                    NewEagle::DbcSignal sig = its->second;
-                    sig.SetDataType(dbcSignalValueType.Type);
-                    break;
-                  }
-                }
-              }
-            }
+            parsed[i] = NewEagle::DbcBuilder().NewDbcFromFile(paths[i]);
           }
+          catch (...)
+          {
+            errors[i] = std::current_exception();
+          }
+        }
+      }));
+    }
+
+    for (size_t t = 0; t < workers.size(); t++)
+    {
+      workers[t].join();
+    }
+
+    for (size_t i = 0; i < errors.size(); i++)
+    {
+      if (errors[i])
+      {
+        std::rethrow_exception(errors[i]);
+      }
+    }
+
+    // Merged in file order, so the result does not depend on which parse finished first.
+    NewEagle::Dbc dbc;
+    std::map<const NewEagle::DbcMessage*, size_t> sources;
+    report.Collisions.clear();
+
+    for (size_t i = 0; i < parsed.size(); i++)
+    {
+      std::map<std::string, NewEagle::DbcMessage>* messages = parsed[i].GetMessages();
+
+      for (std::map<std::string, NewEagle::DbcMessage>::iterator it = messages->begin(); it != messages->end(); it++)
+      {
+        NewEagle::DbcMessage &message = it->second;
+        NewEagle::DbcMessage* kept = dbc.GetMessageById(message.GetId(), message.GetIdType());
+        NewEagle::DbcCollisionType type = NewEagle::ID_COLLISION;
+
+        if (NULL == kept)
+        {
+          kept = dbc.GetMessage(it->first);
+          type = NewEagle::NAME_COLLISION;
         }
-        catch(LineParserExceptionBase& exlp)
+
+        // Vector tools put every DBC's unassigned signals in a placeholder message with
+        //  the same name and ID, so its repeats are not a conflict: keep the first.
+        if (NULL != kept && VECTOR_INDEPENDENT_SIG_MSG == it->first)
         {
-          ROS_WARN("LineParser Exception: [%s]", exlp.what());
+          continue;
         }
-        catch(std::exception& ex)
+
+        if (NULL != kept)
         {
-          ROS_ERROR("DBC Signal Value Type Parser Exception: [%s]", ex.what());
+          NewEagle::DbcCollision collision;
+          collision.Type = type;
+          collision.Id = message.GetId();
+          collision.IdType = message.GetIdType();
+          collision.KeptFile = paths[sources[kept]];
+          collision.KeptMessage = kept->GetName();
+          collision.DroppedFile = paths[i];
+          collision.DroppedMessage = it->first;
+          report.Collisions.push_back(collision);
+          continue;
         }
 
+        dbc.AddMessage(it->first, std::move(message));
+        sources[dbc.GetMessage(it->first)] = i;
       }
     }
 
-    ROS_INFO("dbc.size() = %d", dbc.GetMessageCount());
-
     return dbc;
   }
 }
@@ -0,0 +1,479 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <dbc/DbcCache.h>
+#include <dbc/DbcBuilder.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "MappedFile.h"
+#include "Sha256.h"
+
+namespace NewEagle
+{
+  namespace
+  {
+    // Image layout: header, message records, signal records, then the names and
+    //  comments as one block of characters.  Records are fixed size and 8-byte
+    //  aligned so they can be read where they sit in the mapping.
+    const char CACHE_MAGIC[8] = { 'N', 'E', 'D', 'B', 'C', 'C', 0, 0 };
+    const uint32_t CACHE_VERSION = 2;
+    const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+
+    struct CacheHeader
+    {
+      char Magic[8];
+      uint32_t Version;
+      uint32_t ByteOrder;
+      uint8_t SourceHash[32];
+      uint64_t SourceSize;
+      uint32_t MessageCount;
+      uint32_t SignalCount;
+      uint64_t StringsSize;
+    };
+
+    struct CachedString
+    {
+      uint32_t Offset;
+      uint32_t Length;
+    };
+
+    struct CachedMessage
+    {
+      uint32_t RawId;
+      uint32_t Id;
+      uint32_t FirstSignal;
+      uint32_t SignalCount;
+      CachedString Name;
+      CachedString Comment;
+      uint8_t Dlc;
+      uint8_t IdType;
+      uint8_t Reserved[6];
+    };
+
+    struct CachedSignal
+    {
+      double Gain;
+      double Offset;
+      double InitialValue;
+      int32_t MultiplexerSwitch;
+      CachedString Name;
+      CachedString Comment;
+      uint16_t StartBit;
+      uint8_t Dlc;
+      uint8_t Length;
+      uint8_t Endianness;
+      uint8_t Sign;
+      uint8_t MultiplexerMode;
+      uint8_t DataType;
+      uint8_t Reserved[4];
+    };
+
+    static_assert(sizeof(CacheHeader) == 72, "DBC cache header layout changed");
+    static_assert(sizeof(CachedMessage) == 40, "DBC cache message layout changed");
+    static_assert(sizeof(CachedSignal) == 56, "DBC cache signal layout changed");
+
+    CachedString AppendString(std::vector<char> &strings, const std::string &value)
+    {
+      CachedString str;
+      str.Offset = (uint32_t)strings.size();
+      str.Length = (uint32_t)value.size();
+      strings.insert(strings.end(), value.begin(), value.end());
+
+      return str;
+    }
+
+    bool ValidString(const CachedString &str, uint64_t stringsSize)
+    {
+      return (uint64_t)str.Offset + str.Length <= stringsSize;
+    }
+
+    std::string ToString(const char* strings, const CachedString &str)
+    {
+      return std::string(strings + str.Offset, str.Length);
+    }
+
+    bool MakeDirectories(const std::string &directory)
+    {
+      for (size_t slash = directory.find('/', 1); ; slash = directory.find('/', slash + 1))
+      {
+        std::string parent = directory.substr(0, slash);
+        if (0 != mkdir(parent.c_str(), 0755) && EEXIST != errno)
+        {
+          return false;
+        }
+
+        if (std::string::npos == slash)
+        {
+          return true;
+        }
+      }
+    }
+  }
+
+  DbcCache::DbcCache(const std::string &directory)
+  {
+    _directory = directory;
+  }
+
+  DbcCache::~DbcCache()
+  {
+  }
+
+  std::string DbcCache::DefaultDirectory()
+  {
+    const char* rosHome = getenv("ROS_HOME");
+    if (NULL != rosHome && '\0' != rosHome[0])
+    {
+      return std::string(rosHome) + "/dbc_cache";
+    }
+
+    const char* home = getenv("HOME");
+    if (NULL != home && '\0' != home[0])
+    {
+      return std::string(home) + "/.ros/dbc_cache";
+    }
+
+    return std::string();
+  }
+
+  NewEagle::DbcDigest DbcCache::Hash(const char* data, size_t size)
+  {
+    NewEagle::DbcDigest hash;
+    NewEagle::Sha256(data, size, hash.data());
+
+    return hash;
+  }
+
+  std::string DbcCache::GetPath(const char* data, size_t size) const
+  {
+    return GetPath(Hash(data, size));
+  }
+
+  std::string DbcCache::GetPath(const NewEagle::DbcDigest &hash) const
+  {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    std::string path = _directory + "/";
+    for (size_t i = 0; i < hash.size(); i++)
+    {
+      path += HEX_DIGITS[hash[i] >> 4];
+      path += HEX_DIGITS[hash[i] & 0x0F];
+    }
+
+    return path + ".dbcc";
+  }
+
+  NewEagle::Dbc DbcCache::Load(const std::string &dbcFile)
+  {
+    return Load(dbcFile.data(), dbcFile.size());
+  }
+
+  NewEagle::Dbc DbcCache::LoadFile(const std::string &path)
+  {
+    NewEagle::MappedFile file(path, true);
+
+    if (!file.IsOpen())
+    {
+      throw std::runtime_error("Could not open DBC file: " + path);
+    }
+
+    return Load(file.GetData(), file.GetSize());
+  }
+
+  NewEagle::Dbc DbcCache::Load(const char* data, size_t size)
+  {
+    NewEagle::Dbc dbc;
+
+    if (_directory.empty())
+    {
+      dbc = NewEagle::DbcBuilder().NewDbc(data, size);
+      return dbc;
+    }
+
+    NewEagle::DbcDigest hash = Hash(data, size);
+    std::string path = GetPath(hash);
+
+    if (Read(path, hash, size, dbc))
+    {
+      ROS_INFO("dbc.size() = %d, from cache %s", dbc.GetMessageCount(), path.c_str());
+      return dbc;
+    }
+
+    dbc = NewEagle::DbcBuilder().NewDbc(data, size);
+
+    if (!Write(path, hash, size, dbc))
+    {
+      ROS_WARN("Could not write DBC cache %s: %s", path.c_str(), strerror(errno));
+    }
+
+    return dbc;
+  }
+
+  bool DbcCache::Read(const std::string &path, const NewEagle::DbcDigest &hash, size_t size, NewEagle::Dbc &dbc) const
+  {
+    NewEagle::MappedFile file(path, false);
+
+    if (NULL == file.GetData() || file.GetSize() < sizeof(CacheHeader))
+    {
+      return false;
+    }
+
+    const CacheHeader* header = (const CacheHeader*)file.GetData();
+
+    if (0 != memcmp(header->Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) ||
+        CACHE_VERSION != header->Version ||
+        CACHE_BYTE_ORDER != header->ByteOrder ||
+        0 != memcmp(hash.data(), header->SourceHash, sizeof(header->SourceHash)) ||
+        size != header->SourceSize)
+    {
+      return false;
+    }
+
+    uint64_t expectedSize = sizeof(CacheHeader) +
+      (uint64_t)header->MessageCount * sizeof(CachedMessage) +
+      (uint64_t)header->SignalCount * sizeof(CachedSignal) +
+      header->StringsSize;
+
+    if (expectedSize != file.GetSize())
+    {
+      ROS_WARN("DBC cache %s is damaged, rebuilding it", path.c_str());
+      return false;
+    }
+
+    const CachedMessage* messages = (const CachedMessage*)(header + 1);
+    const CachedSignal* signals = (const CachedSignal*)(messages + header->MessageCount);
+    const char* strings = (const char*)(signals + header->SignalCount);
+
+    std::vector<NewEagle::DbcSignal> messageSignals;
+
+    for (uint32_t m = 0; m < header->MessageCount; m++)
+    {
+      const CachedMessage &message = messages[m];
+
+      if ((uint64_t)message.FirstSignal + message.SignalCount > header->SignalCount ||
+          !ValidString(message.Name, header->StringsSize) ||
+          !ValidString(message.Comment, header->StringsSize) ||
+          message.Dlc > NewEagle::MAX_PAYLOAD_SIZE ||
+          message.IdType > NewEagle::EXT)
+      {
+        ROS_WARN("DBC cache %s is damaged, rebuilding it", path.c_str());
+        return false;
+      }
+
+      // Added empty and then filled in place, so the signals are not copied twice.
+      std::string messageName = ToString(strings, message.Name);
+      dbc.AddMessage(messageName, NewEagle::DbcMessage(message.Dlc, message.Id, (NewEagle::IdType)message.IdType, messageName, message.RawId));
+      NewEagle::DbcMessage* msg = dbc.GetMessage(messageName);
+
+      if (message.Comment.Length > 0)
+      {
+        NewEagle::DbcMessageComment comment;
+        comment.Id = message.RawId;
+        comment.Comment = ToString(strings, message.Comment);
+        msg->SetComment(comment);
+      }
+
+      messageSignals.clear();
+
+      for (uint32_t s = message.FirstSignal; s < message.FirstSignal + message.SignalCount; s++)
+      {
+        const CachedSignal &signal = signals[s];
+
+        if (!ValidString(signal.Name, header->StringsSize) ||
+            !ValidString(signal.Comment, header->StringsSize) ||
+            signal.Endianness > NewEagle::BIG_END ||
+            signal.Sign > NewEagle::SIGNED ||
+            signal.MultiplexerMode > NewEagle::MUX_SIGNAL ||
+            signal.DataType > NewEagle::DOUBLE)
+        {
+          ROS_WARN("DBC cache %s is damaged, rebuilding it", path.c_str());
+          return false;
+        }
+
+        std::string signalName = ToString(strings, signal.Name);
+
+        messageSignals.emplace_back(
+          signal.Dlc,
+          signal.Gain,
+          signal.Offset,
+          signal.StartBit,
+          (NewEagle::ByteOrder)signal.Endianness,
+          signal.Length,
+          (NewEagle::SignType)signal.Sign,
+          signalName,
+          (NewEagle::MultiplexerMode)signal.MultiplexerMode,
+          signal.MultiplexerSwitch);
+
+        NewEagle::DbcSignal &sig = messageSignals.back();
+        sig.SetInitialValue(signal.InitialValue);
+        sig.SetDataType((NewEagle::DataType)signal.DataType);
+
+        if (signal.Comment.Length > 0)
+        {
+          NewEagle::DbcSignalComment comment;
+          comment.Id = message.RawId;
+          comment.SignalName = signalName;
+          comment.Comment = ToString(strings, signal.Comment);
+          sig.SetComment(comment);
+        }
+      }
+
+      msg->AddSignals(messageSignals);
+    }
+
+    return true;
+  }
+
+  bool DbcCache::Write(const std::string &path, const NewEagle::DbcDigest &hash, size_t size, NewEagle::Dbc &dbc) const
+  {
+    std::vector<CachedMessage> messages;
+    std::vector<CachedSignal> signals;
+    std::vector<char> strings;
+
+    std::map<std::string, NewEagle::DbcMessage>* dbcMessages = dbc.GetMessages();
+
+    for (std::map<std::string, NewEagle::DbcMessage>::iterator it = dbcMessages->begin(); it != dbcMessages->end(); it++)
+    {
+      NewEagle::DbcMessage &msg = it->second;
+
+      CachedMessage message;
+      memset(&message, 0, sizeof(message));
+      message.RawId = msg.GetRawId();
+      message.Id = msg.GetId();
+      message.FirstSignal = (uint32_t)signals.size();
+      message.SignalCount = msg.GetSignalCount();
+      message.Name = AppendString(strings, it->first);
+      message.Comment = AppendString(strings, msg.GetComment().Comment);
+      message.Dlc = msg.GetDlc();
+      message.IdType = (uint8_t)msg.GetIdType();
+      messages.push_back(message);
+
+      std::map<std::string, NewEagle::DbcSignal>* msgSignals = msg.GetSignals();
+
+      for (std::map<std::string, NewEagle::DbcSignal>::iterator its = msgSignals->begin(); its != msgSignals->end(); its++)
+      {
+        NewEagle::DbcSignal &sig = its->second;
+
+        CachedSignal signal;
+        memset(&signal, 0, sizeof(signal));
+        signal.Gain = sig.GetGain();
+        signal.Offset = sig.GetOffset();
+        signal.InitialValue = sig.GetInitialValue();
+        signal.MultiplexerSwitch = sig.GetMultiplexerSwitch();
+        signal.Name = AppendString(strings, its->first);
+        signal.Comment = AppendString(strings, sig.GetComment().Comment);
+        signal.StartBit = sig.GetStartBit();
+        signal.Dlc = sig.GetDlc();
+        signal.Length = sig.GetLength();
+        signal.Endianness = (uint8_t)sig.GetEndianness();
+        signal.Sign = (uint8_t)sig.GetSign();
+        signal.MultiplexerMode = (uint8_t)sig.GetMultiplexerMode();
+        signal.DataType = (uint8_t)sig.GetDataType();
+        signals.push_back(signal);
+      }
+    }
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.Version = CACHE_VERSION;
+    header.ByteOrder = CACHE_BYTE_ORDER;
+    memcpy(header.SourceHash, hash.data(), sizeof(header.SourceHash));
+    header.SourceSize = size;
+    header.MessageCount = (uint32_t)messages.size();
+    header.SignalCount = (uint32_t)signals.size();
+    header.StringsSize = strings.size();
+
+    if (!MakeDirectories(_directory))
+    {
+      return false;
+    }
+
+    // Written under a temporary name and renamed, so a reader never maps a partial image.
+    //  mkstemp makes the name unique, since two nodes in one process may write the same image.
+    std::vector<char> tempName(path.begin(), path.end());
+    const char tempSuffix[] = ".XXXXXX";
+    tempName.insert(tempName.end(), tempSuffix, tempSuffix + sizeof(tempSuffix));
+
+    int fd = mkstemp(tempName.data());
+    if (fd < 0)
+    {
+      return false;
+    }
+    std::string tempPath = tempName.data();
+
+    // mkstemp creates the file private to its owner; the image is as readable as the DBC.
+    FILE* file = NULL;
+    if (0 == fchmod(fd, 0644))
+    {
+      file = fdopen(fd, "wb");
+    }
+
+    if (NULL == file)
+    {
+      int error = errno;
+      close(fd);
+      unlink(tempPath.c_str());
+      errno = error;
+      return false;
+    }
+
+    bool written =
+      1 == fwrite(&header, sizeof(header), 1, file) &&
+      messages.size() == fwrite(messages.data(), sizeof(CachedMessage), messages.size(), file) &&
+      signals.size() == fwrite(signals.data(), sizeof(CachedSignal), signals.size(), file) &&
+      strings.size() == fwrite(strings.data(), 1, strings.size(), file);
+
+    written = (0 == fclose(file)) && written;
+
+    if (!written || 0 != rename(tempPath.c_str(), path.c_str()))
+    {
+      int error = errno;
+      unlink(tempPath.c_str());
+      errno = error;
+      return false;
+    }
+
+    return true;
+  }
+}
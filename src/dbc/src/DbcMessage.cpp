@@ -34,12 +34,32 @@
  
 #include <dbc/DbcMessage.h>
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "DbcUtilities.h"
 
 namespace NewEagle
 {
+  namespace
+  {
+    // Switch ranges up to this size get a direct lookup table, wider ones a binary search.
+    const int64_t MAX_MUX_TABLE_SIZE = 1024;
+
+    bool MuxSwitchLess(const NewEagle::DbcSignal* a, const NewEagle::DbcSignal* b)
+    {
+      return a->GetMultiplexerSwitch() < b->GetMultiplexerSwitch();
+    }
+  }
+
   DbcMessage::DbcMessage()
   {
+    _lazyDecode = false;
+    memset(&_frameState, 0, sizeof(_frameState));
+    memset(&_frameStats, 0, sizeof(_frameStats));
+    _encodedIntelWord = 0;
+    _encodedMotorolaWord = 0;
+    Compile();
   };
 
   DbcMessage::DbcMessage(
@@ -54,33 +74,281 @@ namespace NewEagle
     _idType = idType;
     _name = name;
     _rawId = rawId;
+    _lazyDecode = false;
+
+    if (dlc > NewEagle::MAX_PAYLOAD_SIZE) {
+      throw std::runtime_error("DBC message is longer than a CAN FD frame: " + name);
+    }
+
+    memset(&_frameState, 0, sizeof(_frameState));
+    memset(&_frameStats, 0, sizeof(_frameStats));
+    _encodedIntelWord = 0;
+    _encodedMotorolaWord = 0;
+    Compile();
+  }
+
+  DbcMessage::DbcMessage(const DbcMessage &other)
+  {
+    *this = other;
+  }
+
+  DbcMessage::DbcMessage(DbcMessage &&other)
+  {
+    *this = std::move(other);
   }
 
   DbcMessage::~DbcMessage()
   {
   }
 
-  uint8_t DbcMessage::GetDlc()
+  DbcMessage& DbcMessage::operator=(const DbcMessage &other)
+  {
+    // Copied signals come out unbound, so settle the other message's pending lazy decodes first.
+    for(std::map<std::string, NewEagle::DbcSignal>::const_iterator it = other._signals.begin(); it != other._signals.end(); it++) {
+      it->second.GetResult();
+    }
+
+    _signals = other._signals;
+    memcpy(_data, other._data, sizeof(_data));
+    _dlc = other._dlc;
+    _id = other._id;
+    _idType = other._idType;
+    _name = other._name;
+    _rawId = other._rawId;
+    _comment = other._comment;
+    _lazyDecode = other._lazyDecode;
+    _frameState = other._frameState;
+    _frameStats = other._frameStats;
+    _encodedIntelWord = other._encodedIntelWord;
+    _encodedMotorolaWord = other._encodedMotorolaWord;
+
+    // The compiled list points into the other message's signals.
+    Compile();
+
+    return *this;
+  }
+
+  DbcMessage& DbcMessage::operator=(DbcMessage &&other)
+  {
+    if (this == &other) {
+      return *this;
+    }
+
+    // The signals keep their map nodes, so nothing is copied; Compile settles their
+    //  pending lazy decodes and rebinds them to this message's frame state.
+    _signals.swap(other._signals);
+    memcpy(_data, other._data, sizeof(_data));
+    _dlc = other._dlc;
+    _id = other._id;
+    _idType = other._idType;
+    _name.swap(other._name);
+    _rawId = other._rawId;
+    _comment = other._comment;
+    _lazyDecode = other._lazyDecode;
+    _frameState = other._frameState;
+    _frameStats = other._frameStats;
+    _encodedIntelWord = other._encodedIntelWord;
+    _encodedMotorolaWord = other._encodedMotorolaWord;
+
+    Compile();
+    other.Compile();
+
+    return *this;
+  }
+
+  void DbcMessage::Compile()
+  {
+    // Unmultiplexed signals and the switch go first, multiplexed signals after them,
+    //  so a frame is always a walk over the base signals plus an optional walk over the rest.
+    _compiledSignals.clear();
+    _compiledSignals.reserve(_signals.size());
+    _muxSwitch = NULL;
+
+    for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
+      if (NewEagle::MUX_SIGNAL != it->second.GetMultiplexerMode()) {
+        _compiledSignals.push_back(&it->second);
+      }
+      if (NewEagle::MUX_SWITCH == it->second.GetMultiplexerMode()) {
+        _muxSwitch = &it->second; // only one multiplexer switch per message is allowed
+      }
+    }
+
+    _baseSignalCount = _compiledSignals.size();
+
+    for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
+      if (NewEagle::MUX_SIGNAL == it->second.GetMultiplexerMode()) {
+        _compiledSignals.push_back(&it->second);
+      }
+    }
+
+    // Pages in switch order, signals by name within a page.
+    std::stable_sort(_compiledSignals.begin() + _baseSignalCount, _compiledSignals.end(), MuxSwitchLess);
+
+    // Without a switch there is nothing to select on, so every signal is decoded.
+    if (NULL == _muxSwitch) {
+      _baseSignalCount = _compiledSignals.size();
+    }
+
+    _plans.clear();
+    _plans.reserve(_compiledSignals.size());
+
+    for(size_t i = 0; i < _compiledSignals.size(); i++) {
+      _compiledSignals[i]->SetIndex(i);
+      _compiledSignals[i]->BindFrame(&_frameState, NULL != _muxSwitch);
+      _plans.push_back(_compiledSignals[i]->GetPlan());
+    }
+
+    CompileMuxPages();
+
+    // Two signals of different pages may share bits, anything else in the same frame may not.
+    std::vector<uint64_t> footprints(_compiledSignals.size() * NewEagle::MAX_PAYLOAD_SIZE / 8, 0);
+    const size_t words = NewEagle::MAX_PAYLOAD_SIZE / 8;
+
+    for(size_t i = 0; i < _compiledSignals.size(); i++) {
+      PayloadBits((uint8_t*)&footprints[i * words], _plans[i]);
+    }
+
+    _signalsOverlap = false;
+    for(size_t i = 0; i < _compiledSignals.size() && !_signalsOverlap; i++) {
+      for(size_t j = i + 1; j < _compiledSignals.size() && !_signalsOverlap; j++) {
+        if (i >= _baseSignalCount && _compiledSignals[i]->GetMultiplexerSwitch() != _compiledSignals[j]->GetMultiplexerSwitch()) {
+          continue;
+        }
+        for(size_t w = 0; w < words; w++) {
+          if (footprints[i * words + w] & footprints[j * words + w]) {
+            _signalsOverlap = true;
+            break;
+          }
+        }
+      }
+    }
+
+    // Signals were added, removed or rebound, so the next encode and decode start over.
+    _frameState.DirtyMask = ~(uint64_t)0;
+    _frameState.DefaultsStale = true;
+    _hasLastPayload = false;
+    _lastPayloadEdits = 0;
+  }
+
+  void DbcMessage::CompileDefaults()
+  {
+    _defaultRaws.resize(_compiledSignals.size());
+
+    for(size_t i = 0; i < _compiledSignals.size(); i++) {
+      _defaultRaws[i] = ToRaw(_compiledSignals[i]->GetInitialValue(), _plans[i]);
+    }
+
+    // Packed in the same order as a full encode, so overlapping signals land the same way.
+    _defaultIntelWord = 0;
+    _defaultMotorolaWord = 0;
+    memset(_defaultData, 0, sizeof(_defaultData));
+
+    for(size_t i = 0; i < _baseSignalCount; i++) {
+      PackRaw(_defaultIntelWord, _defaultMotorolaWord, _defaultData, _plans[i], _defaultRaws[i]);
+    }
+
+    const MuxPage* page = (NULL != _muxSwitch) ? FindMuxPage(ScaleRaw(_defaultRaws[_muxSwitch->GetIndex()], _plans[_muxSwitch->GetIndex()])) : NULL;
+
+    if (NULL != page) {
+      for(size_t i = page->Begin; i < page->End; i++) {
+        PackRaw(_defaultIntelWord, _defaultMotorolaWord, _defaultData, _plans[i], _defaultRaws[i]);
+      }
+    }
+
+    _frameState.DefaultsStale = false;
+  }
+
+  void DbcMessage::CompileMuxPages()
+  {
+    _muxPages.clear();
+    _muxPageTable.clear();
+
+    if (NULL == _muxSwitch) {
+      return;
+    }
+
+    for(size_t i = _baseSignalCount; i < _compiledSignals.size(); i++) {
+      int32_t value = _compiledSignals[i]->GetMultiplexerSwitch();
+
+      if (_muxPages.empty() || _muxPages.back().Value != value) {
+        MuxPage page;
+        page.Value = value;
+        page.Begin = i;
+        _muxPages.push_back(page);
+      }
+
+      _muxPages.back().End = i + 1;
+    }
+
+    if (_muxPages.empty()) {
+      return;
+    }
+
+    int64_t range = (int64_t)_muxPages.back().Value - _muxPages.front().Value + 1;
+
+    if (range <= MAX_MUX_TABLE_SIZE) {
+      _muxPageTable.assign(range, 0);
+
+      for(size_t p = 0; p < _muxPages.size(); p++) {
+        _muxPageTable[_muxPages[p].Value - _muxPages.front().Value] = p + 1;
+      }
+    }
+  }
+
+  const DbcMessage::MuxPage* DbcMessage::FindMuxPage(double muxValue) const
+  {
+    if (_muxPages.empty() || !(muxValue >= _muxPages.front().Value && muxValue <= _muxPages.back().Value)) {
+      return NULL;
+    }
+
+    // Only a whole switch value can select a page.
+    int32_t value = (int32_t)muxValue;
+    if (value != muxValue) {
+      return NULL;
+    }
+
+    if (!_muxPageTable.empty()) {
+      uint16_t page = _muxPageTable[value - _muxPages.front().Value];
+      return (0 == page) ? NULL : &_muxPages[page - 1];
+    }
+
+    size_t low = 0;
+    size_t high = _muxPages.size();
+
+    while (low < high) {
+      size_t mid = (low + high) / 2;
+
+      if (_muxPages[mid].Value < value) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    return (low < _muxPages.size() && _muxPages[low].Value == value) ? &_muxPages[low] : NULL;
+  }
+
+  uint8_t DbcMessage::GetDlc() const
   {
     return _dlc;
   }
 
-  uint32_t DbcMessage::GetId()
+  uint32_t DbcMessage::GetId() const
   {
     return _id;
   }
 
-  uint32_t DbcMessage::GetRawId()
+  uint32_t DbcMessage::GetRawId() const
   {
     return _rawId;
   }
 
-  IdType DbcMessage::GetIdType()
+  IdType DbcMessage::GetIdType() const
   {
     return _idType;
   }
 
-  std::string DbcMessage::GetName()
+  std::string DbcMessage::GetName() const
   {
     return _name;
   }
@@ -89,98 +357,277 @@ namespace NewEagle
   {
     can_msgs::Frame frame;
 
+    EncodeFrame(frame);
+
+    return frame;
+  }
+
+  void DbcMessage::EncodeFrame(can_msgs::Frame &frame)
+  {
+    CheckClassic();
+
     frame.id = _id;
     frame.dlc = _dlc;
     frame.is_extended = _idType == EXT;
 
-    uint8_t *ptr = (uint8_t*)frame.data.elems;
-    memset(ptr, 0x00, 8);
-
-    if(!AnyMultiplexedSignals()) {
-      for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
-        Pack(ptr, it->second);
-      }    
-    }
-    else{
-      // Start by looping through an only setting signals that are not multiplexed
-      // While we're at it, we can pick out the mutliplexer switch.  
-      // Perform a second loop to find the mulitplexed signal based on the multiplexer switch.
-            
-      NewEagle::DbcSignal* muxSwitch; // only one multiplexer switch per message is allowed
-
-      for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
-        if (NewEagle::NONE == it->second.GetMultiplexerMode()) {
-          Pack(ptr, it->second);
-        }                
-        if (NewEagle::MUX_SWITCH == it->second.GetMultiplexerMode()) {
-          muxSwitch = &it->second;
-          Pack(ptr, it->second);
+    EncodeFrame((uint8_t*)frame.data.elems);
+  }
+
+  void DbcMessage::EncodeFrame(uint8_t* data)
+  {
+    uint64_t dirty = _frameState.DirtyMask;
+    bool muxChanged = (NULL != _muxSwitch) && _muxSwitch->GetIndex() < 64 && (dirty & ((uint64_t)1 << _muxSwitch->GetIndex()));
+
+    if (dirty == ~(uint64_t)0 || muxChanged || (dirty && _signalsOverlap)) {
+      // Intel and Motorola signals are packed into their own frame word, then merged.
+      _encodedIntelWord = 0;
+      _encodedMotorolaWord = 0;
+      memset(_data, 0, sizeof(_data));
+
+      for(size_t i = 0; i < _baseSignalCount; i++) {
+        PackRaw(_encodedIntelWord, _encodedMotorolaWord, _data, _plans[i], _compiledSignals[i]->GetRaw());
+      }
+
+      const MuxPage* page = (NULL != _muxSwitch) ? FindMuxPage(_muxSwitch->GetResult()) : NULL;
+
+      if (NULL != page) {
+        for(size_t i = page->Begin; i < page->End; i++) {
+          PackRaw(_encodedIntelWord, _encodedMotorolaWord, _data, _plans[i], _compiledSignals[i]->GetRaw());
         }
-      }  
+      }
+    } else {
+      // Signals never overlap within a page, so each dirty one can be re-packed in place.
+      const MuxPage* page = (NULL != _muxSwitch) ? FindMuxPage(_muxSwitch->GetResult()) : NULL;
 
-      for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
-        if (NewEagle::MUX_SIGNAL == it->second.GetMultiplexerMode()) {
-          if (muxSwitch->GetResult() == it->second.GetMultiplexerSwitch()) {
-            Pack(ptr, it->second);
-          }
+      while (dirty) {
+        size_t i = __builtin_ctzll(dirty);
+        dirty &= dirty - 1;
 
-        }                  
+        if (i < _baseSignalCount || (NULL != page && i >= page->Begin && i < page->End)) {
+          PackRaw(_encodedIntelWord, _encodedMotorolaWord, _data, _plans[i], _compiledSignals[i]->GetRaw());
+        }
       }
     }
 
-    return frame;
+    _frameState.DirtyMask = 0;
+
+    if (_dlc > 8) {
+      memcpy(data, _data, _dlc);
+    } else {
+      StoreFrameWords(data, _encodedIntelWord, _encodedMotorolaWord);
+    }
   }
 
-  void DbcMessage::SetFrame(const can_msgs::Frame::ConstPtr& msg)
+  void DbcMessage::ResetToDefaults()
   {
-    uint8_t *ptr = (uint8_t*)msg->data.elems;
+    if (_frameState.DefaultsStale) {
+      CompileDefaults();
+    }
 
-    if(!AnyMultiplexedSignals()) {
-      for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
-        double res = Unpack(ptr, it->second);
-        it->second.SetResult(res);
+    _encodedIntelWord = _defaultIntelWord;
+    _encodedMotorolaWord = _defaultMotorolaWord;
+    if (_dlc > 8) {
+      memcpy(_data, _defaultData, _dlc);
+    }
+
+    for(size_t i = 0; i < _compiledSignals.size(); i++) {
+      _compiledSignals[i]->RestoreRaw(_defaultRaws[i]);
+    }
+
+    // The payload already matches the signals; only values set after this get re-packed.
+    _frameState.DirtyMask = 0;
+    _frameState.Edits++;
+  }
+
+  void DbcMessage::ResetToDefaults(NewEagle::DecodedFrame &frame) const
+  {
+    frame.Values.resize(_compiledSignals.size());
+
+    // Quantized the way _defaultRaws are, so the frame encodes to the default payload.
+    for(size_t i = 0; i < _compiledSignals.size(); i++) {
+      frame.Values[i] = ScaleRaw(ToRaw(_compiledSignals[i]->GetInitialValue(), _plans[i]), _plans[i]);
+    }
+  }
+
+  bool DbcMessage::SetFrame(const can_msgs::Frame::ConstPtr& msg)
+  {
+    return SetFrame((const uint8_t*)msg->data.elems, sizeof(msg->data.elems));
+  }
+
+  bool DbcMessage::SetFrame(const uint8_t* data, size_t length)
+  {
+    // A short frame reads as zeros past its end, so every signal stays inside the buffer.
+    uint8_t padded[NewEagle::MAX_PAYLOAD_SIZE];
+    size_t size = PayloadSize();
+
+    if (length < size) {
+      memcpy(padded, data, length);
+      memset(padded + length, 0, size - length);
+      data = padded;
+    }
+
+    _frameStats.Frames++;
+
+    // Reports often repeat for long stretches; unless a signal was set since, the last decode still holds.
+    if (_hasLastPayload && _lastPayloadEdits == _frameState.Edits && 0 == memcmp(_lastPayload, data, size)) {
+      _frameStats.Repeats++;
+      return false;
+    }
+
+    memcpy(_lastPayload, data, size);
+    _hasLastPayload = true;
+
+    uint64_t intelWord = LoadFrameWord(data, false);
+    uint64_t motorolaWord = LoadFrameWord(data, true);
+
+    if (_lazyDecode) {
+      _frameState.IntelWord = intelWord;
+      _frameState.MotorolaWord = motorolaWord;
+      if (_dlc > 8) {
+        memcpy(_frameState.Payload, data, _dlc);
+      }
+      _frameState.Sequence++;
+      _frameState.DirtyMask = ~(uint64_t)0;
+
+      if (NULL != _muxSwitch) {
+        _frameState.MuxValue = Unpack(intelWord, motorolaWord, data, _plans[_muxSwitch->GetIndex()]);
       }
+
+      _lastPayloadEdits = _frameState.Edits;
+      return true;
     }
-    else{
-      // Start by looping through an only setting signals that are not multiplexed
-      // While we're at it, we can pick out the mutliplexer switch.  
-      // Perform a second loop to find the mulitplexed signal based on the multiplexer switch.
-            
-      NewEagle::DbcSignal* muxSwitch; // only one multiplexer switch per message is allowed
 
-      for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
-        if (NewEagle::NONE == it->second.GetMultiplexerMode()) {
-          double res = Unpack(ptr, it->second);
-          it->second.SetResult(res);
-        }                
-        if (NewEagle::MUX_SWITCH == it->second.GetMultiplexerMode()) {
-          muxSwitch = &it->second;
-          double res = Unpack(ptr, it->second);
-          it->second.SetResult(res);
-        }
-      }  
+    for(size_t i = 0; i < _baseSignalCount; i++) {
+      _compiledSignals[i]->SetRaw(UnpackRaw(intelWord, motorolaWord, data, _plans[i]));
+    }
 
-      for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++) {
-        if (NewEagle::MUX_SIGNAL == it->second.GetMultiplexerMode()) {
-          if (muxSwitch->GetResult() == it->second.GetMultiplexerSwitch()) {
-            double res = Unpack(ptr, it->second);
-            it->second.SetResult(res);
-          }
+    const MuxPage* page = (NULL != _muxSwitch) ? FindMuxPage(_muxSwitch->GetResult()) : NULL;
+
+    if (NULL != page) {
+      for(size_t i = page->Begin; i < page->End; i++) {
+        _compiledSignals[i]->SetRaw(UnpackRaw(intelWord, motorolaWord, data, _plans[i]));
+      }
+    }
+
+    _lastPayloadEdits = _frameState.Edits;
+    return true;
+  }
+
+  NewEagle::DbcFrameStats DbcMessage::GetFrameStats() const
+  {
+    return _frameStats;
+  }
+
+  void DbcMessage::ResetFrameStats()
+  {
+    memset(&_frameStats, 0, sizeof(_frameStats));
+  }
+
+  void DbcMessage::Decode(const uint8_t* data, NewEagle::DecodedFrame &frame) const
+  {
+    if (frame.Values.size() != _compiledSignals.size()) {
+      frame.Values.assign(_compiledSignals.size(), 0.0);
+    }
+
+    uint64_t intelWord = LoadFrameWord(data, false);
+    uint64_t motorolaWord = LoadFrameWord(data, true);
+
+    for(size_t i = 0; i < _baseSignalCount; i++) {
+      frame.Values[i] = Unpack(intelWord, motorolaWord, data, _plans[i]);
+    }
+
+    const MuxPage* page = (NULL != _muxSwitch) ? FindMuxPage(frame.Values[_muxSwitch->GetIndex()]) : NULL;
+
+    if (NULL != page) {
+      for(size_t i = page->Begin; i < page->End; i++) {
+        frame.Values[i] = Unpack(intelWord, motorolaWord, data, _plans[i]);
+      }
+    }
+  }
+
+  void DbcMessage::Decode(const can_msgs::Frame &msg, NewEagle::DecodedFrame &frame) const
+  {
+    if (_dlc > 8) {
+      uint8_t padded[NewEagle::MAX_PAYLOAD_SIZE] = {0};
+      memcpy(padded, msg.data.elems, sizeof(msg.data.elems));
+      Decode(padded, frame);
+      return;
+    }
+
+    Decode((const uint8_t*)msg.data.elems, frame);
+  }
+
+  void DbcMessage::Encode(const NewEagle::DecodedFrame &frame, uint8_t* data) const
+  {
+    if (frame.Values.size() != _compiledSignals.size()) {
+      throw std::runtime_error("DecodedFrame does not match DBC message: " + _name);
+    }
+
+    uint64_t intelWord = 0;
+    uint64_t motorolaWord = 0;
+
+    if (_dlc > 8) {
+      memset(data, 0, _dlc);
+    }
 
-        }                  
+    for(size_t i = 0; i < _baseSignalCount; i++) {
+      Pack(intelWord, motorolaWord, data, _plans[i], frame.Values[i]);
+    }
+
+    const MuxPage* page = (NULL != _muxSwitch) ? FindMuxPage(frame.Values[_muxSwitch->GetIndex()]) : NULL;
+
+    if (NULL != page) {
+      for(size_t i = page->Begin; i < page->End; i++) {
+        Pack(intelWord, motorolaWord, data, _plans[i], frame.Values[i]);
       }
-    }    
+    }
 
+    if (_dlc <= 8) {
+      StoreFrameWords(data, intelWord, motorolaWord);
+    }
+  }
+
+  void DbcMessage::Encode(const NewEagle::DecodedFrame &frame, can_msgs::Frame &msg) const
+  {
+    CheckClassic();
+
+    msg.id = _id;
+    msg.dlc = _dlc;
+    msg.is_extended = _idType == EXT;
+
+    Encode(frame, (uint8_t*)msg.data.elems);
   }
 
   void DbcMessage::AddSignal(std::string signalName, NewEagle::DbcSignal signal)
   {
     _signals.insert(std::pair<std::string, NewEagle::DbcSignal>(signalName, signal));
+    Compile();
+  }
+
+  void DbcMessage::AddSignals(const std::vector<NewEagle::DbcSignal> &signals)
+  {
+    // One Compile for the whole batch; AddSignal per signal is quadratic in the message size.
+    for (std::vector<NewEagle::DbcSignal>::const_iterator it = signals.begin(); it != signals.end(); it++)
+    {
+      _signals.insert(std::pair<std::string, NewEagle::DbcSignal>(it->GetName(), *it));
+    }
+
+    Compile();
+  }
+
+  NewEagle::DbcSignal* DbcMessage::GetSignal(const std::string &signalName)
+  {
+    return const_cast<NewEagle::DbcSignal*>(static_cast<const DbcMessage*>(this)->GetSignal(signalName));
   }
 
-  NewEagle::DbcSignal* DbcMessage::GetSignal(std::string signalName)
+  NewEagle::DbcSignal* DbcMessage::ResolveSignal(const std::string &signalName)
   {
-    std::map<std::string, NewEagle::DbcSignal>::iterator it;
+    return const_cast<NewEagle::DbcSignal*>(static_cast<const DbcMessage*>(this)->ResolveSignal(signalName));
+  }
+
+  const NewEagle::DbcSignal* DbcMessage::GetSignal(const std::string &signalName) const
+  {
+    std::map<std::string, NewEagle::DbcSignal>::const_iterator it;
 
     it = _signals.find(signalName);
 
@@ -189,7 +636,17 @@ namespace NewEagle
       return NULL;
     }
 
-    NewEagle::DbcSignal* signal = &it->second;
+    return &it->second;
+  }
+
+  const NewEagle::DbcSignal* DbcMessage::ResolveSignal(const std::string &signalName) const
+  {
+    const NewEagle::DbcSignal* signal = GetSignal(signalName);
+
+    if (NULL == signal)
+    {
+      throw std::runtime_error("DBC signal not found: " + _name + "." + signalName);
+    }
 
     return signal;
   }
@@ -199,7 +656,7 @@ namespace NewEagle
 
   }
 
-  uint32_t DbcMessage::GetSignalCount()
+  uint32_t DbcMessage::GetSignalCount() const
   {
     return _signals.size();
   }
@@ -209,11 +666,66 @@ namespace NewEagle
     _comment = comment;
   }
 
+  NewEagle::DbcMessageComment DbcMessage::GetComment() const
+  {
+    return _comment;
+  }
+
   std::map<std::string, NewEagle::DbcSignal>* DbcMessage::GetSignals()
   {
     return &_signals;
   }
 
+  const std::map<std::string, NewEagle::DbcSignal>* DbcMessage::GetSignals() const
+  {
+    return &_signals;
+  }
+
+  void DbcMessage::SetLazyDecode(bool lazy)
+  {
+    // Rebinding the signals settles any decode still pending.
+    _lazyDecode = lazy;
+    Compile();
+  }
+
+  bool DbcMessage::GetLazyDecode()
+  {
+    return _lazyDecode;
+  }
+
+  // Classic frames are read as 8 bytes even when the DLC is shorter.
+  size_t DbcMessage::PayloadSize() const
+  {
+    return (_dlc > 8) ? _dlc : 8;
+  }
+
+  void DbcMessage::CheckClassic() const
+  {
+    if (_dlc > 8) {
+      throw std::runtime_error("CAN FD message does not fit in a can_msgs::Frame: " + _name);
+    }
+  }
+
+  double DecodedFrame::GetValue(const NewEagle::DbcSignal* signal) const
+  {
+    return Values[signal->GetIndex()];
+  }
+
+  void DecodedFrame::SetValue(const NewEagle::DbcSignal* signal, double value)
+  {
+    Values[signal->GetIndex()] = value;
+  }
+
+  int64_t DecodedFrame::GetRaw(const NewEagle::DbcSignal* signal) const
+  {
+    return ToRaw(Values[signal->GetIndex()], signal->GetPlan());
+  }
+
+  void DecodedFrame::SetRaw(const NewEagle::DbcSignal* signal, int64_t raw)
+  {
+    Values[signal->GetIndex()] = ScaleRaw(raw, signal->GetPlan());
+  }
+
   bool DbcMessage::AnyMultiplexedSignals()
   {
     for(std::map<std::string, NewEagle::DbcSignal>::iterator it = _signals.begin(); it != _signals.end(); it++)
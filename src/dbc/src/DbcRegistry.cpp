@@ -0,0 +1,134 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <dbc/DbcRegistry.h>
+#include <dbc/DbcCache.h>
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "MappedFile.h"
+
+namespace NewEagle
+{
+  namespace
+  {
+    typedef std::pair<NewEagle::DbcDigest, size_t> RegistryKey;
+    typedef std::map<RegistryKey, std::weak_ptr<const NewEagle::Dbc> > RegistryMap;
+
+    // Function statics, so the registry is ready however early a nodelet loads.
+    std::mutex& RegistryMutex()
+    {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    RegistryMap& Registry()
+    {
+      static RegistryMap registry;
+      return registry;
+    }
+  }
+
+  std::shared_ptr<const NewEagle::Dbc> DbcRegistry::Load(const std::string &dbcFile, const std::string &cacheDirectory)
+  {
+    return Load(dbcFile.data(), dbcFile.size(), cacheDirectory);
+  }
+
+  std::shared_ptr<const NewEagle::Dbc> DbcRegistry::Load(const char* data, size_t size, const std::string &cacheDirectory)
+  {
+    RegistryKey key(NewEagle::DbcCache::Hash(data, size), size);
+
+    // Held across the build, so nodelets starting together on the same DBC wait for
+    //  one build instead of each doing their own.
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    RegistryMap &registry = Registry();
+
+    std::shared_ptr<const NewEagle::Dbc> dbc = registry[key].lock();
+
+    if (!dbc)
+    {
+      dbc = std::make_shared<const NewEagle::Dbc>(NewEagle::DbcCache(cacheDirectory).Load(data, size));
+      registry[key] = dbc;
+    }
+
+    // Drop the entries nobody holds any more.
+    for (RegistryMap::iterator it = registry.begin(); it != registry.end();)
+    {
+      if (it->second.expired())
+      {
+        registry.erase(it++);
+      }
+      else
+      {
+        it++;
+      }
+    }
+
+    return dbc;
+  }
+
+  std::shared_ptr<const NewEagle::Dbc> DbcRegistry::LoadFile(const std::string &path, const std::string &cacheDirectory)
+  {
+    NewEagle::MappedFile file(path, true);
+
+    if (!file.IsOpen())
+    {
+      throw std::runtime_error("Could not open DBC file: " + path);
+    }
+
+    return Load(file.GetData(), file.GetSize(), cacheDirectory);
+  }
+
+  size_t DbcRegistry::GetCount()
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    RegistryMap &registry = Registry();
+
+    size_t count = 0;
+    for (RegistryMap::const_iterator it = registry.begin(); it != registry.end(); it++)
+    {
+      if (!it->second.expired())
+      {
+        count++;
+      }
+    }
+
+    return count;
+  }
+}
@@ -33,6 +33,9 @@
  *********************************************************************/
  
 #include <dbc/DbcSignal.h>
+#include <dbc/DbcCodec.h>
+
+#include "DbcUtilities.h"
 
 namespace NewEagle
 {
@@ -40,7 +43,7 @@ namespace NewEagle
     uint8_t dlc,
     double gain,
     double offset,
-    uint8_t startBit,
+    uint16_t startBit,
     ByteOrder endianness,
     uint8_t length,
     SignType sign,
@@ -56,13 +59,21 @@ namespace NewEagle
     _sign = sign;
     _name = name;
     _multiplexerMode = multiplexerMode;
+    _multiplexerSwitch = 0;
+    _index = 0;
+    _result = 0;
+    _raw = 0;
+    _initialValue = offset; // raw 0 until the DBC gives a GenSigStartValue
+    _type = NewEagle::INT;
+
+    CompilePlan();
   }
 
   DbcSignal::DbcSignal(
     uint8_t dlc,
     double gain,
     double offset,
-    uint8_t startBit,
+    uint16_t startBit,
     ByteOrder endianness,
     uint8_t length,
     SignType sign,
@@ -80,6 +91,13 @@ namespace NewEagle
     _name = name;
     _multiplexerMode = multiplexerMode;
     _multiplexerSwitch = multiplexerSwitch;
+    _index = 0;
+    _result = 0;
+    _raw = 0;
+    _initialValue = offset; // raw 0 until the DBC gives a GenSigStartValue
+    _type = NewEagle::INT;
+
+    CompilePlan();
   }
 
   DbcSignal::~DbcSignal()
@@ -93,9 +111,32 @@ namespace NewEagle
 
   double DbcSignal::GetResult() const
   {
+    Settle();
     return _result;
   }
 
+  int64_t DbcSignal::GetRaw() const
+  {
+    Settle();
+    return _raw;
+  }
+
+  // Brings a lazily decoded signal up to the frame it is bound to.
+  void DbcSignal::Settle() const
+  {
+    if (NULL != _binding.Frame && _binding.Sequence != _binding.Frame->Sequence)
+    {
+      _binding.Sequence = _binding.Frame->Sequence;
+
+      // Like an eager decode, a multiplexed signal keeps its last value when the switch selects another page.
+      if (!_binding.Multiplexed || NewEagle::MUX_SIGNAL != _multiplexerMode || _binding.Frame->MuxValue == _multiplexerSwitch)
+      {
+        _raw = UnpackRaw(_binding.Frame->IntelWord, _binding.Frame->MotorolaWord, _binding.Frame->Payload, _plan);
+        _result = ScaleRaw(_raw, _plan);
+      }
+    }
+  }
+
   double DbcSignal::GetGain() const
   {
     return _gain;
@@ -106,7 +147,7 @@ namespace NewEagle
     return _offset;
   }
 
-  uint8_t DbcSignal::GetStartBit() const
+  uint16_t DbcSignal::GetStartBit() const
   {
     return _startBit;
   }
@@ -133,18 +174,83 @@ namespace NewEagle
 
   void DbcSignal::SetResult(double result)
   {
+    // Setting the value already held keeps its raw value, which a conversion back might not reproduce.
+    if (result == _result && IsSettled())
+    {
+      return;
+    }
+
+    MarkDirty();
     _result = result;
+    _raw = ToRaw(result, _plan);
+  }
+
+  void DbcSignal::SetRaw(int64_t raw)
+  {
+    // The result is rescaled either way: one set through SetResult may sit between two raw steps.
+    if (raw != _raw || !IsSettled())
+    {
+      MarkDirty();
+    }
+
+    _raw = raw;
+    _result = ScaleRaw(raw, _plan);
+  }
+
+  // Sets the value without marking it dirty; the caller has already put it in the encoded payload.
+  void DbcSignal::RestoreRaw(int64_t raw)
+  {
+    _raw = raw;
+    _result = ScaleRaw(raw, _plan);
+
+    if (NULL != _binding.Frame)
+    {
+      _binding.Sequence = _binding.Frame->Sequence;
+    }
+  }
+
+  bool DbcSignal::IsSettled() const
+  {
+    return NULL == _binding.Frame || _binding.Sequence == _binding.Frame->Sequence;
+  }
+
+  void DbcSignal::MarkDirty()
+  {
+    if (NULL != _binding.Frame)
+    {
+      _binding.Frame->DirtyMask |= (_index < 64) ? ((uint64_t)1 << _index) : ~(uint64_t)0;
+      _binding.Frame->Edits++;
+
+      // An explicit value wins over the pending decode of the current frame.
+      _binding.Sequence = _binding.Frame->Sequence;
+    }
   }
 
   void DbcSignal::SetComment(NewEagle::DbcSignalComment comment)
   {
-    _comment = comment;
+    _comment = std::make_shared<const NewEagle::DbcSignalComment>(comment);
+  }
+
+  NewEagle::DbcSignalComment DbcSignal::GetComment() const
+  {
+    if (!_comment)
+    {
+      return NewEagle::DbcSignalComment();
+    }
+
+    return *_comment;
   }
 
   void DbcSignal::SetInitialValue(double value)
   {
     _initialValue = value;
+
+    if (NULL != _binding.Frame)
+    {
+      _binding.Frame->DefaultsStale = true;
+    }
   }
+
   double DbcSignal::GetInitialValue()
   {
     return _initialValue;
@@ -169,4 +275,49 @@ namespace NewEagle
   {
     return _multiplexerSwitch;
   }
+
+  const NewEagle::DbcSignalPlan& DbcSignal::GetPlan() const
+  {
+    return _plan;
+  }
+
+  void DbcSignal::BindFrame(NewEagle::DbcFrameState* frame, bool multiplexed)
+  {
+    // Settle any decode still pending against the old frame before switching.
+    GetResult();
+
+    _binding.Frame = frame;
+    _binding.Sequence = (NULL != frame) ? frame->Sequence : 0;
+    _binding.Multiplexed = multiplexed;
+  }
+
+  uint32_t DbcSignal::GetIndex() const
+  {
+    return _index;
+  }
+
+  void DbcSignal::SetIndex(uint32_t index)
+  {
+    _index = index;
+  }
+
+  void DbcSignal::CompilePlan()
+  {
+    bool bigEndian = (_endianness == NewEagle::BIG_END);
+    uint8_t frameSize = (_dlc > 8) ? _dlc : 8;
+    uint8_t window = NewEagle::Codec::WindowOffset(_startBit, _length, bigEndian, frameSize);
+    int32_t lsb = NewEagle::Codec::LsbPosition(_startBit, _length, bigEndian, window);
+
+    _plan.Valid = NewEagle::Codec::FitsFrame(_startBit, _length, bigEndian, frameSize);
+    _plan.Windowed = frameSize > 8;
+    _plan.Wide = _plan.Valid && !NewEagle::Codec::Fits(lsb, _length);
+    _plan.Window = window;
+    _plan.Shift = _plan.Valid ? (uint8_t)lsb : 0;
+    _plan.Mask = NewEagle::Codec::LengthMask(_length);
+    _plan.SignBit = NewEagle::Codec::SignBit(_length, _sign == NewEagle::SIGNED);
+    _plan.Gain = _gain;
+    _plan.Offset = _offset;
+    _plan.BigEndian = bigEndian;
+    _plan.Scaled = (_gain != 1) || (_offset != 0);
+  }
 }
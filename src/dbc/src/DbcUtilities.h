@@ -36,10 +36,14 @@
 #define _NEW_EAGLE_DBC_UTILITIES_H
 
 #include <ros/ros.h>
+#include <endian.h>
+#include <string.h>
+#include <limits>
 #include <map>
 #include <sstream>      // std::istringstream
 #include <string>
 
+#include <dbc/DbcCodec.h>
 #include <dbc/DbcSignal.h>
 #include <dbc/DbcMessage.h>
 
@@ -66,187 +70,200 @@ namespace NewEagle
 
   }
 
-  static double Unpack(uint8_t* data, const NewEagle::DbcSignal &signal)
+  // Read the 8 byte payload as one 64-bit word.  Intel signals index it little-endian,
+  //  Motorola signals big-endian, so both byte orders reduce to a shift and a mask.
+  static inline uint64_t LoadFrameWord(const uint8_t* data, bool bigEndian)
   {
-    int32_t wordSize = sizeof(data);
-    int32_t startBit = (int32_t)signal.GetStartBit();
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
 
-    if (signal.GetEndianness() == NewEagle::LITTLE_END)
-    {
-      startBit = ConvertToMTBitOrdering(signal.GetStartBit(), signal.GetDlc());
-    }
-    else
+    return bigEndian ? be64toh(word) : le64toh(word);
+  }
+
+  static inline void StoreFrameWord(uint8_t* data, uint64_t word, bool bigEndian)
+  {
+    word = bigEndian ? htobe64(word) : htole64(word);
+    memcpy(data, &word, sizeof(word));
+  }
+
+  // Write both frame words back as one payload.  Signals never overlap, so the byte images can be OR'd.
+  static inline void StoreFrameWords(uint8_t* data, uint64_t intelWord, uint64_t motorolaWord)
+  {
+    StoreFrameWord(data, intelWord | le64toh(htobe64(motorolaWord)), false);
+  }
+
+  // Raw bits of a CAN FD signal, read through its window.
+  static inline uint64_t LoadWindow(const uint8_t* data, const NewEagle::DbcSignalPlan &plan)
+  {
+    uint64_t raw = LoadFrameWord(data + plan.Window, plan.BigEndian) >> plan.Shift;
+
+    if (plan.Wide)
     {
-      startBit = ConvertToMTBitOrdering(signal.GetStartBit(), signal.GetDlc()) - ((int32_t)signal.GetLength() - 1);
+      raw |= (uint64_t)data[plan.BigEndian ? plan.Window - 1 : plan.Window + 8] << (64 - plan.Shift);
     }
 
-    int32_t bit = (int32_t)(startBit % 8);
+    return raw & plan.Mask;
+  }
 
-    bool isExactlyByte = ((bit + signal.GetLength()) % 8 == 0);
-    uint32_t numBytes = (isExactlyByte ? 0 : 1) + ((bit + (int32_t)signal.GetLength()) / 8);
+  static inline void StoreWindow(uint8_t* data, const NewEagle::DbcSignalPlan &plan, uint64_t raw)
+  {
+    raw &= plan.Mask;
 
-    int32_t b = (int32_t)wordSize - ((int)startBit / 8) - 1;
-    int32_t w = (int)signal.GetLength();
-    int32_t maskShift = bit;
-    int32_t rightShift = 0;
+    uint64_t word = LoadFrameWord(data + plan.Window, plan.BigEndian);
+    word &= ~(plan.Mask << plan.Shift);
+    word |= raw << plan.Shift;
+    StoreFrameWord(data + plan.Window, word, plan.BigEndian);
 
-    uint32_t unsignedResult = 0;
-    for(int32_t i = 0; i < numBytes; i++)
+    if (plan.Wide)
     {
-      if ((b < 0) || (b >= sizeof(data)))
-      {
-        return std::numeric_limits<int>::quiet_NaN();
-      }
-
-      int32_t mask = 0xFF;
-      if (w < 8)
-      {
-        mask >>= (8 - w);
-      }
-      mask <<= maskShift;
-
-      int32_t extractedByte = (data[b] & mask) >> maskShift;
-      unsignedResult |= (uint32_t)extractedByte << (8 * i - rightShift);
-
-      if (signal.GetEndianness() == NewEagle::BIG_END)
-      {
-        if ((b % wordSize) == 0)
-        {
-          b += 2 * wordSize - 1;
-        }
-        else
-        {
-          b--;
-        }
-      }
-      else
-      {
-        b++;
-      }
+      uint8_t &extra = data[plan.BigEndian ? plan.Window - 1 : plan.Window + 8];
+      uint8_t bits = (uint8_t)(plan.Mask >> (64 - plan.Shift));
+      extra = (extra & ~bits) | ((uint8_t)(raw >> (64 - plan.Shift)) & bits);
     }
+  }
 
-    double result = 0;
-    if (signal.GetSign() == NewEagle::SIGNED)
+  // Marks the bits a signal occupies in image, a zeroed buffer of MAX_PAYLOAD_SIZE bytes
+  //  laid out like the payload.
+  static inline void PayloadBits(uint8_t* image, const NewEagle::DbcSignalPlan &plan)
+  {
+    if (!plan.Valid)
     {
-      if ((unsignedResult & (1 << (int32_t)signal.GetLength() - 1)) != 0)
-      {
-        if (signal.GetLength() < 32)
-        {
-          uint32_t signExtension = (0xFFFFFFFF << (int32_t)signal.GetLength());
-          unsignedResult |= signExtension;
-        }
-      }
-
-      result = (double)((int32_t)unsignedResult);
+      return;
+    }
 
+    if (plan.Windowed)
+    {
+      StoreWindow(image, plan, ~(uint64_t)0);
+      return;
     }
-    else if (signal.GetSign() == NewEagle::UNSIGNED)
+
+    uint64_t bits = plan.Mask << plan.Shift;
+    StoreFrameWords(image, plan.BigEndian ? 0 : bits, plan.BigEndian ? bits : 0);
+  }
+
+  // Sign-extends the raw bits of a signed signal; unsigned bits are returned as they are.
+  static inline int64_t ExtendRaw(uint64_t raw, const NewEagle::DbcSignalPlan &plan)
+  {
+    // Flipping the sign bit and subtracting it back borrows through the upper bits.
+    return plan.SignBit ? (int64_t)((raw ^ plan.SignBit) - plan.SignBit) : (int64_t)raw;
+  }
+
+  static inline double ScaleRaw(int64_t raw, const NewEagle::DbcSignalPlan &plan)
+  {
+    if (!plan.Valid)
     {
-      result = (double)(unsignedResult);
+      return std::numeric_limits<int>::quiet_NaN();
     }
 
-    if ((signal.GetGain() != 1) || (signal.GetOffset() != 0))
+    double result = plan.SignBit ? (double)raw : (double)(uint64_t)raw;
+
+    if (plan.Scaled)
     {
-      result *= signal.GetGain();
-      result += signal.GetOffset();
+      result *= plan.Gain;
+      result += plan.Offset;
     }
 
     return result;
   }
 
-  static void Pack(uint8_t * data, const NewEagle::DbcSignal &signal)
+  // Raw value of a signal, sign-extended but not scaled.  Classic frames only, see the
+  //  overload below for CAN FD.
+  static inline int64_t UnpackRaw(uint64_t intelWord, uint64_t motorolaWord, const NewEagle::DbcSignalPlan &plan)
   {
-    uint32_t result = 0;
+    if (!plan.Valid)
+    {
+      return 0;
+    }
 
-    double tmp = signal.GetResult();
+    return ExtendRaw(((plan.BigEndian ? motorolaWord : intelWord) >> plan.Shift) & plan.Mask, plan);
+  }
 
-    if ((signal.GetGain() != 1) || (signal.GetOffset() != 0))
+  // data is the whole payload; only CAN FD signals read it, the rest use the frame words.
+  static inline int64_t UnpackRaw(uint64_t intelWord, uint64_t motorolaWord, const uint8_t* data, const NewEagle::DbcSignalPlan &plan)
+  {
+    if (plan.Windowed && plan.Valid)
     {
-      tmp -= signal.GetOffset();
-      tmp /= signal.GetGain();
+      return ExtendRaw(LoadWindow(data, plan), plan);
     }
 
-    if (signal.GetSign() == NewEagle::SIGNED)
-    {
-      int32_t i = (int32_t)tmp;
-      uint32_t u = (uint)i;
+    return UnpackRaw(intelWord, motorolaWord, plan);
+  }
 
-      result = u;
+  static inline double Unpack(uint64_t intelWord, uint64_t motorolaWord, const NewEagle::DbcSignalPlan &plan)
+  {
+    return ScaleRaw(UnpackRaw(intelWord, motorolaWord, plan), plan);
+  }
+
+  static inline double Unpack(uint64_t intelWord, uint64_t motorolaWord, const uint8_t* data, const NewEagle::DbcSignalPlan &plan)
+  {
+    return ScaleRaw(UnpackRaw(intelWord, motorolaWord, data, plan), plan);
+  }
+
+  static inline double Unpack(const uint8_t* data, const NewEagle::DbcSignal &signal)
+  {
+    return Unpack(LoadFrameWord(data, false), LoadFrameWord(data, true), data, signal.GetPlan());
+  }
+
+  // Raw value a physical value encodes to.  The fraction is truncated, after
+  //  Codec::ScaledRaw, and NaN encodes as zero.
+  static inline int64_t ToRaw(double value, const NewEagle::DbcSignalPlan &plan)
+  {
+    if (value != value)
+    {
+      return 0;
     }
-    else
+
+    if (plan.Scaled)
     {
-      result = (uint)tmp;
+      value = Codec::ScaledRaw(value, plan.Gain, plan.Offset);
     }
 
-    int8_t wordSize = sizeof(data);
-    int8_t startBit = (int)signal.GetStartBit();
+    return plan.SignBit ? (int64_t)value : (int64_t)(uint64_t)value;
+  }
 
-    if (signal.GetEndianness() == NewEagle::LITTLE_END)
+  // CAN FD signals are written straight into data, the rest into the frame words.
+  static inline void PackRaw(uint64_t &intelWord, uint64_t &motorolaWord, uint8_t* data, const NewEagle::DbcSignalPlan &plan, int64_t raw)
+  {
+    if (!plan.Valid)
     {
-      startBit = ConvertToMTBitOrdering(signal.GetStartBit(), signal.GetDlc());
+      return;
     }
-    else
+
+    if (plan.Windowed)
+    {
+      StoreWindow(data, plan, (uint64_t)raw);
+      return;
+    }
+
+    uint64_t &word = plan.BigEndian ? motorolaWord : intelWord;
+    word &= ~(plan.Mask << plan.Shift);
+    word |= ((uint64_t)raw & plan.Mask) << plan.Shift;
+  }
+
+  static inline void Pack(uint64_t &intelWord, uint64_t &motorolaWord, uint8_t* data, const NewEagle::DbcSignalPlan &plan, double value)
+  {
+    if (!plan.Valid)
     {
-      startBit = ConvertToMTBitOrdering(signal.GetStartBit(), signal.GetDlc()) - ((int32_t)signal.GetLength() - 1);
+      return;
     }
 
-    int32_t bit = (int32_t)(startBit % 8);
+    PackRaw(intelWord, motorolaWord, data, plan, ToRaw(value, plan));
+  }
 
-    bool isExactlyByte = ((bit + signal.GetLength()) % 8 == 0);
-    uint32_t numBytes = (isExactlyByte ? 0 : 1) + ((bit + (int32_t)signal.GetLength()) / 8);
+  static inline void Pack(uint8_t* data, const NewEagle::DbcSignal &signal)
+  {
+    const NewEagle::DbcSignalPlan &plan = signal.GetPlan();
 
-    int32_t b = (int32_t)wordSize - ((int)startBit / 8) - 1;
-    int32_t w = (int)signal.GetLength();
-    int32_t maskShift = bit;
-    int32_t rightShift = 0;
+    uint64_t intelWord = LoadFrameWord(data, false);
+    uint64_t motorolaWord = LoadFrameWord(data, true);
 
-    uint8_t mask = 0xFF;
-    uint32_t extractedByte;
+    PackRaw(intelWord, motorolaWord, data, plan, signal.GetRaw());
 
-    for(int i = 0; i < numBytes; i++)
+    if (!plan.Windowed)
     {
-      if ((b < 0 || (b >= sizeof(data))))
-      {
-        return;
-      }
-
-      mask = 0xFF;
-
-      if (w < 8)
-      {
-        mask >>= (8 - w);
-      }
-
-      mask <<= maskShift;
-
-      extractedByte = (result >> (8 * i - rightShift)) & 0xFF;
-
-      data[b] = (uint32_t)(data[b] & ~mask);
-      data[b] |= (uint8_t)((extractedByte << maskShift) & mask);
-
-      if (signal.GetEndianness() == NewEagle::BIG_END)
-      {
-        if ((b % wordSize) == 0)
-        {
-          b += 2 * wordSize - 1;
-        }
-        else
-        {
-          b--;
-        }
-      }
-      else
-      {
-        b++;
-      }
-
-      w -= ( 8 - maskShift);
-      rightShift += maskShift;
-      maskShift = 0;
+      StoreFrameWord(data, plan.BigEndian ? motorolaWord : intelWord, plan.BigEndian);
     }
-
   }
-
 }
 
 #endif // _NEW_EAGLE_DBC_UTILITIES_H
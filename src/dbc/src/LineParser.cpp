@@ -34,49 +34,137 @@
  
 #include <dbc/LineParser.h>
 
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string.h>
+
 namespace NewEagle
 {
+  namespace
+  {
+    bool IsSpace(char c)
+    {
+      return ' ' == c || '\t' == c || '\r' == c || '\n' == c || '\v' == c || '\f' == c;
+    }
+
+    bool IsDigit(char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    bool IsIdentifierStart(char c)
+    {
+      return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || '_' == c;
+    }
+
+    // Powers of ten that are exact in a double.
+    const double EXACT_POWERS[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+  }
+
+  bool LineToken::Equals(const char* text) const
+  {
+    return 0 == strncmp(Data, text, Length) && '\0' == text[Length];
+  }
+
+  std::string LineToken::ToString() const
+  {
+    return std::string(Data, Length);
+  }
+
   LineParser::LineParser(const std::string &line)
   {
     _line = line;
+    _begin = _line.data();
+    _end = _begin + _line.size();
+    _position = 0;
+  }
+
+  LineParser::LineParser(const char* begin, const char* end)
+  {
+    _begin = begin;
+    _end = end;
     _position = 0;
   }
 
+  LineParser::LineParser(const LineParser &other)
+  {
+    *this = other;
+  }
+
   LineParser::~LineParser()
   {
   }
 
+  LineParser& LineParser::operator=(const LineParser &other)
+  {
+    _line = other._line;
+    _position = other._position;
+
+    // A parser over its own copy of the line must point at the new copy.
+    if (other._begin == other._line.data())
+    {
+      _begin = _line.data();
+      _end = _begin + _line.size();
+    }
+    else
+    {
+      _begin = other._begin;
+      _end = other._end;
+    }
+
+    return *this;
+  }
+
   int32_t LineParser::GetPosition()
   {
     return _position;
   }
 
-  std::string LineParser::ReadCIdentifier()
+  bool LineParser::TryReadCIdentifier(NewEagle::LineToken &token)
   {
     SkipWhitespace();
 
-    if (AtEOL())
-    {
-      throw LineParserAtEOLException();
-    }
-
-    if (!isalpha(_line[_position]) && _line[_position] != '_')
+    if (AtEOL() || !IsIdentifierStart(_begin[_position]))
     {
-      throw std::runtime_error("ReadCIdentifier: Unexpected character");
+      return false;
     }
 
     int32_t startIdx = _position;
 
     for(_position++; !AtEOL(); _position++)
     {
-      if (!(isalpha(_line[_position]) || isdigit(_line[_position])) && _line[_position] != '_')
+      if (!IsIdentifierStart(_begin[_position]) && !IsDigit(_begin[_position]))
       {
-        int32_t len = _position - startIdx;
-        return _line.substr(startIdx, len);
+        break;
       }
     }
 
-    return _line.substr(startIdx, std::string::npos);
+    token.Data = _begin + startIdx;
+    token.Length = _position - startIdx;
+
+    return true;
+  }
+
+  std::string LineParser::ReadCIdentifier()
+  {
+    SkipWhitespace();
+
+    if (AtEOL())
+    {
+      throw LineParserAtEOLException();
+    }
+
+    NewEagle::LineToken token;
+    if (!TryReadCIdentifier(token))
+    {
+      throw std::runtime_error("ReadCIdentifier: Unexpected character");
+    }
+
+    return token.ToString();
   }
 
   std::string LineParser::ReadCIdentifier(std::string fieldName)
@@ -94,7 +182,7 @@ namespace NewEagle
 
   void LineParser::SkipWhitespace()
   {
-    while(!AtEOL() && isspace(_line[_position]))
+    while(!AtEOL() && IsSpace(_begin[_position]))
     {
       _position++;
     }
@@ -102,75 +190,72 @@ namespace NewEagle
 
   bool LineParser::AtEOL()
   {
-    return _position >= _line.length();
+    return _begin + _position >= _end;
   }
 
-  char LineParser::ReadNextChar()
+  bool LineParser::TryReadNextChar(char &value)
   {
     SkipWhitespace();
 
     if (AtEOL())
     {
-      throw LineParserAtEOLException(); 
+      return false;
     }
 
-    int32_t idx = _position;
-    _position++;
-
-    return _line[idx];
+    value = _begin[_position++];
 
+    return true;
   }
 
-  char LineParser::ReadNextChar(std::string fieldName)
+  char LineParser::ReadNextChar()
   {
-    try
-    {
-      char val = ReadNextChar();
-      return val;
-    }
-    catch(LineParserExceptionBase& exlp)
+    char val;
+
+    if (!TryReadNextChar(val))
     {
-      throw;
+      throw LineParserAtEOLException(); 
     }
 
+    return val;
   }
 
-  uint32_t LineParser::PeekUInt()
+  char LineParser::ReadNextChar(std::string fieldName)
   {
-    SkipWhitespace();
-
-    if (AtEOL())
-    {
-      throw LineParserAtEOLException(); 
-    }
+    return ReadNextChar();
+  }
 
-    int32_t position = _position;
+  bool LineParser::TryReadUInt(uint32_t &value)
+  {
+    SkipWhitespace();
 
-    int32_t startIdx = position;
-    int32_t len = -1;
+    uint64_t val = 0;
+    int32_t startIdx = _position;
 
-    for(; !AtEOL(); position++)
+    for(; !AtEOL() && IsDigit(_begin[_position]); _position++)
     {
-      if (!isdigit(_line[position]))
+      // Saturates like the stream extraction it replaces.
+      val = val * 10 + (_begin[_position] - '0');
+      if (val > std::numeric_limits<uint32_t>::max())
       {
-        len = position - startIdx;
-        break;
+        val = std::numeric_limits<uint32_t>::max();
       }
     }
 
-    if (-1 == len)
+    if (_position == startIdx)
     {
-      len = position - startIdx;
+      return false;
     }
 
-    if (0 == len)
-    {
-      throw LineParserLenZeroException(); 
-    }
+    value = (uint32_t)val;
 
-    std::istringstream reader(_line.substr(startIdx, len));
-    uint32_t val;
-    reader >> val;
+    return true;
+  }
+
+  uint32_t LineParser::PeekUInt()
+  {
+    int32_t position = _position;
+    uint32_t val = ReadUInt();
+    _position = position;
 
     return val;
   }
@@ -184,93 +269,58 @@ namespace NewEagle
       throw LineParserAtEOLException(); 
     }
 
-    int32_t startIdx = _position;
-    int32_t len = -1;
-
-    for(; !AtEOL(); _position++)
-    {
-      if (!isdigit(_line[_position]))
-      {
-        len = _position - startIdx;
-        break;
-      }
-    }
-
-    if (-1 == len)
-    {
-      len = _position - startIdx;
-    }
-
-    if (0 == len)
+    uint32_t val;
+    if (!TryReadUInt(val))
     {
       throw LineParserLenZeroException(); 
     }
 
-    std::istringstream reader(_line.substr(startIdx, len));
-    uint32_t val;
-    reader >> val;
-
     return val;
   }
 
   uint32_t LineParser::ReadUInt(std::string fieldName)
   {
-    try
-    {
-      uint32_t val = ReadUInt();
-      return val;
-    }
-    catch(LineParserExceptionBase& exlp)
-    {
-      throw;
-    }
+    return ReadUInt();
   }
 
-  int32_t LineParser::ReadInt()
+  bool LineParser::TryReadInt(int32_t &value)
   {
     SkipWhitespace();
 
     if (AtEOL())
     {
-      throw LineParserAtEOLException(); 
+      return false;
     }
 
-    if (!isdigit(_line[_position]) && _line[_position] != '-' && _line[_position] != '+')
+    bool negative = false;
+    if ('-' == _begin[_position] || '+' == _begin[_position])
     {
-      throw LineParserInvalidCharException(); 
+      negative = '-' == _begin[_position];
+      _position++;
     }
 
-    int32_t startIdx = _position;
-    int32_t len = -1;
-
-    for(_position++; !AtEOL(); _position++)
+    uint32_t magnitude;
+    if (!TryReadUInt(magnitude))
     {
-      if (!isdigit(_line[_position]))
-      {
-        len = _position - startIdx;
-        break;
-      }
+      return false;
     }
 
-    if (-1 == len)
+    int64_t val = negative ? -(int64_t)magnitude : (int64_t)magnitude;
+    if (val > std::numeric_limits<int32_t>::max())
     {
-      len = _position - startIdx;
+      val = std::numeric_limits<int32_t>::max();
     }
-
-    if (0 == len)
+    else if (val < std::numeric_limits<int32_t>::min())
     {
-      throw LineParserLenZeroException(); 
+      val = std::numeric_limits<int32_t>::min();
     }
 
-    std::istringstream reader(_line.substr(startIdx, len));
-    int32_t val;
-    reader >> val;
-
-    return val;
+    value = (int32_t)val;
 
+    return true;
   }
 
-  double LineParser::ReadDouble()
+  int32_t LineParser::ReadInt()
   {
     SkipWhitespace();
 
@@ -279,106 +329,207 @@ namespace NewEagle
       throw LineParserAtEOLException(); 
     }
 
-    if (!isdigit(_line[_position]) && _line[_position] != '-' && _line[_position] != '+')
+    if (!IsDigit(_begin[_position]) && _begin[_position] != '-' && _begin[_position] != '+')
     {
       throw LineParserInvalidCharException(); 
     }
 
-    int32_t startIdx = _position;
-    int32_t len = -1;
+    int32_t val;
+    if (!TryReadInt(val))
+    {
+      throw LineParserLenZeroException(); 
+    }
+
+    return val;
+  }
+
+  // Length of the number at the current position: [sign] digits [. digits] [e [sign] digits].
+  size_t LineParser::ScanDouble()
+  {
+    const char* p = _begin + _position;
+    size_t digits = 0;
 
     NewEagle::ReadDoubleState state = NewEagle::READING_WHOLE_NUMBER;
 
-    for(_position++; !AtEOL(); _position++)
+    if (p < _end && ('-' == *p || '+' == *p))
+    {
+      p++;
+    }
+
+    for(; p < _end; p++)
     {
-      char c = _line[_position];
+      char c = *p;
 
       switch (state) {
         case NewEagle::READING_WHOLE_NUMBER:
-          if ('E' == c || 'e' == c)
+        case NewEagle::READING_FRACTION:
+          if (IsDigit(c))
           {
-            state = NewEagle::READ_E;
+            digits++;
+            continue;
           }
-          else if('.' == c)
+          if ('.' == c && NewEagle::READING_WHOLE_NUMBER == state)
           {
             state = NewEagle::READING_FRACTION;
+            continue;
           }
-          else if (!isdigit(c))
-          {
-            goto DoneReading;
-          }
-          break;
-        case NewEagle::READING_FRACTION:
-          if ('E' == c || 'e' == c)
+          if (('E' == c || 'e' == c) && digits > 0)
           {
             state = NewEagle::READ_E;
-          }
-          else if(!isdigit(c))
-          {
-            goto DoneReading;
+            continue;
           }
           break;
         case NewEagle::READ_E:
-          if ('+' == c || '-' == c)
-          {
-            state = NewEagle::READ_SIGN;
-          }
-          else if (isdigit(c))
-          {
-            state = NewEagle::READING_EXP;
-          }
-          break;
         case NewEagle::READ_SIGN:
-          if (!isdigit(c))
+          if (('+' == c || '-' == c) && NewEagle::READ_E == state)
           {
-            throw LineParserInvalidCharException();
+            state = NewEagle::READ_SIGN;
+            continue;
           }
-          else
+          // An exponent needs at least one digit.
+          if (!IsDigit(c))
           {
-            state = NewEagle::READING_EXP;
+            return 0;
           }
-
-          break;
+          state = NewEagle::READING_EXP;
+          continue;
         case NewEagle::READING_EXP:
-          if (!isdigit(c))
+          if (IsDigit(c))
           {
-            goto DoneReading;
+            continue;
           }
           break;
-        default:
-          break;
-
       }
 
+      break;
     }
 
-DoneReading:
-    len = _position - startIdx;
+    if (0 == digits || NewEagle::READ_E == state || NewEagle::READ_SIGN == state)
+    {
+      return 0;
+    }
+
+    return p - (_begin + _position);
+  }
 
+  bool LineParser::TryReadDouble(double &value)
+  {
+    SkipWhitespace();
+
+    size_t len = ScanDouble();
     if (0 == len)
     {
-      throw LineParserLenZeroException(); 
+      return false;
     }
 
-    std::istringstream reader(_line.substr(startIdx, len));
-    double val;
-    reader >> val;
+    const char* p = _begin + _position;
+    const char* end = p + len;
+    _position += len;
 
-    return val;
+    bool negative = ('-' == *p);
+    if ('-' == *p || '+' == *p)
+    {
+      p++;
+    }
 
+    // Most DBC numbers have a short mantissa and exponent, and for those one exact
+    //  multiply or divide is correctly rounded.  Anything else goes through the stream.
+    uint64_t mantissa = 0;
+    int32_t significant = 0;
+    int32_t exponent = 0;
+    bool fraction = false;
+
+    for(; p < end && ('.' == *p || IsDigit(*p)); p++)
+    {
+      if ('.' == *p)
+      {
+        fraction = true;
+        continue;
+      }
+
+      if (0 == mantissa && '0' == *p)
+      {
+        exponent -= fraction ? 1 : 0;
+        continue;
+      }
+
+      if (++significant > 15)
+      {
+        break;
+      }
+
+      mantissa = mantissa * 10 + (*p - '0');
+      exponent -= fraction ? 1 : 0;
+    }
+
+    if (p < end && ('e' == *p || 'E' == *p))
+    {
+      int32_t explicitExponent = 0;
+      bool negativeExponent = false;
+
+      for(p++; p < end; p++)
+      {
+        if ('-' == *p || '+' == *p)
+        {
+          negativeExponent = '-' == *p;
+        }
+        else if (explicitExponent < 1000)
+        {
+          explicitExponent = explicitExponent * 10 + (*p - '0');
+        }
+      }
+
+      exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    if (p == end && exponent >= -22 && exponent <= 22)
+    {
+      double val = (double)mantissa;
+      val = (exponent < 0) ? val / EXACT_POWERS[-exponent] : val * EXACT_POWERS[exponent];
+      value = negative ? -val : val;
+
+      return true;
+    }
+
+    std::istringstream reader(std::string(end - len, len));
+    reader >> value;
+
+    return true;
   }
 
-  double LineParser::ReadDouble(std::string fieldName)
+  double LineParser::ReadDouble()
   {
-    try
+    SkipWhitespace();
+
+    if (AtEOL())
     {
-      double val = ReadDouble();
+      throw LineParserAtEOLException(); 
     }
-    catch(LineParserExceptionBase& exlp)
+
+    if (!IsDigit(_begin[_position]) && _begin[_position] != '-' && _begin[_position] != '+')
     {
-      throw;
+      throw LineParserInvalidCharException(); 
     }
 
+    double val;
+    if (!TryReadDouble(val))
+    {
+      throw LineParserInvalidCharException();
+    }
+
+    return val;
+  }
+
+  double LineParser::ReadDouble(std::string fieldName)
+  {
+    return ReadDouble();
+  }
+
+  bool LineParser::TrySeekSeparator(char separator)
+  {
+    char nextChar;
+
+    return TryReadNextChar(nextChar) && nextChar == separator;
   }
 
   void LineParser::SeekSeparator(char separator)
@@ -387,47 +538,61 @@ DoneReading:
 
     if (nextChar == 0x00 || nextChar != separator)
     {
-      throw std::runtime_error("Synxax Error: Expected : " + separator);
+      throw std::runtime_error(std::string("Synxax Error: Expected : ") + separator);
     }
   }
 
-  std::string LineParser::ReadQuotedString()
+  bool LineParser::TryReadQuotedString(NewEagle::LineToken &token)
   {
     SkipWhitespace();
 
-    if (AtEOL())
+    if (AtEOL() || _begin[_position] != '"')
     {
-      throw LineParserAtEOLException(); 
-    }
-
-    if (_line[_position] != '"')
-    {
-      throw std::runtime_error("ReadQuotedString: Missing Quote");
+      return false;
     }
 
     int32_t startIdx = ++_position;
-    int32_t len  = -1;
 
-    for (; _position < _line.size(); _position++)
+    // Quotes inside the string are escaped with a backslash and kept as written.
+    for (; !AtEOL(); _position++)
     {
-      if (_line[_position] == '"')
+      if ('\\' == _begin[_position] && _begin + _position + 1 < _end)
       {
-        len = _position - startIdx;
         _position++;
-        break;
+      }
+      else if ('"' == _begin[_position])
+      {
+        token.Data = _begin + startIdx;
+        token.Length = _position - startIdx;
+        _position++;
+
+        return true;
       }
     }
 
-    if (-1 == len)
+    return false;
+  }
+
+  std::string LineParser::ReadQuotedString()
+  {
+    SkipWhitespace();
+
+    if (AtEOL())
     {
-      throw LineParserLenZeroException();
+      throw LineParserAtEOLException(); 
     }
 
-    if (0 == len)
+    if (_begin[_position] != '"')
+    {
+      throw std::runtime_error("ReadQuotedString: Missing Quote");
+    }
+
+    NewEagle::LineToken token;
+    if (!TryReadQuotedString(token) || 0 == token.Length)
     {
       throw LineParserLenZeroException(); 
     }
 
-    return _line.substr(startIdx, len);
+    return token.ToString();
   }
 }
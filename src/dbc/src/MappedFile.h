@@ -0,0 +1,112 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _NEW_EAGLE_MAPPED_FILE_H
+#define _NEW_EAGLE_MAPPED_FILE_H
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+namespace NewEagle
+{
+  // Read-only view of a whole file, unmapped when it goes out of scope.  GetData is
+  //  NULL when the file could not be opened, and also for an empty file.
+  class MappedFile
+  {
+    public:
+      MappedFile(const std::string &path, bool sequential) : _data(NULL), _size(0), _opened(false)
+      {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+          return;
+        }
+
+        struct stat info;
+        if (0 == fstat(fd, &info))
+        {
+          _opened = true;
+
+          if (info.st_size > 0)
+          {
+            void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (MAP_FAILED != data)
+            {
+              _data = (const char*)data;
+              _size = info.st_size;
+
+              // A parse reads front to back once, so let the kernel read ahead.
+              if (sequential)
+              {
+                madvise(data, _size, MADV_SEQUENTIAL);
+              }
+            }
+            else
+            {
+              _opened = false;
+            }
+          }
+        }
+
+        close(fd);
+      }
+
+      ~MappedFile()
+      {
+        if (NULL != _data)
+        {
+          munmap((void*)_data, _size);
+        }
+      }
+
+      bool IsOpen() const { return _opened; }
+      const char* GetData() const { return _data; }
+      size_t GetSize() const { return _size; }
+
+    private:
+      const char* _data;
+      size_t _size;
+      bool _opened;
+
+      MappedFile(const MappedFile &other);
+      MappedFile& operator=(const MappedFile &other);
+  };
+}
+
+#endif // _NEW_EAGLE_MAPPED_FILE_H
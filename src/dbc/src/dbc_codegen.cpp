@@ -0,0 +1,335 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// dbc_codegen <input.dbc> <output.h> <namespace>
+//
+// Writes a header with one plain struct per DBC message.  Each struct has a
+//  constexpr decode() and an inline encode() built from the same shift/mask
+//  plans DbcSignal uses at runtime, so nodes built against a fixed DBC get
+//  fully inlined codecs without maps or runtime parsing.
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dbc/Dbc.h>
+#include <dbc/DbcBuilder.h>
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+namespace
+{
+  std::string Hex(uint64_t value)
+  {
+    std::ostringstream out;
+    out << "0x" << std::hex << value << "ULL";
+    return out.str();
+  }
+
+  std::string Literal(double value)
+  {
+    std::ostringstream out;
+    out << std::setprecision(17) << value;
+
+    std::string text = out.str();
+    if (std::string::npos == text.find_first_of(".eEn"))
+    {
+      text += ".0";
+    }
+
+    return text;
+  }
+
+  bool IsInteger(const NewEagle::DbcSignal &signal)
+  {
+    return !signal.GetPlan().Scaled;
+  }
+
+  std::string FieldType(const NewEagle::DbcSignal &signal)
+  {
+    if (!IsInteger(signal))
+    {
+      return "double";
+    }
+
+    uint8_t length = signal.GetLength();
+    std::string base = (NewEagle::SIGNED == signal.GetSign()) ? "int" : "uint";
+
+    if (length <= 8) return base + "8_t";
+    if (length <= 16) return base + "16_t";
+    if (length <= 32) return base + "32_t";
+    return base + "64_t";
+  }
+
+  // Expression for the signal's value, in terms of the frame pointer `data`.
+  std::string DecodeExpression(const NewEagle::DbcSignal &signal)
+  {
+    const NewEagle::DbcSignalPlan &plan = signal.GetPlan();
+
+    std::ostringstream raw;
+    raw << "NewEagle::Codec::Extract(NewEagle::Codec::" << (plan.BigEndian ? "LoadMotorola" : "LoadIntel")
+      << "(data" << (plan.Window ? " + " + std::to_string(plan.Window) : "") << "), " << (int)plan.Shift << ", " << Hex(plan.Mask) << ")";
+
+    std::string value = raw.str();
+    if (plan.SignBit)
+    {
+      value = "NewEagle::Codec::SignExtend(" + value + ", " + Hex(plan.SignBit) + ")";
+    }
+
+    if (IsInteger(signal))
+    {
+      return "(" + FieldType(signal) + ")" + value;
+    }
+
+    return "(double)" + value + " * " + Literal(plan.Gain) + " + " + Literal(plan.Offset);
+  }
+
+  std::string EncodeExpression(const NewEagle::DbcSignal &signal)
+  {
+    const NewEagle::DbcSignalPlan &plan = signal.GetPlan();
+
+    if (IsInteger(signal))
+    {
+      return "(uint64_t)" + signal.GetName();
+    }
+
+    return "(uint64_t)(int64_t)NewEagle::Codec::ScaledRaw(" + signal.GetName() + ", " + Literal(plan.Gain) + ", " + Literal(plan.Offset) + ")";
+  }
+
+  void WriteMessage(std::ostream &out, NewEagle::DbcMessage &message)
+  {
+    std::vector<const NewEagle::DbcSignal*> signals;
+    const NewEagle::DbcSignal* muxSwitch = NULL;
+
+    std::map<std::string, NewEagle::DbcSignal>* all = message.GetSignals();
+    for (std::map<std::string, NewEagle::DbcSignal>::const_iterator it = all->begin(); it != all->end(); it++)
+    {
+      if (!it->second.GetPlan().Valid)
+      {
+        fprintf(stderr, "dbc_codegen: skipping %s.%s, it does not fit in the frame\n",
+          message.GetName().c_str(), it->second.GetName().c_str());
+        continue;
+      }
+
+      if (it->second.GetPlan().Wide)
+      {
+        fprintf(stderr, "dbc_codegen: skipping %s.%s, it spans 9 bytes\n",
+          message.GetName().c_str(), it->second.GetName().c_str());
+        continue;
+      }
+
+      signals.push_back(&it->second);
+
+      if (NewEagle::MUX_SWITCH == it->second.GetMultiplexerMode())
+      {
+        muxSwitch = &it->second;
+      }
+    }
+
+    const std::string name = message.GetName();
+
+    out << "  struct " << name << "\n";
+    out << "  {\n";
+    out << "    static const uint32_t ID = 0x" << std::hex << message.GetId() << std::dec << ";\n";
+    out << "    static const bool EXTENDED = " << (NewEagle::EXT == message.GetIdType() ? "true" : "false") << ";\n";
+    out << "    static const uint8_t DLC = " << (int)message.GetDlc() << ";\n";
+
+    if (!signals.empty())
+    {
+      out << "\n";
+    }
+
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+      out << "    " << FieldType(*signals[i]) << " " << signals[i]->GetName() << ";\n";
+    }
+
+    // Multiplexed signals are only decoded, and only encoded, when the switch selects their page.
+    out << "\n";
+    // A message without signals never reads the payload, so leave the parameter unnamed.
+    out << "    static constexpr " << name << " decode(const uint8_t*" << (signals.empty() ? "" : " data") << ")\n";
+    out << "    {\n";
+    out << "      return " << name << " {";
+
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+      const NewEagle::DbcSignal &signal = *signals[i];
+
+      out << (i ? ",\n" : "\n") << "        ";
+
+      if (NULL != muxSwitch && NewEagle::MUX_SIGNAL == signal.GetMultiplexerMode())
+      {
+        out << "(" << DecodeExpression(*muxSwitch) << " == " << signal.GetMultiplexerSwitch() << ") ? "
+          << "(" << FieldType(signal) << ")(" << DecodeExpression(signal) << ") : (" << FieldType(signal) << ")0";
+      }
+      else
+      {
+        out << DecodeExpression(signal);
+      }
+    }
+
+    out << (signals.empty() ? "" : "\n      ") << "};\n";
+    out << "    }\n";
+    out << "\n";
+    // CAN FD payloads are written one signal window at a time instead of through two words.
+    bool windowed = message.GetDlc() > 8;
+
+    out << "    void encode(uint8_t* data) const\n";
+    out << "    {\n";
+    if (windowed)
+    {
+      out << "      for (uint8_t i = 0; i < DLC; i++) data[i] = 0;\n";
+    }
+    else
+    {
+      out << "      uint64_t intelWord = 0;\n";
+      out << "      uint64_t motorolaWord = 0;\n";
+    }
+
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+      const NewEagle::DbcSignal &signal = *signals[i];
+      const NewEagle::DbcSignalPlan &plan = signal.GetPlan();
+
+      std::ostringstream insert;
+      if (windowed)
+      {
+        insert << "NewEagle::Codec::InsertWindow(data, " << (int)plan.Window << ", " << (plan.BigEndian ? "true" : "false") << ", "
+          << (int)plan.Shift << ", " << Hex(plan.Mask) << ", " << EncodeExpression(signal) << ");\n";
+      }
+      else
+      {
+        insert << "NewEagle::Codec::Insert(" << (plan.BigEndian ? "motorolaWord" : "intelWord") << ", "
+          << (int)plan.Shift << ", " << Hex(plan.Mask) << ", " << EncodeExpression(signal) << ");\n";
+      }
+
+      if (NULL != muxSwitch && NewEagle::MUX_SIGNAL == signal.GetMultiplexerMode())
+      {
+        out << "      if (" << muxSwitch->GetName() << " == " << signal.GetMultiplexerSwitch() << ") "
+          << insert.str();
+      }
+      else
+      {
+        out << "      " << insert.str();
+      }
+    }
+
+    if (!windowed)
+    {
+      out << "      NewEagle::Codec::Store(data, intelWord, motorolaWord);\n";
+    }
+    out << "    }\n";
+    out << "  };\n";
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 4)
+  {
+    fprintf(stderr, "usage: dbc_codegen <input.dbc> <output.h> <namespace>\n");
+    return 1;
+  }
+
+  std::ifstream input(argv[1]);
+  if (!input)
+  {
+    fprintf(stderr, "dbc_codegen: cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  std::stringstream contents;
+  contents << input.rdbuf();
+
+  NewEagle::Dbc dbc = NewEagle::DbcBuilder().NewDbc(contents.str());
+
+  std::string inputName = argv[1];
+  size_t slash = inputName.find_last_of('/');
+  if (std::string::npos != slash)
+  {
+    inputName = inputName.substr(slash + 1);
+  }
+
+  std::string guard = "_DBC_CODEGEN_" + std::string(argv[3]) + "_H";
+  for (size_t i = 0; i < guard.size(); i++)
+  {
+    guard[i] = isalnum((unsigned char)guard[i]) ? toupper((unsigned char)guard[i]) : '_';
+  }
+
+  std::ostringstream out;
+  out << "// Generated by dbc_codegen from " << inputName << ".  Do not edit.\n";
+  out << "\n";
+  out << "#ifndef " << guard << "\n";
+  out << "#define " << guard << "\n";
+  out << "\n";
+  out << "#include <stdint.h>\n";
+  out << "\n";
+  out << "#include <dbc/DbcCodec.h>\n";
+  out << "\n";
+  out << "namespace " << argv[3] << "\n";
+  out << "{\n";
+
+  std::map<std::string, NewEagle::DbcMessage>* messages = dbc.GetMessages();
+  for (std::map<std::string, NewEagle::DbcMessage>::iterator it = messages->begin(); it != messages->end(); it++)
+  {
+    if (it != messages->begin())
+    {
+      out << "\n";
+    }
+
+    WriteMessage(out, it->second);
+  }
+
+  out << "}\n";
+  out << "\n";
+  out << "#endif // " << guard << "\n";
+
+  // Always written, even when unchanged.  The build reruns this while the output is
+  //  older than the DBC or the generator, so skipping the write would rerun it every build.
+  std::ofstream output(argv[2]);
+  output << out.str();
+
+  if (!output)
+  {
+    fprintf(stderr, "dbc_codegen: cannot write %s\n", argv[2]);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Times DbcBuilder::NewDbc on generated DBC files of growing size.  Load time per
+//  signal should stay flat as the file grows.  Then times NewDbcFromFiles on a set of
+//  files with 1, 2, 4 ... threads up to the core count, for the parallel speedup.
+//  Usage: bench_dbc_builder [max signals]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ros/ros.h>
+
+#include <dbc/DbcBuilder.h>
+
+namespace
+{
+  const uint32_t SIGNALS_PER_MESSAGE = 16;
+  const uint32_t MERGE_FILES = 16;
+  const uint32_t MERGE_MESSAGES_PER_FILE = 1280;
+
+  // Every signal gets a comment, a start value and a value type, so the statements
+  //  that look messages up by ID are as numerous as the signals themselves.
+  std::string GenerateDbc(uint32_t messageCount, uint32_t firstMessage = 0)
+  {
+    std::ostringstream dbc;
+    std::ostringstream tail;
+
+    dbc << "VERSION \"\"\n\nNS_ :\n\tCM_\n\tBA_\n\nBU_: Node\n\n";
+
+    for (uint32_t m = firstMessage; m < firstMessage + messageCount; m++)
+    {
+      uint32_t rawId = 0x80000000u | m;
+      dbc << "BO_ " << rawId << " Message_" << m << ": 8 Node\n";
+      tail << "CM_ BO_ " << rawId << " \"Message " << m << "\";\n";
+
+      for (uint32_t s = 0; s < SIGNALS_PER_MESSAGE; s++)
+      {
+        dbc << " SG_ Signal_" << s << " : " << (s * 4) << "|4@1+ (0.5,-1.25) [-1.25|6.25] \"unit\" Node\n";
+        tail << "CM_ SG_ " << rawId << " Signal_" << s << " \"Signal " << s << " of message " << m << "\";\n";
+        tail << "BA_ \"GenSigStartValue\" SG_ " << rawId << " Signal_" << s << " 3;\n";
+        tail << "SIG_VALTYPE_ " << rawId << " Signal_" << s << " : 2;\n";
+      }
+
+      dbc << "\n";
+    }
+
+    return dbc.str() + tail.str();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t maxSignals = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+
+  // Keep the per-file summary out of the timing output.
+  if (ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Warn))
+  {
+    ros::console::notifyLoggerLevelsChanged();
+  }
+
+  printf("%10s %10s %12s %12s\n", "signals", "bytes", "ms", "ns/signal");
+
+  for (uint32_t messages = 640; messages * SIGNALS_PER_MESSAGE <= maxSignals; messages *= 2)
+  {
+    std::string contents = GenerateDbc(messages);
+    uint32_t signals = messages * SIGNALS_PER_MESSAGE;
+
+    ros::WallTime start = ros::WallTime::now();
+
+    NewEagle::DbcBuilder builder;
+    NewEagle::Dbc dbc = builder.NewDbc(contents);
+
+    double seconds = (ros::WallTime::now() - start).toSec();
+
+    if (dbc.GetMessageCount() != messages)
+    {
+      fprintf(stderr, "expected %u messages, parsed %u\n", messages, (uint32_t)dbc.GetMessageCount());
+      return 1;
+    }
+
+    printf("%10u %10u %12.2f %12.1f\n", signals, (uint32_t)contents.size(), seconds * 1e3, seconds * 1e9 / signals);
+  }
+
+  // Files with disjoint IDs and names, so the merge keeps every message.
+  char directory[] = "/tmp/bench_dbc_builder_XXXXXX";
+  if (NULL == mkdtemp(directory))
+  {
+    perror("mkdtemp");
+    return 1;
+  }
+
+  std::vector<std::string> paths;
+  for (uint32_t f = 0; f < MERGE_FILES; f++)
+  {
+    std::ostringstream path;
+    path << directory << "/file_" << f << ".dbc";
+    paths.push_back(path.str());
+
+    std::string contents = GenerateDbc(MERGE_MESSAGES_PER_FILE, f * MERGE_MESSAGES_PER_FILE);
+    FILE* file = fopen(paths.back().c_str(), "wb");
+    if (NULL == file || contents.size() != fwrite(contents.data(), 1, contents.size(), file) || 0 != fclose(file))
+    {
+      perror(paths.back().c_str());
+      return 1;
+    }
+  }
+
+  uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+  printf("\n%u files of %u signals, %u cores\n", MERGE_FILES, MERGE_MESSAGES_PER_FILE * SIGNALS_PER_MESSAGE, cores);
+  printf("%10s %12s %12s\n", "threads", "ms", "speedup");
+
+  double single = 0;
+  for (uint32_t threads = 1; ; threads = std::min(threads * 2, cores))
+  {
+    ros::WallTime start = ros::WallTime::now();
+
+    NewEagle::DbcMergeReport report;
+    NewEagle::Dbc dbc = NewEagle::DbcBuilder().NewDbcFromFiles(paths, report, threads);
+
+    double seconds = (ros::WallTime::now() - start).toSec();
+    single = (1 == threads) ? seconds : single;
+
+    if (dbc.GetMessageCount() != MERGE_FILES * MERGE_MESSAGES_PER_FILE || !report.Collisions.empty())
+    {
+      fprintf(stderr, "merge kept %u messages with %u collisions\n", (uint32_t)dbc.GetMessageCount(), (uint32_t)report.Collisions.size());
+      return 1;
+    }
+
+    printf("%10u %12.2f %12.2f\n", threads, seconds * 1e3, single / seconds);
+
+    if (threads >= cores)
+    {
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < paths.size(); i++)
+  {
+    unlink(paths[i].c_str());
+  }
+  rmdir(directory);
+
+  return 0;
+}
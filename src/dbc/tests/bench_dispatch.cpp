@@ -0,0 +1,277 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+
+// Times DbwNode's report dispatch on New_Eagle_DBW_3.1.292.dbc: the switch on the CAN ID
+//  that recvCAN used to run, against the route table indexed by id - ID_REPORT_FIRST that
+//  replaced it.  Each report handler decodes its frame as DbwNode does, so the mixes with
+//  reports in them show how much of a frame's cost is left in the dispatch.
+//  Usage: bench_dispatch [dbc file]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include <ros/ros.h>
+
+#include <dbc/DbcBuilder.h>
+#include <dbw_pacifica_can/dispatch.h>
+
+using namespace dbw_pacifica_can;
+
+namespace
+{
+  const uint32_t TRAFFIC_FRAMES = 4096;
+  const uint32_t PASSES = 2000;
+
+  const uint32_t REPORT_IDS[] =
+  {
+    ID_BRAKE_REPORT, ID_ACCEL_PEDAL_REPORT, ID_STEERING_REPORT, ID_GEAR_REPORT,
+    ID_REPORT_WHEEL_SPEED, ID_REPORT_WHEEL_POSITION, ID_REPORT_TIRE_PRESSURE,
+    ID_REPORT_SURROUND, ID_VIN, ID_REPORT_IMU, ID_REPORT_DRIVER_INPUT, ID_MISC_REPORT,
+    ID_LOW_VOLTAGE_SYSTEM_REPORT, ID_BRAKE_2_REPORT, ID_STEERING_2_REPORT,
+  };
+  const uint32_t REPORT_COUNT = sizeof(REPORT_IDS) / sizeof(REPORT_IDS[0]);
+
+  // Stands in for DbwNode: the report messages, the RX thread's DecodedFrame, and a sum
+  //  of what the handlers decoded so none of it is optimized away.
+  struct Node
+  {
+    const NewEagle::DbcMessage* messages[ID_REPORT_COUNT];
+    NewEagle::DecodedFrame frame;
+    double sink;
+
+    const NewEagle::DbcMessage* Message(uint32_t id) const
+    {
+      return messages[id - ID_REPORT_FIRST];
+    }
+  };
+
+  // One handler per report, like recvBrakeReport through recvSteering2Report.
+  template <uint32_t Id>
+  void Handle(Node &node, const can_msgs::Frame &msg)
+  {
+    node.Message(Id)->Decode(msg, node.frame);
+    node.sink += node.frame.Values[0];
+  }
+
+  typedef void (*ReportHandler)(Node &node, const can_msgs::Frame &msg);
+
+  struct ReportRoute
+  {
+    ReportHandler handler;
+    uint8_t minDlc;
+  };
+
+  // The recvCAN switch before the route table: one case per report, each checking the DLC.
+#define DISPATCH_CASE(id, minDlc) \
+      case id: \
+        if (msg.dlc >= (minDlc)) { \
+          Handle<id>(node, msg); \
+        } \
+        break;
+
+  void DispatchSwitch(Node &node, const can_msgs::Frame &msg)
+  {
+    if (!msg.is_rtr && !msg.is_error)
+    {
+      switch (msg.id)
+      {
+        DISPATCH_CASE(ID_BRAKE_REPORT, node.Message(ID_BRAKE_REPORT)->GetDlc())
+        DISPATCH_CASE(ID_ACCEL_PEDAL_REPORT, node.Message(ID_ACCEL_PEDAL_REPORT)->GetDlc())
+        DISPATCH_CASE(ID_STEERING_REPORT, node.Message(ID_STEERING_REPORT)->GetDlc())
+        DISPATCH_CASE(ID_GEAR_REPORT, 1)
+        DISPATCH_CASE(ID_REPORT_WHEEL_SPEED, node.Message(ID_REPORT_WHEEL_SPEED)->GetDlc())
+        DISPATCH_CASE(ID_REPORT_WHEEL_POSITION, node.Message(ID_REPORT_WHEEL_POSITION)->GetDlc())
+        DISPATCH_CASE(ID_REPORT_TIRE_PRESSURE, node.Message(ID_REPORT_TIRE_PRESSURE)->GetDlc())
+        DISPATCH_CASE(ID_REPORT_SURROUND, node.Message(ID_REPORT_SURROUND)->GetDlc())
+        DISPATCH_CASE(ID_VIN, node.Message(ID_VIN)->GetDlc())
+        DISPATCH_CASE(ID_REPORT_IMU, node.Message(ID_REPORT_IMU)->GetDlc())
+        DISPATCH_CASE(ID_REPORT_DRIVER_INPUT, node.Message(ID_REPORT_DRIVER_INPUT)->GetDlc())
+        DISPATCH_CASE(ID_MISC_REPORT, node.Message(ID_MISC_REPORT)->GetDlc())
+        DISPATCH_CASE(ID_LOW_VOLTAGE_SYSTEM_REPORT, node.Message(ID_LOW_VOLTAGE_SYSTEM_REPORT)->GetDlc())
+        DISPATCH_CASE(ID_BRAKE_2_REPORT, node.Message(ID_BRAKE_2_REPORT)->GetDlc())
+        DISPATCH_CASE(ID_STEERING_2_REPORT, node.Message(ID_STEERING_2_REPORT)->GetDlc())
+      }
+    }
+  }
+
+#undef DISPATCH_CASE
+
+  // The route table, built the way DbwNode::loadDbc builds it.
+  struct RouteTable
+  {
+    ReportRoute routes[ID_REPORT_COUNT];
+
+    void Set(uint32_t id, ReportHandler handler, uint8_t minDlc)
+    {
+      routes[id - ID_REPORT_FIRST].handler = handler;
+      routes[id - ID_REPORT_FIRST].minDlc = minDlc;
+    }
+
+    explicit RouteTable(const Node &node)
+    {
+      for (int i = 0; i < ID_REPORT_COUNT; i++)
+      {
+        Set(ID_REPORT_FIRST + i, NULL, 0);
+      }
+
+      Set(ID_BRAKE_REPORT, &Handle<ID_BRAKE_REPORT>, node.Message(ID_BRAKE_REPORT)->GetDlc());
+      Set(ID_ACCEL_PEDAL_REPORT, &Handle<ID_ACCEL_PEDAL_REPORT>, node.Message(ID_ACCEL_PEDAL_REPORT)->GetDlc());
+      Set(ID_STEERING_REPORT, &Handle<ID_STEERING_REPORT>, node.Message(ID_STEERING_REPORT)->GetDlc());
+      Set(ID_GEAR_REPORT, &Handle<ID_GEAR_REPORT>, 1);
+      Set(ID_REPORT_WHEEL_SPEED, &Handle<ID_REPORT_WHEEL_SPEED>, node.Message(ID_REPORT_WHEEL_SPEED)->GetDlc());
+      Set(ID_REPORT_WHEEL_POSITION, &Handle<ID_REPORT_WHEEL_POSITION>, node.Message(ID_REPORT_WHEEL_POSITION)->GetDlc());
+      Set(ID_REPORT_TIRE_PRESSURE, &Handle<ID_REPORT_TIRE_PRESSURE>, node.Message(ID_REPORT_TIRE_PRESSURE)->GetDlc());
+      Set(ID_REPORT_SURROUND, &Handle<ID_REPORT_SURROUND>, node.Message(ID_REPORT_SURROUND)->GetDlc());
+      Set(ID_VIN, &Handle<ID_VIN>, node.Message(ID_VIN)->GetDlc());
+      Set(ID_REPORT_IMU, &Handle<ID_REPORT_IMU>, node.Message(ID_REPORT_IMU)->GetDlc());
+      Set(ID_REPORT_DRIVER_INPUT, &Handle<ID_REPORT_DRIVER_INPUT>, node.Message(ID_REPORT_DRIVER_INPUT)->GetDlc());
+      Set(ID_MISC_REPORT, &Handle<ID_MISC_REPORT>, node.Message(ID_MISC_REPORT)->GetDlc());
+      Set(ID_LOW_VOLTAGE_SYSTEM_REPORT, &Handle<ID_LOW_VOLTAGE_SYSTEM_REPORT>, node.Message(ID_LOW_VOLTAGE_SYSTEM_REPORT)->GetDlc());
+      Set(ID_BRAKE_2_REPORT, &Handle<ID_BRAKE_2_REPORT>, node.Message(ID_BRAKE_2_REPORT)->GetDlc());
+      Set(ID_STEERING_2_REPORT, &Handle<ID_STEERING_2_REPORT>, node.Message(ID_STEERING_2_REPORT)->GetDlc());
+    }
+
+    void Dispatch(Node &node, const can_msgs::Frame &msg) const
+    {
+      uint32_t slot = msg.id - ID_REPORT_FIRST;
+
+      if (!msg.is_rtr && !msg.is_error && slot < ID_REPORT_COUNT)
+      {
+        const ReportRoute &route = routes[slot];
+
+        if (NULL != route.handler && msg.dlc >= route.minDlc)
+        {
+          route.handler(node, msg);
+        }
+      }
+    }
+  };
+
+  // Frames in a fixed pseudo-random order, reportsPerFour in every four of them DBW reports.
+  //  The rest are other bus traffic: standard IDs, a J1939 ID and another node's commands.
+  std::vector<can_msgs::Frame> Traffic(uint32_t reportsPerFour)
+  {
+    const uint32_t otherIds[] = { 0x0C4, 0x1A0, 0x3E9, 0x52A, 0x7DF, ID_BRAKE_CMD, ID_STEERING_CMD, 0x18FEF100 };
+    const uint32_t otherCount = sizeof(otherIds) / sizeof(otherIds[0]);
+
+    std::vector<can_msgs::Frame> frames(TRAFFIC_FRAMES);
+    uint32_t seed = 12345;
+
+    for (uint32_t i = 0; i < TRAFFIC_FRAMES; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      uint32_t pick = seed >> 16;
+
+      can_msgs::Frame &frame = frames[i];
+      frame.id = ((pick & 3) < reportsPerFour) ? REPORT_IDS[(pick >> 2) % REPORT_COUNT] : otherIds[(pick >> 2) % otherCount];
+      frame.is_extended = true;
+      frame.dlc = 8;
+
+      for (size_t b = 0; b < 8; b++)
+      {
+        seed = seed * 1103515245 + 12345;
+        frame.data[b] = (uint8_t)(seed >> 24);
+      }
+    }
+
+    return frames;
+  }
+
+  template <class Dispatch>
+  double NsPerFrame(Node &node, const std::vector<can_msgs::Frame> &frames, Dispatch dispatch)
+  {
+    ros::WallTime start = ros::WallTime::now();
+
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+      for (size_t i = 0; i < frames.size(); i++)
+      {
+        dispatch(node, frames[i]);
+      }
+    }
+
+    return (ros::WallTime::now() - start).toSec() * 1e9 / ((double)PASSES * frames.size());
+  }
+}
+
+int main(int argc, char** argv)
+{
+  std::string path = (argc > 1) ? argv[1] : DBW_DBC;
+
+  if (ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Warn))
+  {
+    ros::console::notifyLoggerLevelsChanged();
+  }
+
+  NewEagle::Dbc dbc = NewEagle::DbcBuilder().NewDbcFromFile(path);
+
+  Node node;
+  node.sink = 0;
+  for (int i = 0; i < ID_REPORT_COUNT; i++)
+  {
+    node.messages[i] = dbc.GetMessageById(ID_REPORT_FIRST + i);
+  }
+  for (uint32_t i = 0; i < REPORT_COUNT; i++)
+  {
+    if (NULL == node.Message(REPORT_IDS[i]))
+    {
+      fprintf(stderr, "%s has no message 0x%X\n", path.c_str(), REPORT_IDS[i]);
+      return 1;
+    }
+  }
+
+  RouteTable table(node);
+
+  printf("%-10s %12s %12s\n", "reports", "switch ns", "table ns");
+
+  for (int reportsPerFour = 4; reportsPerFour >= 0; reportsPerFour -= 2)
+  {
+    std::vector<can_msgs::Frame> frames = Traffic(reportsPerFour);
+
+    double switchNs = NsPerFrame(node, frames, DispatchSwitch);
+    double tableNs = NsPerFrame(node, frames,
+      [&table](Node &n, const can_msgs::Frame &msg) { table.Dispatch(n, msg); });
+
+    printf("%9d%% %12.2f %12.2f\n", reportsPerFour * 25, switchNs, tableNs);
+  }
+
+  // Keeps the decodes live.
+  fprintf(stderr, "%g\n", node.sink);
+
+  return 0;
+}
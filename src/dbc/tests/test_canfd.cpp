@@ -0,0 +1,252 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks CAN FD payloads and 64-bit signals against a bit-by-bit reference decoder.
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <dbc/Dbc.h>
+#include <dbc/DbcBuilder.h>
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+namespace
+{
+  const char* TEST_DBC =
+    "BO_ 2566834709 FdFrame: 64 Node\n"
+    " SG_ Mode M : 0|4@1+ (1,0) [0|15] \"\" Node\n"
+    " SG_ IntelMid : 70|20@1- (1,0) [0|0] \"\" Node\n"
+    " SG_ MotorolaMid : 100|24@0+ (1,0) [0|0] \"\" Node\n"
+    " SG_ Intel64 : 128|64@1+ (1,0) [0|0] \"\" Node\n"
+    " SG_ Motorola64 : 199|64@0- (1,0) [0|0] \"\" Node\n"
+    " SG_ IntelWide : 262|60@1+ (1,0) [0|0] \"\" Node\n"
+    " SG_ MotorolaWide : 354|62@0- (1,0) [0|0] \"\" Node\n"
+    " SG_ Page1 m1 : 432|16@1+ (1,0) [0|0] \"\" Node\n"
+    " SG_ Page2 m2 : 432|12@1- (1,0) [0|0] \"\" Node\n"
+    " SG_ MotorolaTail : 487|8@0+ (1,0) [0|0] \"\" Node\n"
+    " SG_ IntelTail : 504|8@1+ (0.5,-10) [0|0] \"\" Node\n";
+
+  NewEagle::Dbc TestDbc()
+  {
+    return NewEagle::DbcBuilder().NewDbc(TEST_DBC);
+  }
+
+  uint8_t Bit(const uint8_t* data, int32_t bit)
+  {
+    return (data[bit / 8] >> (bit % 8)) & 1;
+  }
+
+  // Walks the signal one bit at a time, following the DBC bit numbering directly.
+  uint64_t ReferenceRaw(const uint8_t* data, const NewEagle::DbcSignal &signal)
+  {
+    uint64_t raw = 0;
+    int32_t bit = signal.GetStartBit();
+
+    if (NewEagle::LITTLE_END == signal.GetEndianness())
+    {
+      for (int32_t i = 0; i < signal.GetLength(); i++)
+      {
+        raw |= (uint64_t)Bit(data, bit + i) << i;
+      }
+    }
+    else
+    {
+      for (int32_t i = signal.GetLength() - 1; i >= 0; i--)
+      {
+        raw |= (uint64_t)Bit(data, bit) << i;
+        bit = (0 == bit % 8) ? bit + 15 : bit - 1;
+      }
+    }
+
+    return raw;
+  }
+
+  double ReferenceValue(const uint8_t* data, const NewEagle::DbcSignal &signal)
+  {
+    uint64_t raw = ReferenceRaw(data, signal);
+    double value = (double)raw;
+
+    if (NewEagle::SIGNED == signal.GetSign())
+    {
+      uint64_t signBit = (uint64_t)1 << (signal.GetLength() - 1);
+      value = (double)(int64_t)((raw ^ signBit) - signBit);
+    }
+
+    return value * signal.GetGain() + signal.GetOffset();
+  }
+
+  void RandomPayload(uint8_t* data)
+  {
+    for (int i = 0; i < NewEagle::MAX_PAYLOAD_SIZE; i++)
+    {
+      data[i] = (uint8_t)rand();
+    }
+  }
+}
+
+TEST(CanFd, ParsesPayloadSize)
+{
+  NewEagle::Dbc dbc = TestDbc();
+  NewEagle::DbcMessage* message = dbc.ResolveMessage("FdFrame");
+
+  EXPECT_EQ(64, message->GetDlc());
+  EXPECT_EQ(11u, message->GetSignalCount());
+  EXPECT_TRUE(message->GetSignal("IntelWide")->GetPlan().Wide);
+  EXPECT_TRUE(message->GetSignal("MotorolaWide")->GetPlan().Wide);
+  EXPECT_FALSE(message->GetSignal("Intel64")->GetPlan().Wide);
+
+  std::map<std::string, NewEagle::DbcSignal>* signals = message->GetSignals();
+  for (std::map<std::string, NewEagle::DbcSignal>::iterator it = signals->begin(); it != signals->end(); it++)
+  {
+    EXPECT_TRUE(it->second.GetPlan().Valid) << it->first;
+    EXPECT_TRUE(it->second.GetPlan().Windowed) << it->first;
+  }
+}
+
+TEST(CanFd, DecodeMatchesReference)
+{
+  NewEagle::Dbc dbc = TestDbc();
+  const NewEagle::DbcMessage* message = dbc.ResolveMessage("FdFrame");
+  const std::map<std::string, NewEagle::DbcSignal>* signals = message->GetSignals();
+
+  NewEagle::DecodedFrame frame;
+  uint8_t data[NewEagle::MAX_PAYLOAD_SIZE];
+
+  srand(17);
+  for (int n = 0; n < 500; n++)
+  {
+    RandomPayload(data);
+    message->Decode(data, frame);
+
+    double page = ReferenceValue(data, signals->find("Mode")->second);
+
+    for (std::map<std::string, NewEagle::DbcSignal>::const_iterator it = signals->begin(); it != signals->end(); it++)
+    {
+      if (NewEagle::MUX_SIGNAL == it->second.GetMultiplexerMode() && page != it->second.GetMultiplexerSwitch())
+      {
+        continue;
+      }
+
+      EXPECT_EQ(ReferenceValue(data, it->second), frame.GetValue(&it->second)) << it->first;
+    }
+  }
+}
+
+TEST(CanFd, SetFrameMatchesDecode)
+{
+  for (int lazy = 0; lazy < 2; lazy++)
+  {
+    NewEagle::Dbc dbc = TestDbc();
+    NewEagle::DbcMessage* message = dbc.ResolveMessage("FdFrame");
+    message->SetLazyDecode(lazy != 0);
+
+    NewEagle::DecodedFrame frame;
+    uint8_t data[NewEagle::MAX_PAYLOAD_SIZE];
+
+    srand(19);
+    for (int n = 0; n < 200; n++)
+    {
+      RandomPayload(data);
+      data[0] = (data[0] & 0xF0) | (1 + n % 2); // always select a page
+
+      message->Decode(data, frame);
+      message->SetFrame(data, sizeof(data));
+
+      for (size_t i = 0; i < frame.Values.size(); i++)
+      {
+        std::map<std::string, NewEagle::DbcSignal>* signals = message->GetSignals();
+        for (std::map<std::string, NewEagle::DbcSignal>::iterator it = signals->begin(); it != signals->end(); it++)
+        {
+          if (it->second.GetIndex() == i && (NewEagle::MUX_SIGNAL != it->second.GetMultiplexerMode() ||
+            (double)(1 + n % 2) == it->second.GetMultiplexerSwitch()))
+          {
+            EXPECT_EQ(frame.Values[i], it->second.GetResult()) << it->first;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(CanFd, EncodeRoundTrips)
+{
+  NewEagle::Dbc dbc = TestDbc();
+  NewEagle::DbcMessage* message = dbc.ResolveMessage("FdFrame");
+
+  message->GetSignal("Mode")->SetResult(2);
+  message->GetSignal("IntelMid")->SetResult(-12345);
+  message->GetSignal("MotorolaMid")->SetResult(0xABCDEF);
+  message->GetSignal("Intel64")->SetResult(18446744073709549568.0); // 2^64 - 2^11, exact in a double
+  message->GetSignal("Motorola64")->SetResult(-9007199254740993.0);
+  message->GetSignal("IntelWide")->SetResult(1152921504606846848.0); // near the top of 60 bits
+  message->GetSignal("MotorolaWide")->SetResult(-2305843009213693952.0); // the 62-bit minimum
+  message->GetSignal("Page2")->SetResult(-2048);
+  message->GetSignal("MotorolaTail")->SetResult(0x5A);
+  message->GetSignal("IntelTail")->SetResult(100.5);
+
+  uint8_t data[NewEagle::MAX_PAYLOAD_SIZE];
+  message->EncodeFrame(data);
+
+  std::map<std::string, NewEagle::DbcSignal>* signals = message->GetSignals();
+  for (std::map<std::string, NewEagle::DbcSignal>::iterator it = signals->begin(); it != signals->end(); it++)
+  {
+    if ("Page1" != it->first)
+    {
+      EXPECT_EQ(it->second.GetResult(), ReferenceValue(data, it->second)) << it->first;
+    }
+  }
+
+  // A changed signal is re-packed on top of the previous payload.
+  message->GetSignal("IntelWide")->SetResult(7);
+  message->EncodeFrame(data);
+  EXPECT_EQ(7, ReferenceValue(data, *message->GetSignal("IntelWide")));
+  EXPECT_EQ(-2305843009213693952.0, ReferenceValue(data, *message->GetSignal("MotorolaWide")));
+}
+
+TEST(CanFd, ClassicFrameIsRejected)
+{
+  NewEagle::Dbc dbc = TestDbc();
+  NewEagle::DbcMessage* message = dbc.ResolveMessage("FdFrame");
+
+  can_msgs::Frame frame;
+  EXPECT_THROW(message->EncodeFrame(frame), std::runtime_error);
+  EXPECT_THROW(NewEagle::DbcMessage(65, 1, NewEagle::STD, "TooLong", 1), std::runtime_error);
+}
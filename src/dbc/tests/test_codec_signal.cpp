@@ -0,0 +1,149 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks that Codec::Signal packs and unpacks the same bits as the runtime
+//  DbcSignal path for Intel and Motorola signals, scaled and raw.
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <dbc/DbcCodec.h>
+#include <dbc/DbcSignal.h>
+
+#include "../src/DbcUtilities.h"
+
+namespace
+{
+  const int ITERATIONS = 10000;
+
+  void RandomFrame(uint8_t* data)
+  {
+    for (int i = 0; i < 8; i++)
+    {
+      data[i] = (uint8_t)rand();
+    }
+  }
+
+  template <typename T>
+  NewEagle::DbcSignal RuntimeSignal(NewEagle::ByteOrder order, NewEagle::SignType sign, uint8_t startBit, uint8_t length)
+  {
+    return NewEagle::DbcSignal(8, T::GainValue, T::OffsetValue, startBit, order, length, sign, "Test", NewEagle::NONE);
+  }
+
+  template <uint8_t StartBit, uint8_t Length, NewEagle::ByteOrder Order, NewEagle::SignType Sign, typename Gain, typename Offset>
+  void ExpectSameAsRuntime()
+  {
+    typedef NewEagle::Codec::Signal<StartBit, Length, Order, Sign, Gain, Offset> Compiled;
+    NewEagle::DbcSignal runtime = RuntimeSignal<Compiled>(Order, Sign, StartBit, Length);
+
+    srand(StartBit * 131 + Length);
+
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+      uint8_t data[8];
+      RandomFrame(data);
+
+      double expected = NewEagle::Unpack(data, runtime);
+      double actual = Compiled::Unpack(data);
+      ASSERT_EQ(0, memcmp(&expected, &actual, sizeof(double)))
+        << "unpack start " << (int)StartBit << " length " << (int)Length << ": " << expected << " != " << actual;
+
+      // Pack a value from the signal's own range, plus a little out of range now and then.
+      double value = actual + (i % 7 == 0 ? (double)(rand() % 5 - 2) : 0.0);
+
+      uint8_t packedRuntime[8];
+      uint8_t packedCompiled[8];
+      RandomFrame(packedRuntime);
+      memcpy(packedCompiled, packedRuntime, sizeof(packedCompiled));
+
+      runtime.SetResult(value);
+      NewEagle::Pack(packedRuntime, runtime);
+      Compiled::Pack(packedCompiled, value);
+
+      ASSERT_EQ(0, memcmp(packedRuntime, packedCompiled, 8))
+        << "pack start " << (int)StartBit << " length " << (int)Length << " value " << value;
+
+      // The raw path gives the same bits without going through the scaled value.
+      int64_t raw = Compiled::UnpackRaw(data);
+      runtime.SetRaw(raw);
+      ASSERT_EQ(raw, runtime.GetRaw());
+
+      double scaled = runtime.GetResult();
+      ASSERT_EQ(0, memcmp(&scaled, &actual, sizeof(double)));
+
+      NewEagle::Pack(packedRuntime, runtime);
+      Compiled::PackRaw(packedCompiled, raw);
+      ASSERT_EQ(0, memcmp(packedRuntime, packedCompiled, 8))
+        << "raw pack start " << (int)StartBit << " length " << (int)Length << " raw " << raw;
+    }
+  }
+}
+
+TEST(CodecSignal, IntelMatchesRuntime)
+{
+  ExpectSameAsRuntime<0, 1, NewEagle::LITTLE_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<0, 8, NewEagle::LITTLE_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<3, 5, NewEagle::LITTLE_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<8, 16, NewEagle::LITTLE_END, NewEagle::UNSIGNED, std::ratio<1, 10>, std::ratio<0> >();
+  ExpectSameAsRuntime<12, 13, NewEagle::LITTLE_END, NewEagle::SIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<20, 16, NewEagle::LITTLE_END, NewEagle::SIGNED, std::ratio<1, 16>, std::ratio<-40> >();
+  ExpectSameAsRuntime<40, 24, NewEagle::LITTLE_END, NewEagle::UNSIGNED, std::ratio<1, 100>, std::ratio<0> >();
+  ExpectSameAsRuntime<32, 32, NewEagle::LITTLE_END, NewEagle::SIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<63, 1, NewEagle::LITTLE_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+}
+
+TEST(CodecSignal, MotorolaMatchesRuntime)
+{
+  ExpectSameAsRuntime<7, 1, NewEagle::BIG_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<7, 8, NewEagle::BIG_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<13, 12, NewEagle::BIG_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<23, 16, NewEagle::BIG_END, NewEagle::SIGNED, std::ratio<1, 10>, std::ratio<0> >();
+  ExpectSameAsRuntime<39, 3, NewEagle::BIG_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<35, 20, NewEagle::BIG_END, NewEagle::SIGNED, std::ratio<1, 16>, std::ratio<-40> >();
+  ExpectSameAsRuntime<31, 32, NewEagle::BIG_END, NewEagle::SIGNED, std::ratio<1>, std::ratio<0> >();
+  ExpectSameAsRuntime<56, 1, NewEagle::BIG_END, NewEagle::UNSIGNED, std::ratio<1>, std::ratio<0> >();
+}
+
+TEST(CodecSignal, UnpackIsConstexpr)
+{
+  static constexpr uint8_t frame[8] = { 0x34, 0x12, 0xff, 0x80, 0x00, 0x00, 0x00, 0x01 };
+
+  static_assert(NewEagle::Codec::Signal<0, 16, NewEagle::LITTLE_END, NewEagle::UNSIGNED>::UnpackRaw(frame) == 0x1234, "intel");
+  static_assert(NewEagle::Codec::Signal<7, 16, NewEagle::BIG_END, NewEagle::UNSIGNED>::UnpackRaw(frame) == 0x3412, "motorola");
+  static_assert(NewEagle::Codec::Signal<16, 8, NewEagle::LITTLE_END, NewEagle::SIGNED>::UnpackRaw(frame) == -1, "signed");
+
+  EXPECT_EQ(0x1234, (NewEagle::Codec::Signal<0, 16, NewEagle::LITTLE_END, NewEagle::UNSIGNED>::UnpackRaw(frame)));
+}
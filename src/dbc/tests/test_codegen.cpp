@@ -0,0 +1,183 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks the codecs dbc_codegen generates from codegen_test.dbc against the runtime
+//  DbcMessage decode and encode of the same DBC.
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <dbc/DbcBuilder.h>
+
+#include <dbc_test/TestCodecs.h>
+
+namespace
+{
+  const int FRAME_COUNT = 2000;
+
+  void RandomFrame(uint8_t* data, unsigned int &seed)
+  {
+    for (size_t i = 0; i < 8; i++)
+    {
+      data[i] = (uint8_t)rand_r(&seed);
+    }
+  }
+
+  class Codegen : public ::testing::Test
+  {
+    protected:
+      void SetUp()
+      {
+        dbc = NewEagle::DbcBuilder().NewDbcFromFile(CODEGEN_TEST_DBC);
+      }
+
+      // Decodes with the runtime path and re-encodes what it decoded, the reference
+      //  for the generated encode().
+      const NewEagle::DecodedFrame& Reference(NewEagle::DbcMessage &message, const uint8_t* data, uint8_t* encoded)
+      {
+        // Decode leaves unselected pages alone, so start from an empty frame.
+        frame = NewEagle::DecodedFrame();
+        message.Decode(data, frame);
+        message.Encode(frame, encoded);
+        return frame;
+      }
+
+      NewEagle::Dbc dbc;
+      NewEagle::DecodedFrame frame;
+  };
+}
+
+// Compares one generated field with the runtime value of the signal it was named after.
+#define EXPECT_FIELD(message, reference, decoded, field) \
+  EXPECT_EQ((reference).GetValue((message)->GetSignal(#field)), (double)(decoded).field) << #field
+
+TEST_F(Codegen, Constants)
+{
+  // Copied out first, gtest takes its arguments by reference.
+  uint32_t intelId = dbc_test::Intel::ID;
+  uint32_t motorolaId = dbc_test::Motorola::ID;
+  uint8_t pagedDlc = dbc_test::Paged::DLC;
+
+  EXPECT_EQ(dbc.GetMessage("Intel")->GetId(), intelId);
+  EXPECT_FALSE(dbc_test::Intel::EXTENDED);
+  EXPECT_EQ(dbc.GetMessage("Motorola")->GetId(), motorolaId);
+  EXPECT_TRUE(dbc_test::Motorola::EXTENDED);
+  EXPECT_EQ(dbc.GetMessage("Paged")->GetDlc(), pagedDlc);
+}
+
+TEST_F(Codegen, Intel)
+{
+  NewEagle::DbcMessage* message = dbc.GetMessage("Intel");
+  unsigned int seed = 1;
+
+  for (int i = 0; i < FRAME_COUNT; i++)
+  {
+    uint8_t data[8], expected[8], encoded[8];
+    RandomFrame(data, seed);
+
+    const NewEagle::DecodedFrame &reference = Reference(*message, data, expected);
+    dbc_test::Intel decoded = dbc_test::Intel::decode(data);
+
+    EXPECT_FIELD(message, reference, decoded, Counter);
+    EXPECT_FIELD(message, reference, decoded, Flag);
+    EXPECT_FIELD(message, reference, decoded, Speed);
+    EXPECT_FIELD(message, reference, decoded, Offset);
+    EXPECT_FIELD(message, reference, decoded, Wide);
+
+    decoded.encode(encoded);
+    ASSERT_EQ(0, memcmp(expected, encoded, 8)) << "frame " << i;
+  }
+}
+
+TEST_F(Codegen, Motorola)
+{
+  NewEagle::DbcMessage* message = dbc.GetMessage("Motorola");
+  unsigned int seed = 2;
+
+  for (int i = 0; i < FRAME_COUNT; i++)
+  {
+    uint8_t data[8], expected[8], encoded[8];
+    RandomFrame(data, seed);
+
+    const NewEagle::DecodedFrame &reference = Reference(*message, data, expected);
+    dbc_test::Motorola decoded = dbc_test::Motorola::decode(data);
+
+    EXPECT_FIELD(message, reference, decoded, Angle);
+    EXPECT_FIELD(message, reference, decoded, Rate);
+    EXPECT_FIELD(message, reference, decoded, Status);
+    EXPECT_FIELD(message, reference, decoded, Raw);
+
+    decoded.encode(encoded);
+    ASSERT_EQ(0, memcmp(expected, encoded, 8)) << "frame " << i;
+  }
+}
+
+TEST_F(Codegen, MultiplexedPages)
+{
+  NewEagle::DbcMessage* message = dbc.GetMessage("Paged");
+  unsigned int seed = 3;
+
+  for (int i = 0; i < FRAME_COUNT; i++)
+  {
+    uint8_t data[8], expected[8], encoded[8];
+    RandomFrame(data, seed);
+
+    // Unselected pages decode as 0 on both paths and are left out of both encodes.
+    const NewEagle::DecodedFrame &reference = Reference(*message, data, expected);
+    dbc_test::Paged decoded = dbc_test::Paged::decode(data);
+
+    EXPECT_FIELD(message, reference, decoded, Page);
+    EXPECT_FIELD(message, reference, decoded, Counter);
+    EXPECT_FIELD(message, reference, decoded, Pedal);
+    EXPECT_FIELD(message, reference, decoded, Torque);
+    EXPECT_FIELD(message, reference, decoded, Speed);
+    EXPECT_FIELD(message, reference, decoded, Slope);
+
+    decoded.encode(encoded);
+    ASSERT_EQ(0, memcmp(expected, encoded, 8)) << "frame " << i;
+  }
+}
+
+TEST_F(Codegen, MessageWithoutSignals)
+{
+  uint8_t data[8];
+  memset(data, 0xFF, sizeof(data));
+
+  dbc_test::Empty::decode(data).encode(data);
+
+  uint8_t zero[8] = { 0 };
+  EXPECT_EQ(0, memcmp(zero, data, 8));
+}
@@ -0,0 +1,320 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks the DBC parser: statements are applied to the messages and signals they name,
+//  and malformed lines are skipped without losing the rest of the file.
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dbc/DbcBuilder.h>
+#include <dbc/LineParser.h>
+
+namespace
+{
+  const char* TEST_DBC =
+    "VERSION \"\"\n"
+    "\n"
+    "NS_ :\n"
+    "\tCM_\n"
+    "\tBA_\n"
+    "\tSIG_VALTYPE_\n"
+    "\n"
+    "BU_: DBW AKit\n"
+    "\n"
+    "BO_ 2147491585 DBW_Misc: 8 DBW\n"
+    " SG_ Switch M : 0|2@1+ (1,0) [0|3] \"\" AKit\n"
+    " SG_ Speed m1 : 8|16@1- (0.01,-5) [-327.68|327.67] \"m/s\" AKit\n"
+    " SG_ Torque : 39|12@0+ (2.5E-1,0) [0|1023.75] \"Nm\" AKit\n"
+    " SG_ Ratio : 24|32@1- (1,0) [-1e+38|1e+38] \"\" AKit\n"
+    "\n"
+    "BO_ 1807 DBW_FaultText: 8 DBW\n"
+    " SG_ Char01 : 0|8@1+ (1,0) [0|255] \"\" AKit\n"
+    " SG_ Broken : 8|8@2+ (1,0) [0|255] \"\" AKit\n"
+    " SG_ Char02 : 8|8@1+ (1,0) [0|255] \"\" AKit\n"
+    "\n"
+    "CM_ \"Network comment\";\n"
+    "CM_ BO_ 2147491585 \"Must be sent \\\"continuously\\\".\";\n"
+    "CM_ SG_ 2147491585 Speed \"First line\n"
+    "second line\";\n"
+    "CM_ SG_ 1807 Char01 \"\";\n"
+    "CM_ SG_ 1807\n"
+    "BA_DEF_ SG_ \"GenSigStartValue\" INT 0 65535;\n"
+    "BA_ \"GenSigStartValue\" SG_ 2147491585 Speed 500;\n"
+    "BA_ \"GenMsgCycleTime\" BO_ 2147491585 20;\n"
+    "SIG_VALTYPE_ 2147491585 Ratio : 1;\n"
+    "SIG_VALTYPE_ 2147491585 Missing : 1;\n";
+
+  NewEagle::Dbc Parse(const std::string &contents)
+  {
+    NewEagle::DbcBuilder builder;
+    return builder.NewDbc(contents);
+  }
+
+  std::string WriteTempFile(const std::string &contents)
+  {
+    char path[] = "/tmp/dbc_builder_test_XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT_LE(0, fd);
+    EXPECT_EQ((ssize_t)contents.size(), write(fd, contents.data(), contents.size()));
+    close(fd);
+
+    return path;
+  }
+
+  std::string WithCrLf(const std::string &contents)
+  {
+    std::string out;
+    for (size_t i = 0; i < contents.size(); i++)
+    {
+      if ('\n' == contents[i])
+      {
+        out += '\r';
+      }
+      out += contents[i];
+    }
+
+    return out;
+  }
+
+  // Comment text is kept as written, line ending included.
+  void ExpectTestDbc(NewEagle::Dbc &dbc, const std::string &newline)
+  {
+    ASSERT_EQ(2, dbc.GetMessageCount());
+
+    NewEagle::DbcMessage* misc = dbc.GetMessage("DBW_Misc");
+    ASSERT_TRUE(NULL != misc);
+    EXPECT_EQ(0x1F01u, misc->GetId());
+    EXPECT_EQ(NewEagle::EXT, misc->GetIdType());
+    EXPECT_EQ(8, misc->GetDlc());
+    EXPECT_EQ(4u, misc->GetSignalCount());
+    EXPECT_EQ("Must be sent \\\"continuously\\\".", misc->GetComment().Comment);
+
+    NewEagle::DbcSignal* speed = misc->GetSignal("Speed");
+    ASSERT_TRUE(NULL != speed);
+    EXPECT_EQ(NewEagle::MUX_SIGNAL, speed->GetMultiplexerMode());
+    EXPECT_EQ(1, speed->GetMultiplexerSwitch());
+    EXPECT_EQ(8, speed->GetStartBit());
+    EXPECT_EQ(16, speed->GetLength());
+    EXPECT_EQ(NewEagle::SIGNED, speed->GetSign());
+    EXPECT_DOUBLE_EQ(0.01, speed->GetGain());
+    EXPECT_DOUBLE_EQ(-5, speed->GetOffset());
+    EXPECT_EQ("First line" + newline + "second line", speed->GetComment().Comment);
+    EXPECT_DOUBLE_EQ(0.01 * 500 - 5, speed->GetInitialValue());
+    EXPECT_EQ(NewEagle::INT, speed->GetDataType());
+
+    NewEagle::DbcSignal* torque = misc->GetSignal("Torque");
+    ASSERT_TRUE(NULL != torque);
+    EXPECT_EQ(NewEagle::BIG_END, torque->GetEndianness());
+    EXPECT_EQ(0.25, torque->GetGain());
+    EXPECT_EQ("", torque->GetComment().Comment);
+
+    EXPECT_EQ(NewEagle::FLOAT, misc->GetSignal("Ratio")->GetDataType());
+    EXPECT_EQ(NewEagle::MUX_SWITCH, misc->GetSignal("Switch")->GetMultiplexerMode());
+
+    NewEagle::DbcMessage* faults = dbc.GetMessageById(1807);
+    ASSERT_TRUE(NULL != faults);
+    EXPECT_EQ(NewEagle::STD, faults->GetIdType());
+    EXPECT_EQ(2u, faults->GetSignalCount());
+    EXPECT_TRUE(NULL == faults->GetSignal("Broken"));
+    EXPECT_TRUE(NULL != faults->GetSignal("Char02"));
+  }
+}
+
+TEST(DbcBuilder, ParsesStatements)
+{
+  NewEagle::Dbc dbc = Parse(TEST_DBC);
+  ExpectTestDbc(dbc, "\n");
+}
+
+TEST(DbcBuilder, ParsesCrLf)
+{
+  NewEagle::Dbc dbc = Parse(WithCrLf(TEST_DBC));
+  ExpectTestDbc(dbc, "\r\n");
+}
+
+TEST(DbcBuilder, CopyKeepsSignalDetails)
+{
+  NewEagle::Dbc dbc = Parse(TEST_DBC);
+  NewEagle::Dbc copy(dbc);
+
+  dbc = NewEagle::Dbc();
+  ExpectTestDbc(copy, "\n");
+}
+
+TEST(DbcBuilder, SignalsBeforeMessageAreSkipped)
+{
+  NewEagle::Dbc dbc = Parse(std::string(" SG_ Orphan : 0|8@1+ (1,0) [0|255] \"\" AKit\n") + TEST_DBC);
+  ExpectTestDbc(dbc, "\n");
+}
+
+TEST(DbcBuilder, UnterminatedCommentEndsAtLine)
+{
+  std::string contents(TEST_DBC);
+  contents += "CM_ BO_ 1807 \"No closing quote;\n"
+              "BO_ 1808 DBW_Extra: 8 DBW\n"
+              " SG_ Value : 0|8@1+ (1,0) [0|255] \"\" AKit\n";
+
+  NewEagle::Dbc dbc = Parse(contents);
+
+  ASSERT_TRUE(NULL != dbc.GetMessage("DBW_Extra"));
+  EXPECT_EQ(1u, dbc.GetMessage("DBW_Extra")->GetSignalCount());
+  EXPECT_EQ("", dbc.GetMessage("DBW_FaultText")->GetComment().Comment);
+}
+
+TEST(DbcBuilder, ParsesFile)
+{
+  std::string path = WriteTempFile(TEST_DBC);
+
+  NewEagle::Dbc dbc = NewEagle::DbcBuilder().NewDbcFromFile(path);
+  ExpectTestDbc(dbc, "\n");
+
+  ASSERT_EQ(0, truncate(path.c_str(), 0));
+  EXPECT_EQ(0, NewEagle::DbcBuilder().NewDbcFromFile(path).GetMessageCount());
+
+  unlink(path.c_str());
+  EXPECT_THROW(NewEagle::DbcBuilder().NewDbcFromFile(path), std::runtime_error);
+}
+
+TEST(DbcBuilder, MergesFiles)
+{
+  std::vector<std::string> paths;
+  paths.push_back(WriteTempFile(TEST_DBC));
+  paths.push_back(WriteTempFile(
+    "BO_ 1807 Pdu_FaultText: 8 PDU\n"
+    " SG_ Code : 0|8@1+ (1,0) [0|255] \"\" AKit\n"
+    "BO_ 1808 DBW_Misc: 8 PDU\n"
+    "BO_ 1809 Pdu_Status: 8 PDU\n"
+    " SG_ Relay : 0|1@1+ (1,0) [0|1] \"\" AKit\n"));
+
+  for (size_t threads = 1; threads <= 2; threads++)
+  {
+    NewEagle::DbcMergeReport report;
+    NewEagle::Dbc dbc = NewEagle::DbcBuilder().NewDbcFromFiles(paths, report, threads);
+
+    EXPECT_EQ(3, dbc.GetMessageCount());
+    EXPECT_EQ("DBW_FaultText", dbc.GetMessageById(1807)->GetName());
+    EXPECT_EQ(1u, dbc.GetMessage("Pdu_Status")->GetSignalCount());
+
+    ASSERT_EQ(2u, report.Collisions.size());
+    EXPECT_EQ(NewEagle::NAME_COLLISION, report.Collisions[0].Type);
+    EXPECT_EQ("DBW_Misc", report.Collisions[0].DroppedMessage);
+    EXPECT_EQ(paths[1], report.Collisions[0].DroppedFile);
+    EXPECT_EQ(NewEagle::ID_COLLISION, report.Collisions[1].Type);
+    EXPECT_EQ(1807u, report.Collisions[1].Id);
+    EXPECT_EQ("DBW_FaultText", report.Collisions[1].KeptMessage);
+    EXPECT_EQ(paths[0], report.Collisions[1].KeptFile);
+    EXPECT_EQ("Pdu_FaultText", report.Collisions[1].DroppedMessage);
+  }
+
+  unlink(paths[1].c_str());
+
+  NewEagle::DbcMergeReport report;
+  EXPECT_THROW(NewEagle::DbcBuilder().NewDbcFromFiles(paths, report), std::runtime_error);
+
+  unlink(paths[0].c_str());
+}
+
+TEST(DbcBuilder, MergeSkipsVectorPlaceholder)
+{
+  const char* placeholder =
+    "BO_ 3221225472 VECTOR__INDEPENDENT_SIG_MSG: 0 Vector__XXX\n"
+    " SG_ Unassigned : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\n";
+
+  std::vector<std::string> paths;
+  paths.push_back(WriteTempFile(std::string(placeholder) + TEST_DBC));
+  paths.push_back(WriteTempFile(std::string(placeholder) +
+    "BO_ 1809 Pdu_Status: 8 PDU\n"
+    " SG_ Relay : 0|1@1+ (1,0) [0|1] \"\" AKit\n"));
+
+  NewEagle::DbcMergeReport report;
+  NewEagle::Dbc dbc = NewEagle::DbcBuilder().NewDbcFromFiles(paths, report);
+
+  EXPECT_TRUE(report.Collisions.empty()) << report.ToString();
+  EXPECT_TRUE(NULL != dbc.GetMessage("VECTOR__INDEPENDENT_SIG_MSG"));
+  EXPECT_TRUE(NULL != dbc.GetMessage("Pdu_Status"));
+
+  unlink(paths[0].c_str());
+  unlink(paths[1].c_str());
+}
+
+TEST(LineParser, DoublesMatchStreamExtraction)
+{
+  const char* numbers[] = {
+    "0", "-0", "1", "+1", "0.1", "-0.001", "1.", ".5", "-.5", "123456789012345", "1234567890123456789",
+    "0.30000000000000004", "3.0517578125E-005", "1e22", "1e23", "2.5e-22", "4.9e-324", "1.7976931348623157e308",
+    "0.000000000000000000000000001", "6.103515625e-05", "0.0039215686274509803"
+  };
+
+  for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++)
+  {
+    double expected;
+    std::istringstream reader(numbers[i]);
+    reader >> expected;
+
+    NewEagle::LineParser parser(std::string(" ") + numbers[i] + "|");
+
+    double value;
+    ASSERT_TRUE(parser.TryReadDouble(value)) << numbers[i];
+    EXPECT_EQ(expected, value) << numbers[i];
+    EXPECT_TRUE(parser.TrySeekSeparator('|')) << numbers[i];
+  }
+}
+
+TEST(LineParser, MalformedFieldsAreRejected)
+{
+  double value;
+  EXPECT_FALSE(NewEagle::LineParser("abc").TryReadDouble(value));
+  EXPECT_FALSE(NewEagle::LineParser("-").TryReadDouble(value));
+  EXPECT_FALSE(NewEagle::LineParser("1e+").TryReadDouble(value));
+
+  uint32_t id;
+  EXPECT_FALSE(NewEagle::LineParser("  ").TryReadUInt(id));
+
+  NewEagle::LineToken token;
+  EXPECT_FALSE(NewEagle::LineParser("\"open").TryReadQuotedString(token));
+  EXPECT_FALSE(NewEagle::LineParser("9name").TryReadCIdentifier(token));
+
+  EXPECT_THROW(NewEagle::LineParser("").ReadUInt(), NewEagle::LineParserAtEOLException);
+  EXPECT_THROW(NewEagle::LineParser("x").ReadUInt(), NewEagle::LineParserLenZeroException);
+  EXPECT_THROW(NewEagle::LineParser("x").ReadDouble(), NewEagle::LineParserInvalidCharException);
+}
@@ -0,0 +1,231 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks that a Dbc loaded from the binary cache matches the one parsed from text.
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+
+#include <dbc/DbcBuilder.h>
+#include <dbc/DbcCache.h>
+
+namespace
+{
+  const char* TEST_DBC =
+    "VERSION \"\"\n"
+    "\n"
+    "BO_ 2147491585 DBW_Misc: 8 DBW\n"
+    " SG_ Switch M : 0|2@1+ (1,0) [0|3] \"\" AKit\n"
+    " SG_ Speed m1 : 8|16@1- (0.01,-5) [-327.68|327.67] \"m/s\" AKit\n"
+    " SG_ Torque : 39|12@0+ (0.25,0) [0|1023.75] \"Nm\" AKit\n"
+    "\n"
+    "BO_ 1807 DBW_FaultText: 8 DBW\n"
+    " SG_ Char01 : 0|8@1+ (1,0) [0|255] \"\" AKit\n"
+    "\n"
+    "BO_ 2147491600 DBW_Fd: 64 DBW\n"
+    " SG_ Wide : 500|12@1+ (1,0) [0|4095] \"\" AKit\n"
+    " SG_ Long : 64|64@1+ (1,0) [0|0] \"\" AKit\n"
+    "\n"
+    "CM_ BO_ 2147491585 \"Must be sent continuously.\";\n"
+    "CM_ SG_ 2147491585 Speed \"Vehicle speed\";\n"
+    "BA_ \"GenSigStartValue\" SG_ 2147491585 Speed 500;\n"
+    "SIG_VALTYPE_ 2147491600 Long : 2;\n";
+
+  class DbcCacheTest : public ::testing::Test
+  {
+    protected:
+      std::string directory;
+
+      virtual void SetUp()
+      {
+        char name[] = "/tmp/dbc_cache_test_XXXXXX";
+        ASSERT_TRUE(NULL != mkdtemp(name));
+        directory = std::string(name) + "/cache";
+      }
+
+      virtual void TearDown()
+      {
+        std::string command = "rm -rf " + directory.substr(0, directory.rfind('/'));
+        ASSERT_EQ(0, system(command.c_str()));
+      }
+  };
+
+  bool FileExists(const std::string &path)
+  {
+    struct stat info;
+    return 0 == stat(path.c_str(), &info);
+  }
+
+  void ExpectSameDbc(NewEagle::Dbc &expected, NewEagle::Dbc &actual)
+  {
+    ASSERT_EQ(expected.GetMessageCount(), actual.GetMessageCount());
+
+    std::map<std::string, NewEagle::DbcMessage>* messages = expected.GetMessages();
+    for (std::map<std::string, NewEagle::DbcMessage>::iterator it = messages->begin(); it != messages->end(); it++)
+    {
+      NewEagle::DbcMessage* msg = actual.GetMessageById(it->second.GetId(), it->second.GetIdType());
+      ASSERT_TRUE(NULL != msg) << it->first;
+      EXPECT_EQ(it->first, msg->GetName());
+      EXPECT_EQ(it->second.GetRawId(), msg->GetRawId());
+      EXPECT_EQ(it->second.GetDlc(), msg->GetDlc());
+      EXPECT_EQ(it->second.GetComment().Comment, msg->GetComment().Comment);
+      ASSERT_EQ(it->second.GetSignalCount(), msg->GetSignalCount());
+
+      std::map<std::string, NewEagle::DbcSignal>* signals = it->second.GetSignals();
+      for (std::map<std::string, NewEagle::DbcSignal>::iterator its = signals->begin(); its != signals->end(); its++)
+      {
+        NewEagle::DbcSignal* sig = msg->GetSignal(its->first);
+        ASSERT_TRUE(NULL != sig) << its->first;
+        EXPECT_EQ(its->second.GetDlc(), sig->GetDlc());
+        EXPECT_EQ(its->second.GetGain(), sig->GetGain());
+        EXPECT_EQ(its->second.GetOffset(), sig->GetOffset());
+        EXPECT_EQ(its->second.GetStartBit(), sig->GetStartBit());
+        EXPECT_EQ(its->second.GetLength(), sig->GetLength());
+        EXPECT_EQ(its->second.GetEndianness(), sig->GetEndianness());
+        EXPECT_EQ(its->second.GetSign(), sig->GetSign());
+        EXPECT_EQ(its->second.GetMultiplexerMode(), sig->GetMultiplexerMode());
+        EXPECT_EQ(its->second.GetMultiplexerSwitch(), sig->GetMultiplexerSwitch());
+        EXPECT_EQ(its->second.GetInitialValue(), sig->GetInitialValue());
+        EXPECT_EQ(its->second.GetDataType(), sig->GetDataType());
+        EXPECT_EQ(its->second.GetComment().Comment, sig->GetComment().Comment);
+        EXPECT_EQ(its->second.GetIndex(), sig->GetIndex());
+        EXPECT_EQ(its->second.GetPlan().Shift, sig->GetPlan().Shift);
+        EXPECT_EQ(its->second.GetPlan().Mask, sig->GetPlan().Mask);
+        EXPECT_EQ(its->second.GetPlan().Window, sig->GetPlan().Window);
+        EXPECT_EQ(its->second.GetPlan().Valid, sig->GetPlan().Valid);
+      }
+    }
+  }
+}
+
+TEST_F(DbcCacheTest, CachedLoadMatchesParse)
+{
+  NewEagle::Dbc parsed = NewEagle::DbcBuilder().NewDbc(TEST_DBC);
+
+  NewEagle::DbcCache cache(directory);
+  std::string path = cache.GetPath(TEST_DBC, strlen(TEST_DBC));
+
+  NewEagle::Dbc first = cache.Load(TEST_DBC);
+  ASSERT_TRUE(FileExists(path));
+  ExpectSameDbc(parsed, first);
+
+  NewEagle::Dbc cached = cache.Load(TEST_DBC);
+  ExpectSameDbc(parsed, cached);
+  EXPECT_EQ("Vehicle speed", cached.GetMessage("DBW_Misc")->GetSignal("Speed")->GetComment().Comment);
+  EXPECT_DOUBLE_EQ(0.01 * 500 - 5, cached.GetMessage("DBW_Misc")->GetSignal("Speed")->GetInitialValue());
+}
+
+TEST_F(DbcCacheTest, ChangedTextMisses)
+{
+  NewEagle::DbcCache cache(directory);
+  std::string changed = std::string(TEST_DBC) + "BO_ 1808 DBW_Extra: 8 DBW\n";
+
+  EXPECT_NE(cache.GetPath(TEST_DBC, strlen(TEST_DBC)), cache.GetPath(changed.data(), changed.size()));
+
+  cache.Load(TEST_DBC);
+  NewEagle::Dbc dbc = cache.Load(changed);
+
+  EXPECT_EQ(4, dbc.GetMessageCount());
+  EXPECT_TRUE(FileExists(cache.GetPath(changed.data(), changed.size())));
+}
+
+TEST_F(DbcCacheTest, DamagedImageIsRebuilt)
+{
+  NewEagle::Dbc parsed = NewEagle::DbcBuilder().NewDbc(TEST_DBC);
+
+  NewEagle::DbcCache cache(directory);
+  std::string path = cache.GetPath(TEST_DBC, strlen(TEST_DBC));
+  cache.Load(TEST_DBC);
+
+  struct stat info;
+  ASSERT_EQ(0, stat(path.c_str(), &info));
+  ASSERT_EQ(0, truncate(path.c_str(), info.st_size - 5));
+
+  NewEagle::Dbc dbc = cache.Load(TEST_DBC);
+  ExpectSameDbc(parsed, dbc);
+
+  struct stat rebuilt;
+  ASSERT_EQ(0, stat(path.c_str(), &rebuilt));
+  EXPECT_EQ(info.st_size, rebuilt.st_size);
+}
+
+TEST_F(DbcCacheTest, EmptyDirectoryDisablesCache)
+{
+  NewEagle::Dbc parsed = NewEagle::DbcBuilder().NewDbc(TEST_DBC);
+  NewEagle::Dbc dbc = NewEagle::DbcCache(std::string()).Load(TEST_DBC);
+
+  ExpectSameDbc(parsed, dbc);
+  EXPECT_FALSE(FileExists(directory));
+}
+
+TEST_F(DbcCacheTest, HashIsSha256)
+{
+  const uint8_t expected[32] =
+  {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+  };
+
+  NewEagle::DbcDigest hash = NewEagle::DbcCache::Hash("abc", 3);
+  EXPECT_EQ(0, memcmp(expected, hash.data(), sizeof(expected)));
+}
+
+TEST_F(DbcCacheTest, ImageOfOtherTextIsIgnored)
+{
+  // Same size, different gain: only the digest in the header tells the images apart.
+  std::string other = TEST_DBC;
+  size_t gain = other.find("(0.25,0)");
+  ASSERT_NE(std::string::npos, gain);
+  other.replace(gain, 8, "(0.50,0)");
+  ASSERT_EQ(strlen(TEST_DBC), other.size());
+
+  NewEagle::DbcCache cache(directory);
+  std::string path = cache.GetPath(TEST_DBC, strlen(TEST_DBC));
+  std::string otherPath = cache.GetPath(other.data(), other.size());
+  ASSERT_NE(path, otherPath);
+
+  cache.Load(TEST_DBC);
+  ASSERT_EQ(0, rename(path.c_str(), otherPath.c_str()));
+
+  NewEagle::Dbc dbc = cache.Load(other);
+  EXPECT_EQ(0.5, dbc.GetMessage("DBW_Misc")->GetSignal("Torque")->GetGain());
+}
@@ -0,0 +1,151 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks that the registry hands out one shared Dbc per DBC text.
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dbc/DbcRegistry.h>
+
+namespace
+{
+  const char* TEST_DBC =
+    "VERSION \"\"\n"
+    "\n"
+    "BO_ 2147491585 DBW_Misc: 8 DBW\n"
+    " SG_ Speed : 8|16@1- (0.01,-5) [-327.68|327.67] \"m/s\" AKit\n"
+    " SG_ Torque : 39|12@0+ (0.25,0) [0|1023.75] \"Nm\" AKit\n";
+
+  const char* OTHER_DBC =
+    "VERSION \"\"\n"
+    "\n"
+    "BO_ 1807 DBW_FaultText: 8 DBW\n"
+    " SG_ Char01 : 0|8@1+ (1,0) [0|255] \"\" AKit\n";
+}
+
+TEST(DbcRegistry, SameTextSharesOneDbc)
+{
+  std::shared_ptr<const NewEagle::Dbc> first = NewEagle::DbcRegistry::Load(TEST_DBC, "");
+  std::shared_ptr<const NewEagle::Dbc> second = NewEagle::DbcRegistry::Load(std::string(TEST_DBC), "");
+  std::shared_ptr<const NewEagle::Dbc> other = NewEagle::DbcRegistry::Load(OTHER_DBC, "");
+
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_NE(first.get(), other.get());
+  EXPECT_EQ(2u, NewEagle::DbcRegistry::GetCount());
+
+  ASSERT_TRUE(NULL != first->GetMessage("DBW_Misc"));
+  EXPECT_TRUE(NULL != first->ResolveMessage("DBW_Misc")->ResolveSignal("Speed"));
+  EXPECT_THROW(first->ResolveMessage("DBW_Misc")->ResolveSignal("Missing"), std::runtime_error);
+  EXPECT_TRUE(NULL != other->GetMessage("DBW_FaultText"));
+}
+
+TEST(DbcRegistry, ReleasedDbcIsDropped)
+{
+  {
+    std::shared_ptr<const NewEagle::Dbc> dbc = NewEagle::DbcRegistry::Load(TEST_DBC, "");
+    EXPECT_EQ(1u, NewEagle::DbcRegistry::GetCount());
+  }
+
+  EXPECT_EQ(0u, NewEagle::DbcRegistry::GetCount());
+}
+
+TEST(DbcRegistry, ConcurrentLoadsShareOneDbc)
+{
+  std::vector<std::shared_ptr<const NewEagle::Dbc> > loaded(8);
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < loaded.size(); i++)
+  {
+    threads.push_back(std::thread([&loaded, i]() { loaded[i] = NewEagle::DbcRegistry::Load(TEST_DBC, ""); }));
+  }
+
+  for (size_t i = 0; i < threads.size(); i++)
+  {
+    threads[i].join();
+  }
+
+  for (size_t i = 1; i < loaded.size(); i++)
+  {
+    EXPECT_EQ(loaded[0].get(), loaded[i].get());
+  }
+}
+
+TEST(DbcRegistry, SharedDbcDecodesWithoutChangingIt)
+{
+  std::shared_ptr<const NewEagle::Dbc> dbc = NewEagle::DbcRegistry::Load(TEST_DBC, "");
+  const NewEagle::DbcMessage* message = dbc->ResolveMessage("DBW_Misc");
+  const NewEagle::DbcSignal* speed = message->ResolveSignal("Speed");
+
+  double before = speed->GetResult();
+
+  uint8_t data[8] = {0x00, 0xF4, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00};
+  NewEagle::DecodedFrame frame;
+  message->Decode(data, frame);
+
+  EXPECT_DOUBLE_EQ(500 * 0.01 - 5, frame.GetValue(speed));
+  EXPECT_EQ(before, speed->GetResult());
+
+  uint8_t encoded[8];
+  message->Encode(frame, encoded);
+  EXPECT_EQ(0, memcmp(data, encoded, sizeof(data)));
+}
+
+TEST(DbcRegistry, DecodedValuesEncodeBackToTheirRaw)
+{
+  std::shared_ptr<const NewEagle::Dbc> dbc = NewEagle::DbcRegistry::Load(TEST_DBC, "");
+  const NewEagle::DbcMessage* message = dbc->ResolveMessage("DBW_Misc");
+
+  // A gain of 0.01 scales many raws to a hair below their step; they must not lose one.
+  for (uint32_t raw = 0; raw < 0x10000; raw++)
+  {
+    uint8_t data[8] = {0x00, (uint8_t)raw, (uint8_t)(raw >> 8), 0x00, 0x00, 0x00, 0x00, 0x00};
+    NewEagle::DecodedFrame frame;
+    message->Decode(data, frame);
+
+    uint8_t encoded[8];
+    message->Encode(frame, encoded);
+    ASSERT_EQ(0, memcmp(data, encoded, sizeof(data))) << raw;
+  }
+}
+
+TEST(DbcRegistry, MissingFileThrows)
+{
+  EXPECT_THROW(NewEagle::DbcRegistry::LoadFile("/nonexistent/file.dbc", ""), std::runtime_error);
+}
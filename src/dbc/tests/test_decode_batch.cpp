@@ -0,0 +1,142 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks that every DecodeBatch kernel matches SetFrame/GetResult bit for bit.
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <dbc/DbcBatch.h>
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+#include "test_message.h"
+
+namespace
+{
+  const size_t FRAME_COUNT = 1003; // not a multiple of the vector width, so the tails run too
+
+  // The shared message plus signals that overlap it, which decoding allows: a Motorola
+  //  signal spanning three bytes and a full 64 bit one.
+  NewEagle::DbcMessage BatchMessage()
+  {
+    NewEagle::DbcMessage message = dbc_test::TestMessage();
+
+    message.AddSignal("Motorola20", NewEagle::DbcSignal(8, 1, 0, 39, NewEagle::BIG_END, 20, NewEagle::SIGNED, "Motorola20", NewEagle::NONE));
+    message.AddSignal("Wide", NewEagle::DbcSignal(8, 1, 0, 0, NewEagle::LITTLE_END, 64, NewEagle::UNSIGNED, "Wide", NewEagle::NONE));
+
+    return message;
+  }
+
+  void ExpectKernelMatchesRuntime(NewEagle::BatchKernel kernel)
+  {
+    NewEagle::DbcMessage message = BatchMessage();
+
+    srand(7);
+    std::vector<uint8_t> payload(FRAME_COUNT * 8);
+    for (size_t i = 0; i < payload.size(); i++)
+    {
+      payload[i] = (uint8_t)rand();
+    }
+
+    const uint8_t (*frames)[8] = (const uint8_t (*)[8])&payload[0];
+
+    NewEagle::SignalColumns columns;
+    NewEagle::DecodeBatch(message, frames, FRAME_COUNT, columns, kernel);
+
+    ASSERT_EQ(FRAME_COUNT, columns.FrameCount);
+    ASSERT_EQ(message.GetSignalCount(), columns.Names.size());
+
+    for (size_t i = 0; i < FRAME_COUNT; i++)
+    {
+      can_msgs::Frame* frame = new can_msgs::Frame();
+      memcpy(frame->data.elems, frames[i], 8);
+      message.SetFrame(can_msgs::Frame::ConstPtr(frame));
+
+      double page = message.GetSignal("Switch")->GetResult();
+
+      for (size_t c = 0; c < columns.Names.size(); c++)
+      {
+        NewEagle::DbcSignal* signal = message.GetSignal(columns.Names[c]);
+        double actual = columns.Values[c][i];
+
+        if (NewEagle::MUX_SIGNAL == signal->GetMultiplexerMode() && page != signal->GetMultiplexerSwitch())
+        {
+          EXPECT_TRUE(isnan(actual)) << columns.Names[c] << " row " << i;
+          continue;
+        }
+
+        double expected = signal->GetResult();
+        ASSERT_EQ(0, memcmp(&expected, &actual, sizeof(double)))
+          << columns.Names[c] << " row " << i << ": " << expected << " != " << actual;
+      }
+    }
+  }
+}
+
+TEST(DecodeBatch, ScalarMatchesRuntime)
+{
+  ExpectKernelMatchesRuntime(NewEagle::BATCH_SCALAR);
+}
+
+TEST(DecodeBatch, VectorKernelsMatchRuntime)
+{
+  NewEagle::BatchKernel best = NewEagle::GetBatchKernel();
+
+  if (best >= NewEagle::BATCH_SSE4)
+  {
+    ExpectKernelMatchesRuntime(NewEagle::BATCH_SSE4);
+  }
+
+  if (best >= NewEagle::BATCH_AVX2)
+  {
+    ExpectKernelMatchesRuntime(NewEagle::BATCH_AVX2);
+  }
+}
+
+TEST(DecodeBatch, Empty)
+{
+  NewEagle::SignalColumns columns;
+  NewEagle::DecodeBatch(BatchMessage(), NULL, 0, columns);
+
+  EXPECT_EQ(0u, columns.FrameCount);
+  EXPECT_TRUE(columns.Values[0].empty());
+  EXPECT_TRUE(NULL != columns.GetColumn("IntelU"));
+  EXPECT_TRUE(NULL == columns.GetColumn("Missing"));
+}
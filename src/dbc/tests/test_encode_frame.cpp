@@ -0,0 +1,287 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks that EncodeFrame, which re-packs only dirty signals, matches a full pack.
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+#include "test_message.h"
+
+namespace
+{
+  // A copy starts with every signal dirty, so its frame is a full pack of the same values.
+  void ExpectMatchesFullPack(NewEagle::DbcMessage &message)
+  {
+    can_msgs::Frame incremental;
+    message.EncodeFrame(incremental);
+
+    NewEagle::DbcMessage copy(message);
+    can_msgs::Frame full = copy.GetFrame();
+
+    ASSERT_EQ(0, memcmp(full.data.elems, incremental.data.elems, 8));
+    EXPECT_EQ(full.id, incremental.id);
+    EXPECT_EQ(full.dlc, incremental.dlc);
+    EXPECT_EQ(full.is_extended, incremental.is_extended);
+  }
+
+  void SetRandom(NewEagle::DbcSignal* signal)
+  {
+    double raw = rand() % (1 << signal->GetLength());
+    signal->SetResult(raw * signal->GetGain() + signal->GetOffset());
+  }
+}
+
+TEST(EncodeFrame, DirtySignalsMatchFullPack)
+{
+  NewEagle::DbcMessage message = dbc_test::TestMessage();
+  std::map<std::string, NewEagle::DbcSignal>* signals = message.GetSignals();
+
+  srand(11);
+  for (int i = 0; i < 2000; i++)
+  {
+    std::map<std::string, NewEagle::DbcSignal>::iterator it = signals->begin();
+    std::advance(it, rand() % signals->size());
+    SetRandom(&it->second);
+
+    ExpectMatchesFullPack(message);
+  }
+}
+
+TEST(EncodeFrame, ReceivedFrameIsReencoded)
+{
+  for (int lazy = 0; lazy < 2; lazy++)
+  {
+    NewEagle::DbcMessage message = dbc_test::TestMessage();
+    message.SetLazyDecode(lazy != 0);
+
+    srand(13);
+    for (int i = 0; i < 200; i++)
+    {
+      can_msgs::Frame* frame = new can_msgs::Frame();
+      for (int b = 0; b < 8; b++)
+      {
+        frame->data[b] = (uint8_t)rand();
+      }
+      message.SetFrame(can_msgs::Frame::ConstPtr(frame));
+
+      SetRandom(message.GetSignal("IntelS"));
+
+      ExpectMatchesFullPack(message);
+    }
+  }
+}
+
+TEST(EncodeFrame, UnchangedValueKeepsFrame)
+{
+  NewEagle::DbcMessage message = dbc_test::TestMessage();
+  message.GetSignal("IntelU")->SetResult(12.3);
+
+  can_msgs::Frame first;
+  message.EncodeFrame(first);
+
+  message.GetSignal("IntelU")->SetResult(12.3);
+
+  uint8_t data[8];
+  message.EncodeFrame(data);
+
+  EXPECT_EQ(0, memcmp(first.data.elems, data, 8));
+}
+
+TEST(EncodeFrame, ReceivedRawValuesRoundTrip)
+{
+  for (int lazy = 0; lazy < 2; lazy++)
+  {
+    NewEagle::DbcMessage message = dbc_test::TestMessage();
+    message.SetLazyDecode(lazy != 0);
+    std::map<std::string, NewEagle::DbcSignal>* signals = message.GetSignals();
+
+    srand(17);
+    for (int i = 0; i < 200; i++)
+    {
+      can_msgs::Frame* frame = new can_msgs::Frame();
+      for (int b = 0; b < 8; b++)
+      {
+        frame->data[b] = (uint8_t)rand();
+      }
+      message.SetFrame(can_msgs::Frame::ConstPtr(frame));
+
+      std::map<std::string, int64_t> raws;
+      for (std::map<std::string, NewEagle::DbcSignal>::iterator it = signals->begin(); it != signals->end(); it++)
+      {
+        raws[it->first] = it->second.GetRaw();
+      }
+
+      // Re-encoding packs the received raw values, not a conversion back from the scaled ones.
+      can_msgs::Frame* encoded = new can_msgs::Frame(message.GetFrame());
+      message.SetFrame(can_msgs::Frame::ConstPtr(encoded));
+
+      for (std::map<std::string, NewEagle::DbcSignal>::iterator it = signals->begin(); it != signals->end(); it++)
+      {
+        ASSERT_EQ(raws[it->first], it->second.GetRaw()) << it->first;
+      }
+    }
+  }
+}
+
+TEST(EncodeFrame, RawAccessSkipsScaling)
+{
+  NewEagle::DbcMessage message = dbc_test::TestMessage();
+  NewEagle::DbcSignal* intelS = message.GetSignal("IntelS");
+
+  intelS->SetRaw(-3);
+  EXPECT_EQ(-3, intelS->GetRawAs<int16_t>());
+  EXPECT_DOUBLE_EQ(-3 * 0.0625 - 40, intelS->GetResult());
+
+  intelS->SetResult(-40.125);
+  EXPECT_EQ(-2, intelS->GetRaw());
+
+  message.GetSignal("Switch")->SetRaw(2);
+  message.GetSignal("Page2")->SetRaw(0x1234);
+
+  uint8_t data[8];
+  message.EncodeFrame(data);
+
+  EXPECT_EQ(2, data[0] & 0x03);
+  EXPECT_EQ(0x34, data[6]);
+  EXPECT_EQ(0x12, data[7]);
+
+  NewEagle::DbcMessage received = dbc_test::TestMessage();
+  received.SetFrame(data, 8);
+
+  EXPECT_TRUE(received.GetSignal("Switch")->GetRawAs<bool>());
+  EXPECT_EQ(0x34, received.GetSignal("Page2")->GetRawAs<uint8_t>());
+  EXPECT_EQ(-2, received.GetSignal("IntelS")->GetRaw());
+}
+
+TEST(EncodeFrame, ResetToDefaultsMatchesFullPack)
+{
+  for (int lazy = 0; lazy < 2; lazy++)
+  {
+    NewEagle::DbcMessage message = dbc_test::TestMessage();
+    message.SetLazyDecode(lazy != 0);
+    std::map<std::string, NewEagle::DbcSignal>* signals = message.GetSignals();
+
+    message.GetSignal("IntelU")->SetInitialValue(12.3);
+    message.GetSignal("Motorola")->SetInitialValue(-5);
+    message.GetSignal("Switch")->SetInitialValue(2);
+    message.GetSignal("Page2")->SetInitialValue(-7);
+
+    srand(19);
+    for (int i = 0; i < 200; i++)
+    {
+      can_msgs::Frame* frame = new can_msgs::Frame();
+      for (int b = 0; b < 8; b++)
+      {
+        frame->data[b] = (uint8_t)rand();
+      }
+      message.SetFrame(can_msgs::Frame::ConstPtr(frame));
+
+      message.ResetToDefaults();
+
+      EXPECT_DOUBLE_EQ(12.3, message.GetSignal("IntelU")->GetResult());
+      EXPECT_DOUBLE_EQ(-40, message.GetSignal("IntelS")->GetResult()); // no start value, so raw 0
+      EXPECT_EQ(-5, message.GetSignal("Motorola")->GetRaw());
+      EXPECT_EQ(-16, message.GetSignal("Page2")->GetRaw());
+
+      std::map<std::string, NewEagle::DbcSignal>::iterator it = signals->begin();
+      std::advance(it, rand() % signals->size());
+      SetRandom(&it->second);
+
+      ExpectMatchesFullPack(message);
+    }
+  }
+}
+
+TEST(EncodeFrame, DecodedFrameDefaultsMatchResetToDefaults)
+{
+  NewEagle::DbcMessage message = dbc_test::TestMessage();
+
+  message.GetSignal("IntelU")->SetInitialValue(12.3);
+  message.GetSignal("Motorola")->SetInitialValue(-5);
+  message.GetSignal("Switch")->SetInitialValue(2);
+  message.GetSignal("Page2")->SetInitialValue(-7);
+
+  const NewEagle::DbcMessage &shared = message;
+  NewEagle::DecodedFrame frame;
+  shared.ResetToDefaults(frame);
+
+  uint8_t encoded[8];
+  shared.Encode(frame, encoded);
+
+  message.ResetToDefaults();
+  uint8_t reset[8];
+  message.EncodeFrame(reset);
+
+  EXPECT_EQ(0, memcmp(reset, encoded, 8));
+  EXPECT_EQ(-5, frame.GetRaw(shared.GetSignal("Motorola")));
+  EXPECT_EQ(-16, frame.GetRaw(shared.GetSignal("Page2")));
+}
+
+TEST(EncodeFrame, DecodedFrameRawAccessSkipsScaling)
+{
+  const NewEagle::DbcMessage message = dbc_test::TestMessage();
+  const NewEagle::DbcSignal* intelS = message.GetSignal("IntelS");
+
+  NewEagle::DecodedFrame frame;
+  message.ResetToDefaults(frame);
+
+  frame.SetRaw(intelS, -3);
+  EXPECT_EQ(-3, frame.GetRawAs<int16_t>(intelS));
+  EXPECT_DOUBLE_EQ(-3 * 0.0625 - 40, frame.GetValue(intelS));
+
+  frame.SetValue(intelS, -40.125);
+  EXPECT_EQ(-2, frame.GetRaw(intelS));
+}
+
+TEST(EncodeFrame, ResetAfterFrameDecodesRepeat)
+{
+  NewEagle::DbcMessage message = dbc_test::TestMessage();
+  uint8_t data[8] = {0x00, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+
+  ASSERT_TRUE(message.SetFrame(data, 8));
+  message.ResetToDefaults();
+
+  // The reset replaced the decoded values, so the same payload is decoded again.
+  EXPECT_TRUE(message.SetFrame(data, 8));
+  EXPECT_EQ(0x77, message.GetSignal("Page0")->GetRaw());
+}
@@ -0,0 +1,119 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks that SetFrame skips a payload that repeats the last one, and only then.
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+namespace
+{
+  NewEagle::DbcMessage TestMessage(bool lazy)
+  {
+    NewEagle::DbcMessage message(8, 0x300, NewEagle::STD, "Report", 0x300);
+
+    message.AddSignal("Pressure", NewEagle::DbcSignal(8, 0.5, 0, 0, NewEagle::LITTLE_END, 16, NewEagle::UNSIGNED, "Pressure", NewEagle::NONE));
+    message.AddSignal("Valid", NewEagle::DbcSignal(8, 1, 0, 16, NewEagle::LITTLE_END, 1, NewEagle::UNSIGNED, "Valid", NewEagle::NONE));
+    message.SetLazyDecode(lazy);
+
+    return message;
+  }
+}
+
+TEST(FrameRepeats, RepeatedPayloadIsSkipped)
+{
+  for (int lazy = 0; lazy < 2; lazy++)
+  {
+    NewEagle::DbcMessage message = TestMessage(lazy != 0);
+    uint8_t data[8] = { 0x10, 0x02, 0x01, 0, 0, 0, 0, 0 };
+
+    EXPECT_TRUE(message.SetFrame(data, 8));
+    EXPECT_FALSE(message.SetFrame(data, 8));
+    EXPECT_DOUBLE_EQ(0x210 * 0.5, message.GetSignal("Pressure")->GetResult());
+    EXPECT_FALSE(message.SetFrame(data, 8));
+
+    data[0] = 0x11;
+    EXPECT_TRUE(message.SetFrame(data, 8));
+    EXPECT_DOUBLE_EQ(0x211 * 0.5, message.GetSignal("Pressure")->GetResult());
+
+    NewEagle::DbcFrameStats stats = message.GetFrameStats();
+    EXPECT_EQ(4u, stats.Frames);
+    EXPECT_EQ(2u, stats.Repeats);
+
+    message.ResetFrameStats();
+    EXPECT_EQ(0u, message.GetFrameStats().Frames);
+  }
+}
+
+TEST(FrameRepeats, SetSignalIsDecodedAgain)
+{
+  for (int lazy = 0; lazy < 2; lazy++)
+  {
+    NewEagle::DbcMessage message = TestMessage(lazy != 0);
+    uint8_t data[8] = { 0x10, 0x02, 0x01, 0, 0, 0, 0, 0 };
+
+    message.SetFrame(data, 8);
+    message.GetSignal("Valid")->SetRaw(0);
+
+    // The signals no longer hold the decode of this payload, so it is not a repeat.
+    EXPECT_TRUE(message.SetFrame(data, 8));
+    EXPECT_TRUE(message.GetSignal("Valid")->GetRawAs<bool>());
+
+    // Setting the value a signal already holds changes nothing.
+    message.GetSignal("Valid")->SetRaw(1);
+    EXPECT_FALSE(message.SetFrame(data, 8));
+
+    // A result that encodes to the same raw value is still replaced by the decode.
+    message.GetSignal("Pressure")->SetResult(0x210 * 0.5 + 0.25);
+    EXPECT_TRUE(message.SetFrame(data, 8));
+    EXPECT_DOUBLE_EQ(0x210 * 0.5, message.GetSignal("Pressure")->GetResult());
+  }
+}
+
+TEST(FrameRepeats, ShortFrameMatchesPaddedPayload)
+{
+  NewEagle::DbcMessage message = TestMessage(false);
+  uint8_t data[8] = { 0x10, 0x02, 0x01, 0, 0, 0, 0, 0 };
+
+  EXPECT_TRUE(message.SetFrame(data, 8));
+  EXPECT_FALSE(message.SetFrame(data, 3));
+
+  data[3] = 0xFF;
+  EXPECT_TRUE(message.SetFrame(data, 8));
+  EXPECT_TRUE(message.SetFrame(data, 3));
+}
@@ -0,0 +1,60 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _DBC_TEST_MESSAGE_H
+#define _DBC_TEST_MESSAGE_H
+
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+namespace dbc_test
+{
+  // Shared by the frame tests: a 2 bit mux switch, Intel signals unsigned and signed,
+  //  a Motorola signal and two pages, none of which overlap.
+  inline NewEagle::DbcMessage TestMessage()
+  {
+    NewEagle::DbcMessage message(8, 0x123, NewEagle::EXT, "Test", 0x80000123);
+
+    message.AddSignal("Switch", NewEagle::DbcSignal(8, 1, 0, 0, NewEagle::LITTLE_END, 2, NewEagle::UNSIGNED, "Switch", NewEagle::MUX_SWITCH));
+    message.AddSignal("IntelU", NewEagle::DbcSignal(8, 0.1, 0, 2, NewEagle::LITTLE_END, 14, NewEagle::UNSIGNED, "IntelU", NewEagle::NONE));
+    message.AddSignal("IntelS", NewEagle::DbcSignal(8, 0.0625, -40, 16, NewEagle::LITTLE_END, 13, NewEagle::SIGNED, "IntelS", NewEagle::NONE));
+    message.AddSignal("Motorola", NewEagle::DbcSignal(8, 1, 0, 39, NewEagle::BIG_END, 12, NewEagle::SIGNED, "Motorola", NewEagle::NONE));
+    message.AddSignal("Page0", NewEagle::DbcSignal(8, 1, 0, 48, NewEagle::LITTLE_END, 8, NewEagle::UNSIGNED, "Page0", NewEagle::MUX_SIGNAL, 0));
+    message.AddSignal("Page2", NewEagle::DbcSignal(8, 0.5, 1, 48, NewEagle::LITTLE_END, 16, NewEagle::SIGNED, "Page2", NewEagle::MUX_SIGNAL, 2));
+
+    return message;
+  }
+}
+
+#endif // _DBC_TEST_MESSAGE_H
@@ -0,0 +1,168 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Checks that multiplexed signals are decoded and encoded only for the page the switch selects.
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+namespace
+{
+  // Every page reads byte 1 with its own gain, so the decoded value tells which page ran.
+  NewEagle::DbcMessage PagedMessage(uint8_t switchLength, const int32_t* pages, size_t count)
+  {
+    NewEagle::DbcMessage message(8, 0x200, NewEagle::STD, "Paged", 0x200);
+
+    message.AddSignal("Switch", NewEagle::DbcSignal(8, 1, 0, 32, NewEagle::LITTLE_END, switchLength, NewEagle::UNSIGNED, "Switch", NewEagle::MUX_SWITCH));
+    message.AddSignal("Counter", NewEagle::DbcSignal(8, 1, 0, 0, NewEagle::LITTLE_END, 8, NewEagle::UNSIGNED, "Counter", NewEagle::NONE));
+
+    for (size_t i = 0; i < count; i++)
+    {
+      std::string name = "Page" + std::to_string(pages[i]);
+      message.AddSignal(name, NewEagle::DbcSignal(8, i + 1, 0, 8, NewEagle::LITTLE_END, 8, NewEagle::UNSIGNED, name, NewEagle::MUX_SIGNAL, pages[i]));
+    }
+
+    return message;
+  }
+
+  void FillFrame(uint8_t* data, uint32_t muxValue)
+  {
+    memset(data, 0, 8);
+    data[0] = 0x5A;
+    data[1] = 0x21;
+    memcpy(&data[4], &muxValue, sizeof(muxValue));
+  }
+
+  void ExpectOnlyPage(NewEagle::DbcMessage &message, const int32_t* pages, size_t count, uint32_t muxValue)
+  {
+    uint8_t data[8];
+    FillFrame(data, muxValue);
+
+    NewEagle::DecodedFrame frame;
+    message.Decode(data, frame);
+
+    EXPECT_EQ(0x5A, frame.GetValue(message.GetSignal("Counter")));
+    EXPECT_EQ(muxValue, frame.GetValue(message.GetSignal("Switch")));
+
+    for (size_t i = 0; i < count; i++)
+    {
+      const NewEagle::DbcSignal* signal = message.GetSignal("Page" + std::to_string(pages[i]));
+      double expected = ((uint32_t)pages[i] == muxValue) ? 0x21 * (double)(i + 1) : 0;
+
+      EXPECT_EQ(expected, frame.GetValue(signal)) << "switch " << muxValue << ", page " << pages[i];
+    }
+  }
+}
+
+TEST(MuxPages, DecodesSelectedPageOnly)
+{
+  const int32_t pages[] = { 0, 3, 7, 200 };
+  NewEagle::DbcMessage message = PagedMessage(8, pages, 4);
+
+  for (uint32_t muxValue = 0; muxValue < 256; muxValue++)
+  {
+    ExpectOnlyPage(message, pages, 4, muxValue);
+  }
+}
+
+TEST(MuxPages, SparseSwitchValues)
+{
+  // Too wide a range for a direct table, so pages are found by search.
+  const int32_t pages[] = { 1, 4096, 70000, 2000000000 };
+  NewEagle::DbcMessage message = PagedMessage(32, pages, 4);
+
+  const uint32_t muxValues[] = { 0, 1, 2, 4095, 4096, 4097, 70000, 1999999999, 2000000000, 4000000000u };
+
+  for (size_t i = 0; i < sizeof(muxValues) / sizeof(muxValues[0]); i++)
+  {
+    ExpectOnlyPage(message, pages, 4, muxValues[i]);
+  }
+}
+
+TEST(MuxPages, SetFrameKeepsOtherPages)
+{
+  const int32_t pages[] = { 2, 5 };
+  NewEagle::DbcMessage message = PagedMessage(8, pages, 2);
+
+  uint8_t data[8];
+  FillFrame(data, 5);
+  message.SetFrame(data, 8);
+
+  EXPECT_EQ(0, message.GetSignal("Page2")->GetResult());
+  EXPECT_EQ(0x21 * 2, message.GetSignal("Page5")->GetResult());
+
+  // A switch value with no page leaves every page signal as it was.
+  FillFrame(data, 9);
+  data[1] = 0x10;
+  message.SetFrame(data, 8);
+
+  EXPECT_EQ(0, message.GetSignal("Page2")->GetResult());
+  EXPECT_EQ(0x21 * 2, message.GetSignal("Page5")->GetResult());
+
+  FillFrame(data, 2);
+  data[1] = 0x10;
+  message.SetFrame(data, 8);
+
+  EXPECT_EQ(0x10, message.GetSignal("Page2")->GetResult());
+  EXPECT_EQ(0x21 * 2, message.GetSignal("Page5")->GetResult());
+}
+
+TEST(MuxPages, EncodesSelectedPageOnly)
+{
+  const int32_t pages[] = { 2, 5 };
+  NewEagle::DbcMessage message = PagedMessage(8, pages, 2);
+
+  NewEagle::DecodedFrame frame;
+  uint8_t data[8] = { 0 };
+  message.Decode(data, frame);
+
+  frame.SetValue(message.GetSignal("Page2"), 0x11);
+  frame.SetValue(message.GetSignal("Page5"), 0x22 * 2);
+
+  frame.SetValue(message.GetSignal("Switch"), 5);
+  message.Encode(frame, data);
+  EXPECT_EQ(0x22, data[1]);
+
+  frame.SetValue(message.GetSignal("Switch"), 2);
+  message.Encode(frame, data);
+  EXPECT_EQ(0x11, data[1]);
+
+  frame.SetValue(message.GetSignal("Switch"), 3);
+  message.Encode(frame, data);
+  EXPECT_EQ(0, data[1]);
+}
@@ -73,6 +73,10 @@ enum {
   ID_LOW_VOLTAGE_SYSTEM_REPORT  = 0x1F11,
   ID_BRAKE_2_REPORT             = 0x1F12,
   ID_STEERING_2_REPORT          = 0x1F13,
+
+  // Every report ID above falls in this range, which DbwNode's dispatch table covers.
+  ID_REPORT_FIRST               = ID_MISC_REPORT,
+  ID_REPORT_COUNT               = ID_STEERING_2_REPORT - ID_REPORT_FIRST + 1,
 };
 
 } //dbw_pacifica_can
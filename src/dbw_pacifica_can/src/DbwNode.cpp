@@ -35,26 +35,27 @@
 
 #include "DbwNode.h"
 #include <dbw_pacifica_can/dispatch.h>
+#include <boost/make_shared.hpp>
+#include <stdexcept>
+#include <string.h>
 
 namespace dbw_pacifica_can
 {
 
 DbwNode::DbwNode(ros::NodeHandle &node, ros::NodeHandle &priv_nh)
 {
-  priv_nh.getParam("dbw_dbc_file", dbcFile_);
+  // The DBC is read from dbw_dbc_path when it is set, otherwise from the text in dbw_dbc_file.
+  priv_nh.getParam("dbw_dbc_path", dbcPath_);
+  if (dbcPath_.empty()) {
+    priv_nh.getParam("dbw_dbc_file", dbcFile_);
+  }
+
+  // Built DBCs are cached by content hash so a restart skips parsing; set to "" to disable.
+  dbcCacheDir_ = NewEagle::DbcCache::DefaultDirectory();
+  priv_nh.getParam("dbc_cache_dir", dbcCacheDir_);
 
   // Initialize enable state machine
-  prev_enable_ = true;
-  enable_ = false;
-  override_brake_ = false;
-  override_accelerator_pedal_ = false;
-  override_steering_ = false;
-  override_gear_ = false;
-  fault_brakes_ = false;
-  fault_accelerator_pedal_ = false;
-  fault_steering_ = false;
-  fault_steering_cal_ = false;
-  fault_watchdog_ = false;
+  state_ = 0;
   fault_watchdog_using_brakes_ = false;
   fault_watchdog_warned_ = false;
   timeout_brakes_ = false;
@@ -64,6 +65,10 @@ DbwNode::DbwNode(ros::NodeHandle &node, ros::NodeHandle &priv_nh)
   enabled_accelerator_pedal_ = false;
   enabled_steering_ = false;
   gear_warned_ = false;
+  rx_generation_ = 0;
+  tire_pressure_payload_.valid = false;
+  low_voltage_system_payload_.valid = false;
+  dbc_generation_ = 0;
 
   // Frame ID
   frame_id_ = "base_footprint";
@@ -117,31 +122,195 @@ DbwNode::DbwNode(ros::NodeHandle &node, ros::NodeHandle &priv_nh)
   pub_driver_input_ = node.advertise<dbw_pacifica_msgs::DriverInputReport>("driver_input_report", 2);
   pub_misc_ = node.advertise<dbw_pacifica_msgs::MiscReport>("misc_report", 2);
   pub_sys_enable_ = node.advertise<std_msgs::Bool>("dbw_enabled", 1, true);
-  publishDbwEnabled();
+  std_msgs::Bool enabled_msg;
+  enabled_msg.data = enabled();
+  pub_sys_enable_.publish(enabled_msg);
 
   // Set up Subscribers
-  sub_enable_ = node.subscribe("enable", 10, &DbwNode::recvEnable, this, ros::TransportHints().tcpNoDelay(true));
-  sub_disable_ = node.subscribe("disable", 10, &DbwNode::recvDisable, this, ros::TransportHints().tcpNoDelay(true));
-  sub_can_ = node.subscribe("can_rx", 100, &DbwNode::recvCAN, this, ros::TransportHints().tcpNoDelay(true));
-  sub_brake_ = node.subscribe("brake_cmd", 1, &DbwNode::recvBrakeCmd, this, ros::TransportHints().tcpNoDelay(true));
-  sub_accelerator_pedal_ = node.subscribe("accelerator_pedal_cmd", 1, &DbwNode::recvAcceleratorPedalCmd, this, ros::TransportHints().tcpNoDelay(true));
-  sub_steering_ = node.subscribe("steering_cmd", 1, &DbwNode::recvSteeringCmd, this, ros::TransportHints().tcpNoDelay(true));
-  sub_gear_ = node.subscribe("gear_cmd", 1, &DbwNode::recvGearCmd, this, ros::TransportHints().tcpNoDelay(true));
-  sub_misc_ = node.subscribe("misc_cmd", 1, &DbwNode::recvMiscCmd, this, ros::TransportHints().tcpNoDelay(true));
-  sub_global_enable_ = node.subscribe("global_enable_cmd", 1, &DbwNode::recvGlobalEnableCmd, this, ros::TransportHints().tcpNoDelay(true));
+  ros::NodeHandle rx_node(node);
+  ros::NodeHandle cmd_node(node);
+  rx_node.setCallbackQueue(&rx_queue_);
+  cmd_node.setCallbackQueue(&cmd_queue_);
+
+  sub_enable_ = cmd_node.subscribe("enable", 10, &DbwNode::recvEnable, this, ros::TransportHints().tcpNoDelay(true));
+  sub_disable_ = cmd_node.subscribe("disable", 10, &DbwNode::recvDisable, this, ros::TransportHints().tcpNoDelay(true));
+  sub_can_ = rx_node.subscribe("can_rx", 100, &DbwNode::recvCAN, this, ros::TransportHints().tcpNoDelay(true));
+  sub_can_array_ = rx_node.subscribe("can_rx_array", 10, &DbwNode::recvCANArray, this, ros::TransportHints().tcpNoDelay(true));
+  sub_brake_ = cmd_node.subscribe("brake_cmd", 1, &DbwNode::recvBrakeCmd, this, ros::TransportHints().tcpNoDelay(true));
+  sub_accelerator_pedal_ = cmd_node.subscribe("accelerator_pedal_cmd", 1, &DbwNode::recvAcceleratorPedalCmd, this, ros::TransportHints().tcpNoDelay(true));
+  sub_steering_ = cmd_node.subscribe("steering_cmd", 1, &DbwNode::recvSteeringCmd, this, ros::TransportHints().tcpNoDelay(true));
+  sub_gear_ = cmd_node.subscribe("gear_cmd", 1, &DbwNode::recvGearCmd, this, ros::TransportHints().tcpNoDelay(true));
+  sub_misc_ = cmd_node.subscribe("misc_cmd", 1, &DbwNode::recvMiscCmd, this, ros::TransportHints().tcpNoDelay(true));
+  sub_global_enable_ = cmd_node.subscribe("global_enable_cmd", 1, &DbwNode::recvGlobalEnableCmd, this, ros::TransportHints().tcpNoDelay(true));
 
 
   pdu1_relay_pub_ = node.advertise<pdu_msgs::RelayCommand>("/pduB/relay_cmd", 1000);
   count_ = 0;
 
-  dbwDbc_ = NewEagle::DbcBuilder().NewDbc(dbcFile_);
+  try {
+    dbc_ = loadDbc(dbcPath_, dbcFile_);
+  } catch (const std::runtime_error &e) {
+    ROS_FATAL("DBW DBC could not be loaded: %s", e.what());
+    throw;
+  }
+
+  ros::AdvertiseServiceOptions reloadOptions = ros::AdvertiseServiceOptions::create<dbw_pacifica_msgs::ReloadDbc>(
+    "reload_dbc", boost::bind(&DbwNode::reloadDbc, this, _1, _2), ros::VoidConstPtr(), &reload_queue_);
+  srv_reload_dbc_ = node.advertiseService(reloadOptions);
+  reload_spinner_.reset(new ros::AsyncSpinner(1, &reload_queue_));
+  reload_spinner_->start();
 
   // Set up Timer
-  timer_ = node.createTimer(ros::Duration(1 / 20.0), &DbwNode::timerCallback, this);
+  ros::NodeHandle timer_node(node);
+  timer_node.setCallbackQueue(&timer_queue_);
+  timer_ = timer_node.createTimer(ros::Duration(1 / 20.0), &DbwNode::timerCallback, this);
+
+  // One thread per queue: the handlers on a queue share a DecodedFrame and pools.
+  rx_spinner_.reset(new ros::AsyncSpinner(1, &rx_queue_));
+  cmd_spinner_.reset(new ros::AsyncSpinner(1, &cmd_queue_));
+  timer_spinner_.reset(new ros::AsyncSpinner(1, &timer_queue_));
+  rx_spinner_->start();
+  cmd_spinner_->start();
+  timer_spinner_->start();
 }
 
 DbwNode::~DbwNode()
 {
+  // The reload thread is gone once its spinner is, so the last DBC is freed here.
+  reload_spinner_.reset();
+  rx_spinner_.reset();
+  cmd_spinner_.reset();
+  timer_spinner_.reset();
+  dbc_.reset();
+  reload_queue_.callAvailable();
+}
+
+ros::CallbackInterface::CallResult DbwNode::DbwDbcRelease::call()
+{
+  dbc_.reset();
+  return Success;
+}
+
+// Deleter of every loaded DbwDbc.  Freeing one can mean freeing its DBC, which is too slow
+//  for the callback that happens to drop the last reference, so it is left to reload_queue_.
+void DbwNode::releaseDbc(DbwDbc *dbc)
+{
+  reload_queue_.addCallback(boost::make_shared<DbwDbcRelease>(dbc));
+}
+
+// Throws std::runtime_error when the DBC cannot be read or lacks a message or signal DbwNode uses.
+std::shared_ptr<DbwNode::DbwDbc> DbwNode::loadDbc(const std::string &path, const std::string &text)
+{
+  std::shared_ptr<DbwDbc> loaded(new DbwDbc(), boost::bind(&DbwNode::releaseDbc, this, _1));
+  loaded->generation = ++dbc_generation_;
+
+  // Parsed once per process through the registry and shared read-only with the other
+  //  nodelets that load the same DBC.
+  if (!path.empty()) {
+    loaded->dbc = NewEagle::DbcRegistry::LoadFile(path, dbcCacheDir_);
+  } else {
+    loaded->dbc = NewEagle::DbcRegistry::Load(text, dbcCacheDir_);
+  }
+
+  loaded->signals.Resolve(*loaded->dbc);
+
+  // Until a command is sent, the timer re-sends what a fresh message encodes to.
+  loaded->brakeCmdData = encodedPayload(loaded->signals.brakeCmd.message);
+  loaded->acceleratorPedalCmdData = encodedPayload(loaded->signals.acceleratorPedalCmd.message);
+  loaded->steeringCmdData = encodedPayload(loaded->signals.steeringCmd.message);
+  loaded->gearCmdData = encodedPayload(loaded->signals.gearCmd.message);
+
+  // recvCAN dispatch.  A frame shorter than its message is dropped; the gear report
+  //  has always been taken from its first byte on.
+  const DbwSignals &signals = loaded->signals;
+
+  for (int i = 0; i < ID_REPORT_COUNT; i++) {
+    setRoute(*loaded, ID_REPORT_FIRST + i, NULL, 0);
+  }
+
+  setRoute(*loaded, ID_BRAKE_REPORT, &DbwNode::recvBrakeReport, signals.brakeReport.message->GetDlc());
+  setRoute(*loaded, ID_ACCEL_PEDAL_REPORT, &DbwNode::recvAcceleratorPedalReport, signals.acceleratorPedalReport.message->GetDlc());
+  setRoute(*loaded, ID_STEERING_REPORT, &DbwNode::recvSteeringReport, signals.steeringReport.message->GetDlc());
+  setRoute(*loaded, ID_GEAR_REPORT, &DbwNode::recvGearReport, 1);
+  setRoute(*loaded, ID_REPORT_WHEEL_SPEED, &DbwNode::recvWheelSpeedReport, signals.wheelSpeedReport.message->GetDlc());
+  setRoute(*loaded, ID_REPORT_WHEEL_POSITION, &DbwNode::recvWheelPositionReport, signals.wheelPositionReport.message->GetDlc());
+  setRoute(*loaded, ID_REPORT_TIRE_PRESSURE, &DbwNode::recvTirePressureReport, signals.tirePressureReport.message->GetDlc());
+  setRoute(*loaded, ID_REPORT_SURROUND, &DbwNode::recvSurroundReport, signals.surroundReport.message->GetDlc());
+  setRoute(*loaded, ID_VIN, &DbwNode::recvVin, signals.vinReport.message->GetDlc());
+  setRoute(*loaded, ID_REPORT_IMU, &DbwNode::recvImuReport, signals.imuReport.message->GetDlc());
+  setRoute(*loaded, ID_REPORT_DRIVER_INPUT, &DbwNode::recvDriverInputReport, signals.driverInputReport.message->GetDlc());
+  setRoute(*loaded, ID_MISC_REPORT, &DbwNode::recvMiscReport, signals.miscReport.message->GetDlc());
+  setRoute(*loaded, ID_LOW_VOLTAGE_SYSTEM_REPORT, &DbwNode::recvLowVoltageSystemReport, signals.lowVoltageSystemReport.message->GetDlc());
+  setRoute(*loaded, ID_BRAKE_2_REPORT, &DbwNode::recvBrake2Report, signals.brake2Report.message->GetDlc());
+  setRoute(*loaded, ID_STEERING_2_REPORT, &DbwNode::recvSteering2Report, signals.steering2Report.message->GetDlc());
+
+  return loaded;
+}
+
+uint64_t DbwNode::encodedPayload(const NewEagle::DbcMessage* message)
+{
+  NewEagle::DecodedFrame values;
+  message->ResetToDefaults(values);
+
+  uint8_t data[8] = {0};
+  message->Encode(values, data);
+  return payloadWord(data);
+}
+
+uint64_t DbwNode::payloadWord(const uint8_t* data)
+{
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+void DbwNode::setRoute(DbwDbc &loaded, uint32_t id, ReportHandler handler, uint8_t minDlc)
+{
+  ReportRoute &route = loaded.routes[id - ID_REPORT_FIRST];
+  route.handler = handler;
+  route.minDlc = minDlc;
+}
+
+// Runs on reload_queue_.  The new DBC is built and checked here, then published with one
+//  atomic store; callbacks already holding the old one finish on it.
+bool DbwNode::reloadDbc(dbw_pacifica_msgs::ReloadDbc::Request &req, dbw_pacifica_msgs::ReloadDbc::Response &res)
+{
+  std::shared_ptr<DbwDbc> loaded;
+
+  try {
+    if (!req.dbc_path.empty()) {
+      loaded = loadDbc(req.dbc_path, "");
+    } else {
+      loaded = loadDbc(dbcPath_, dbcFile_);
+    }
+  } catch (const std::runtime_error &e) {
+    res.success = false;
+    res.message = e.what();
+    ROS_ERROR("DBW DBC not reloaded: %s", e.what());
+    return true;
+  }
+
+  // The timer goes on re-sending the last commands.  One that reaches the old DBC between
+  //  these copies and the swap is re-sent from the next command on.
+  std::shared_ptr<DbwDbc> previous = std::atomic_load(&dbc_);
+  loaded->brakeCmdData = previous->brakeCmdData.load();
+  loaded->acceleratorPedalCmdData = previous->acceleratorPedalCmdData.load();
+  loaded->steeringCmdData = previous->steeringCmdData.load();
+  loaded->gearCmdData = previous->gearCmdData.load();
+
+  // Callbacks still holding the old DBC finish on it; the last one out queues its release here.
+  std::atomic_store(&dbc_, loaded);
+  previous.reset();
+
+  if (!req.dbc_path.empty()) {
+    dbcPath_ = req.dbc_path;
+    dbcFile_.clear();
+  }
+
+  res.success = true;
+  res.message = req.dbc_path.empty() ? "Reloaded the configured DBC" : "Loaded " + req.dbc_path;
+  ROS_INFO("DBW DBC reloaded: %s", res.message.c_str());
+  return true;
 }
 
 void DbwNode::recvEnable(const std_msgs::Empty::ConstPtr& msg)
@@ -156,831 +325,898 @@ void DbwNode::recvDisable(const std_msgs::Empty::ConstPtr& msg)
 
 void DbwNode::recvCAN(const can_msgs::Frame::ConstPtr& msg)
 {
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
 
-  if (!msg->is_rtr && !msg->is_error) {
-    switch (msg->id) {
-      case ID_BRAKE_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_BRAKE_REPORT);
+  if (dbc->generation != rx_generation_) {
+    resetReports();
+    rx_generation_ = dbc->generation;
+  }
 
-        if (msg->dlc >= message->GetDlc()) {
-          message->SetFrame(msg);
+  // Commands from another node on the bus fall outside the table and are ignored.
+  uint32_t slot = msg->id - ID_REPORT_FIRST;
 
-          bool faultCh1 = message->GetSignal("DBW_BrakeFault_Ch1")->GetResult() ? true : false;
-          bool faultCh2 = message->GetSignal("DBW_BrakeFault_Ch2")->GetResult() ? true : false;
-          bool brakeSystemFault = message->GetSignal("DBW_BrakeFault")->GetResult() ? true : false;
-          bool dbwSystemFault = brakeSystemFault;
+  if (!msg->is_rtr && !msg->is_error && slot < ID_REPORT_COUNT) {
+    const ReportRoute &route = dbc->routes[slot];
 
-          faultBrakes(faultCh1 && faultCh2);
-          faultWatchdog(dbwSystemFault, brakeSystemFault);
+    if (NULL != route.handler && msg->dlc >= route.minDlc) {
+      (this->*route.handler)(dbc->signals, msg);
+    }
+  }
+#if 0
+  uint32_t state = state_.load();
+  ROS_INFO("ena: %s, clr: %s, brake: %s, Accelerator Pedal: %s, steering: %s, gear: %s",
+           enabled(state) ? "true " : "false",
+           clear(state) ? "true " : "false",
+           (state & STATE_OVERRIDE_BRAKE) ? "true " : "false",
+           (state & STATE_OVERRIDE_ACCELERATOR_PEDAL) ? "true " : "false",
+           (state & STATE_OVERRIDE_STEERING) ? "true " : "false",
+           (state & STATE_OVERRIDE_GEAR) ? "true " : "false"
+       );
+#endif
+}
 
-          overrideBrake(message->GetSignal("DBW_BrakeDriverActivity")->GetResult());
-          dbw_pacifica_msgs::BrakeReport brakeReport;
-          brakeReport.header.stamp = msg->header.stamp;
-          brakeReport.pedal_position  = message->GetSignal("DBW_BrakePdlDriverInput")->GetResult();
-          brakeReport.pedal_output = message->GetSignal("DBW_BrakePdlPosnFdbck")->GetResult();
+// Frames batched by the bridge.  Each one is passed on as a pointer into the array, so
+//  the handlers get the same ConstPtr as from can_rx without a copy.
+void DbwNode::recvCANArray(const kvaser_interface::FrameArray::ConstPtr& msg)
+{
+  for (size_t i = 0; i < msg->frames.size(); i++) {
+    recvCAN(can_msgs::Frame::ConstPtr(msg, &msg->frames[i]));
+  }
+}
 
-          brakeReport.enabled = message->GetSignal("DBW_BrakeEnabled")->GetResult() ? true : false;
-          brakeReport.driver_activity = message->GetSignal("DBW_BrakeDriverActivity")->GetResult() ? true : false;
-          
-          brakeReport.fault_brake_system = brakeSystemFault;
-          
-          brakeReport.fault_ch2 = faultCh2;
+// Drops what the RX thread kept from frames decoded with an earlier DBC.
+void DbwNode::resetReports()
+{
+  tire_pressure_report_ = dbw_pacifica_msgs::TirePressureReport();
+  low_voltage_system_report_ = dbw_pacifica_msgs::LowVoltageSystemReport();
+  tire_pressure_payload_.valid = false;
+  low_voltage_system_payload_.valid = false;
+  vin_.clear();
+}
 
-          brakeReport.rolling_counter =  message->GetSignal("DBW_BrakeRollingCntr")->GetResult();
+// True when msg carries the payload a cached report was last built from; otherwise
+//  remembers it for next time.
+bool DbwNode::repeatsPayload(ReportPayload &last, const can_msgs::Frame &msg)
+{
+  uint64_t data = payloadWord(msg.data.elems);
+  if (last.valid && last.data == data) {
+    return true;
+  }
 
-          brakeReport.brake_torque_actual = message->GetSignal("DBW_BrakePcntTorqueActual")->GetResult();
+  last.valid = true;
+  last.data = data;
+  return false;
+}
 
-          brakeReport.intervention_active = message->GetSignal("DBW_BrakeInterventionActv")->GetResult() ? true : false;
-          brakeReport.intervention_ready = message->GetSignal("DBW_BrakeInterventionReady")->GetResult() ? true : false;
+void DbwNode::recvBrakeReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const BrakeReportSignals &report = signals.brakeReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          brakeReport.parking_brake.status = message->GetSignal("DBW_BrakeParkingBrkStatus")->GetResult();
+  message->Decode(*msg, frame);
 
-          brakeReport.control_type.value = message->GetSignal("DBW_BrakeCtrlType")->GetResult();
+  bool faultCh1 = frame.GetRawAs<bool>(report.faultCh1);
+  bool faultCh2 = frame.GetRawAs<bool>(report.faultCh2);
+  bool brakeSystemFault = frame.GetRawAs<bool>(report.fault);
+  bool dbwSystemFault = brakeSystemFault;
 
-          pub_brake_.publish(brakeReport);
-          if (faultCh1 || faultCh2) {
-            ROS_WARN_THROTTLE(5.0, "Brake fault.    FLT1: %s FLT2: %s",
-                faultCh1 ? "true, " : "false,",
-                faultCh2 ? "true, " : "false,");
-          }
-        }
-      }
-      break;
+  faultBrakes(faultCh1 && faultCh2);
+  faultWatchdog(dbwSystemFault, brakeSystemFault);
 
-      case ID_ACCEL_PEDAL_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_ACCEL_PEDAL_REPORT);
-        if (msg->dlc >= message->GetDlc()) {
+  overrideBrake(frame.GetValue(report.driverActivity));
+  dbw_pacifica_msgs::BrakeReport::Ptr brakeReport = brake_report_pool_.get();
+  brakeReport->header.stamp = msg->header.stamp;
+  brakeReport->pedal_position  = frame.GetValue(report.pedalDriverInput);
+  brakeReport->pedal_output = frame.GetValue(report.pedalPositionFeedback);
 
-          message->SetFrame(msg);
+  brakeReport->enabled = frame.GetRawAs<bool>(report.enabled);
+  brakeReport->driver_activity = frame.GetRawAs<bool>(report.driverActivity);
 
-          bool faultCh1 = message->GetSignal("DBW_AccelPdlFault_Ch1")->GetResult() ? true : false;
-          bool faultCh2 = message->GetSignal("DBW_AccelPdlFault_Ch2")->GetResult() ? true : false;
-          bool accelPdlSystemFault = message->GetSignal("DBW_AccelPdlFault")->GetResult() ? true : false;
-          bool dbwSystemFault = accelPdlSystemFault;
+  brakeReport->fault_brake_system = brakeSystemFault;
 
-          uint16_t positionFeedback = message->GetSignal("DBW_AccelPdlPosnFdbck")->GetResult(); 
+  brakeReport->fault_ch2 = faultCh2;
 
-          faultAcceleratorPedal(faultCh1 && faultCh2);
-          faultWatchdog(dbwSystemFault, accelPdlSystemFault);
+  brakeReport->rolling_counter =  frame.GetRawAs<uint8_t>(report.rollingCounter);
 
-          overrideAcceleratorPedal(message->GetSignal("DBW_AccelPdlDriverActivity")->GetResult());
+  brakeReport->brake_torque_actual = frame.GetValue(report.torqueActual);
 
-          dbw_pacifica_msgs::AcceleratorPedalReport accelPedalReprt;
-          accelPedalReprt.header.stamp = msg->header.stamp;
-          accelPedalReprt.pedal_input  = message->GetSignal("DBW_AccelPdlDriverInput")->GetResult();
-          accelPedalReprt.pedal_output = message->GetSignal("DBW_AccelPdlPosnFdbck")->GetResult();
-          accelPedalReprt.enabled = message->GetSignal("DBW_AccelPdlEnabled")->GetResult() ? true : false;
-          accelPedalReprt.ignore_driver = message->GetSignal("DBW_AccelPdlIgnoreDriver")->GetResult() ? true : false;
-          accelPedalReprt.driver_activity = message->GetSignal("DBW_AccelPdlDriverActivity")->GetResult() ? true : false;
-          accelPedalReprt.torque_actual = message->GetSignal("DBW_AccelPcntTorqueActual")->GetResult();
+  brakeReport->intervention_active = frame.GetRawAs<bool>(report.interventionActive);
+  brakeReport->intervention_ready = frame.GetRawAs<bool>(report.interventionReady);
 
-          accelPedalReprt.control_type.value = message->GetSignal("DBW_AccelCtrlType")->GetResult();
+  brakeReport->parking_brake.status = frame.GetRawAs<uint8_t>(report.parkingBrakeStatus);
 
-          accelPedalReprt.rolling_counter =  message->GetSignal("DBW_AccelPdlRollingCntr")->GetResult();
+  brakeReport->control_type.value = frame.GetRawAs<uint8_t>(report.controlType);
 
-          accelPedalReprt.fault_accel_pedal_system = accelPdlSystemFault;
-          
-          accelPedalReprt.fault_ch1 = faultCh1;
-          accelPedalReprt.fault_ch2 = faultCh2;
+  pub_brake_.publish(dbw_pacifica_msgs::BrakeReport::ConstPtr(brakeReport));
+  if (faultCh1 || faultCh2) {
+    ROS_WARN_THROTTLE(5.0, "Brake fault.    FLT1: %s FLT2: %s",
+        faultCh1 ? "true, " : "false,",
+        faultCh2 ? "true, " : "false,");
+  }
+}
 
-          pub_accel_pedal_.publish(accelPedalReprt);
+void DbwNode::recvAcceleratorPedalReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const AcceleratorPedalReportSignals &report = signals.acceleratorPedalReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          if (faultCh1 || faultCh2) {
-            ROS_WARN_THROTTLE(5.0, "Accelerator Pedal fault. FLT1: %s FLT2: %s",
-                faultCh1 ? "true, " : "false,",
-                faultCh2 ? "true, " : "false,");
-          }
-        }
-      }
-      break;
+  message->Decode(*msg, frame);
 
-      case ID_STEERING_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_STEERING_REPORT);
-        if (msg->dlc >= message->GetDlc()) {
+  bool faultCh1 = frame.GetRawAs<bool>(report.faultCh1);
+  bool faultCh2 = frame.GetRawAs<bool>(report.faultCh2);
+  bool accelPdlSystemFault = frame.GetRawAs<bool>(report.fault);
+  bool dbwSystemFault = accelPdlSystemFault;
 
-          message->SetFrame(msg);
+  uint16_t positionFeedback = frame.GetValue(report.pedalPositionFeedback); 
 
-          bool steeringSystemFault = message->GetSignal("DBW_SteeringFault")->GetResult() ? true : false;
-          bool dbwSystemFault = steeringSystemFault;
+  faultAcceleratorPedal(faultCh1 && faultCh2);
+  faultWatchdog(dbwSystemFault, accelPdlSystemFault);
 
-          faultSteering(steeringSystemFault);
+  overrideAcceleratorPedal(frame.GetValue(report.driverActivity));
 
-          faultWatchdog(dbwSystemFault);
-          overrideSteering(message->GetSignal("DBW_SteeringDriverActivity")->GetResult() ? true : false);
+  dbw_pacifica_msgs::AcceleratorPedalReport::Ptr accelPedalReprt = accel_pedal_report_pool_.get();
+  accelPedalReprt->header.stamp = msg->header.stamp;
+  accelPedalReprt->pedal_input  = frame.GetValue(report.pedalDriverInput);
+  accelPedalReprt->pedal_output = frame.GetValue(report.pedalPositionFeedback);
+  accelPedalReprt->enabled = frame.GetRawAs<bool>(report.enabled);
+  accelPedalReprt->ignore_driver = frame.GetRawAs<bool>(report.ignoreDriver);
+  accelPedalReprt->driver_activity = frame.GetRawAs<bool>(report.driverActivity);
+  accelPedalReprt->torque_actual = frame.GetValue(report.torqueActual);
 
-          dbw_pacifica_msgs::SteeringReport steeringReport;
-          steeringReport.header.stamp = msg->header.stamp;
-          steeringReport.steering_wheel_angle = message->GetSignal("DBW_SteeringWhlAngleAct")->GetResult() * (0.1 * M_PI / 180);
-          steeringReport.steering_wheel_angle_cmd = message->GetSignal("DBW_SteeringWhlAngleDes")->GetResult() * (0.1 * M_PI / 180);
-          steeringReport.steering_wheel_torque = message->GetSignal("DBW_SteeringWhlPcntTrqCmd")->GetResult() * 0.0625;
+  accelPedalReprt->control_type.value = frame.GetRawAs<uint8_t>(report.controlType);
 
-          steeringReport.enabled = message->GetSignal("DBW_SteeringEnabled")->GetResult() ? true : false;
-          steeringReport.driver_activity = message->GetSignal("DBW_SteeringDriverActivity")->GetResult() ? true : false;
+  accelPedalReprt->rolling_counter =  frame.GetRawAs<uint8_t>(report.rollingCounter);
 
-          steeringReport.rolling_counter =  message->GetSignal("DBW_SteeringRollingCntr")->GetResult();
+  accelPedalReprt->fault_accel_pedal_system = accelPdlSystemFault;
 
-          steeringReport.control_type.value =  message->GetSignal("DBW_SteeringCtrlType")->GetResult();
+  accelPedalReprt->fault_ch1 = faultCh1;
+  accelPedalReprt->fault_ch2 = faultCh2;
 
-          steeringReport.overheat_prevention_mode = message->GetSignal("DBW_OverheatPreventMode")->GetResult() ? true : false;
+  pub_accel_pedal_.publish(dbw_pacifica_msgs::AcceleratorPedalReport::ConstPtr(accelPedalReprt));
 
-          pub_steering_.publish(steeringReport);
+  if (faultCh1 || faultCh2) {
+    ROS_WARN_THROTTLE(5.0, "Accelerator Pedal fault. FLT1: %s FLT2: %s",
+        faultCh1 ? "true, " : "false,",
+        faultCh2 ? "true, " : "false,");
+  }
+}
 
-          publishJointStates(msg->header.stamp, NULL, &steeringReport);
+void DbwNode::recvSteeringReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const SteeringReportSignals &report = signals.steeringReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          if (steeringSystemFault) {
-            ROS_WARN_THROTTLE(5.0, "Steering fault: %s",
-                steeringSystemFault ? "true, " : "false,");
-          }
-        }
-      }
-      break;
+  message->Decode(*msg, frame);
 
-      case ID_GEAR_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_GEAR_REPORT);
+  bool steeringSystemFault = frame.GetRawAs<bool>(report.fault);
+  bool dbwSystemFault = steeringSystemFault;
 
-        if (msg->dlc >= 1) {
+  faultSteering(steeringSystemFault);
 
-          message->SetFrame(msg);
+  faultWatchdog(dbwSystemFault);
+  overrideSteering(frame.GetRawAs<bool>(report.driverActivity));
 
-          bool driverActivity = message->GetSignal("DBW_PrndDriverActivity")->GetResult() ? true : false;
+  dbw_pacifica_msgs::SteeringReport::Ptr steeringReport = steering_report_pool_.get();
+  steeringReport->header.stamp = msg->header.stamp;
+  steeringReport->steering_wheel_angle = frame.GetValue(report.wheelAngleActual) * (0.1 * M_PI / 180);
+  steeringReport->steering_wheel_angle_cmd = frame.GetValue(report.wheelAngleDesired) * (0.1 * M_PI / 180);
+  steeringReport->steering_wheel_torque = frame.GetValue(report.wheelTorqueCommand) * 0.0625;
 
-          overrideGear(driverActivity);
-          dbw_pacifica_msgs::GearReport out;
-          out.header.stamp = msg->header.stamp;
+  steeringReport->enabled = frame.GetRawAs<bool>(report.enabled);
+  steeringReport->driver_activity = frame.GetRawAs<bool>(report.driverActivity);
 
-          out.enabled = message->GetSignal("DBW_PrndCtrlEnabled")->GetResult() ? true : false;
-          out.state.gear = message->GetSignal("DBW_PrndStateActual")->GetResult();
-          out.driver_activity = driverActivity;
-          out.gear_select_system_fault = message->GetSignal("DBW_PrndFault")->GetResult() ? true : false;
+  steeringReport->rolling_counter =  frame.GetRawAs<uint8_t>(report.rollingCounter);
 
-          out.reject = message->GetSignal("DBW_PrndStateReject")->GetResult() ? true : false;
-          
-          pub_gear_.publish(out);
-        }
-      }
-      break;
+  steeringReport->control_type.value =  frame.GetRawAs<uint8_t>(report.controlType);
 
-      case ID_REPORT_WHEEL_SPEED:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_REPORT_WHEEL_SPEED);
+  steeringReport->overheat_prevention_mode = frame.GetRawAs<bool>(report.overheatPreventMode);
 
-        if (msg->dlc >= message->GetDlc()) {
-          message->SetFrame(msg);
+  pub_steering_.publish(dbw_pacifica_msgs::SteeringReport::ConstPtr(steeringReport));
 
-          dbw_pacifica_msgs::WheelSpeedReport out;
-          out.header.stamp = msg->header.stamp;          
+  publishJointStates(msg->header.stamp, NULL, steeringReport.get());
 
-            out.front_left  = message->GetSignal("DBW_WhlRpm_FL")->GetResult();
-            out.front_right = message->GetSignal("DBW_WhlRpm_FR")->GetResult();
-            out.rear_left   = message->GetSignal("DBW_WhlRpm_RL")->GetResult();
-            out.rear_right  = message->GetSignal("DBW_WhlRpm_RR")->GetResult();
+  if (steeringSystemFault) {
+    ROS_WARN_THROTTLE(5.0, "Steering fault: %s",
+        steeringSystemFault ? "true, " : "false,");
+  }
+}
 
-            pub_wheel_speeds_.publish(out);
-            publishJointStates(msg->header.stamp, &out, NULL);
-          }
-      }
-      break;
+void DbwNode::recvGearReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const GearReportSignals &report = signals.gearReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-      case ID_REPORT_WHEEL_POSITION:
-      {
-         NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_REPORT_WHEEL_POSITION);
-        if (msg->dlc >= message->GetDlc()) {
+  message->Decode(*msg, frame);
 
-          message->SetFrame(msg);
+  bool driverActivity = frame.GetRawAs<bool>(report.driverActivity);
 
-          dbw_pacifica_msgs::WheelPositionReport out;
-          out.header.stamp = msg->header.stamp;
-          out.front_left  = message->GetSignal("DBW_WhlPulseCnt_FL")->GetResult();
-          out.front_right = message->GetSignal("DBW_WhlPulseCnt_FR")->GetResult();
-          out.rear_left   = message->GetSignal("DBW_WhlPulseCnt_RL")->GetResult();
-          out.rear_right  = message->GetSignal("DBW_WhlPulseCnt_RR")->GetResult();
-          out.wheel_pulses_per_rev  = message->GetSignal("DBW_WhlPulsesPerRev")->GetResult();
+  overrideGear(driverActivity);
+  dbw_pacifica_msgs::GearReport::Ptr out = gear_report_pool_.get();
+  out->header.stamp = msg->header.stamp;
 
-          pub_wheel_positions_.publish(out);
-        }
-      }
-      break;
+  out->enabled = frame.GetRawAs<bool>(report.enabled);
+  out->state.gear = frame.GetRawAs<uint8_t>(report.stateActual);
+  out->driver_activity = driverActivity;
+  out->gear_select_system_fault = frame.GetRawAs<bool>(report.fault);
 
-      case ID_REPORT_TIRE_PRESSURE:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_REPORT_TIRE_PRESSURE);
+  out->reject = frame.GetRawAs<bool>(report.stateReject);
 
-        if (msg->dlc >= message->GetDlc()) {
+  pub_gear_.publish(dbw_pacifica_msgs::GearReport::ConstPtr(out));
+}
 
-          message->SetFrame(msg);
+void DbwNode::recvWheelSpeedReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const WheelSpeedReportSignals &report = signals.wheelSpeedReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          dbw_pacifica_msgs::TirePressureReport out;
-          out.header.stamp = msg->header.stamp;
-          out.front_left  = message->GetSignal("DBW_TirePressFL")->GetResult();
-          out.front_right = message->GetSignal("DBW_TirePressFR")->GetResult();
-          out.rear_left   = message->GetSignal("DBW_TirePressRL")->GetResult();
-          out.rear_right  = message->GetSignal("DBW_TirePressRR")->GetResult();
-          pub_tire_pressure_.publish(out);
-        }
-      }
-      break;
+  message->Decode(*msg, frame);
 
-      case ID_REPORT_SURROUND:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_REPORT_SURROUND);
+  dbw_pacifica_msgs::WheelSpeedReport::Ptr out = wheel_speed_report_pool_.get();
+  out->header.stamp = msg->header.stamp;          
 
-        if (msg->dlc >= message->GetDlc()) {
+  out->front_left  = frame.GetValue(report.frontLeft);
+  out->front_right = frame.GetValue(report.frontRight);
+  out->rear_left   = frame.GetValue(report.rearLeft);
+  out->rear_right  = frame.GetValue(report.rearRight);
 
-          message->SetFrame(msg);
+  pub_wheel_speeds_.publish(dbw_pacifica_msgs::WheelSpeedReport::ConstPtr(out));
+  publishJointStates(msg->header.stamp, out.get(), NULL);
+}
 
-          dbw_pacifica_msgs::SurroundReport out;
-          out.header.stamp = msg->header.stamp;
+void DbwNode::recvWheelPositionReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const WheelPositionReportSignals &report = signals.wheelPositionReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          out.front_radar_object_distance = message->GetSignal("DBW_Reserved2")->GetResult();
-          out.rear_radar_object_distance = message->GetSignal("DBW_SonarRearDist")->GetResult();
+  message->Decode(*msg, frame);
 
-          out.front_radar_distance_valid = message->GetSignal("DBW_Reserved3")->GetResult() ? true : false;
-          out.parking_sonar_data_valid = message->GetSignal("DBW_SonarVld")->GetResult() ? true : false;
+  dbw_pacifica_msgs::WheelPositionReport::Ptr out = wheel_position_report_pool_.get();
+  out->header.stamp = msg->header.stamp;
+  out->front_left  = frame.GetValue(report.frontLeft);
+  out->front_right = frame.GetValue(report.frontRight);
+  out->rear_left   = frame.GetValue(report.rearLeft);
+  out->rear_right  = frame.GetValue(report.rearRight);
+  out->wheel_pulses_per_rev  = frame.GetValue(report.pulsesPerRev);
 
-          out.rear_right.status = message->GetSignal("DBW_SonarArcNumRR")->GetResult();
-          out.rear_left.status = message->GetSignal("DBW_SonarArcNumRL")->GetResult();
-          out.rear_center.status = message->GetSignal("DBW_SonarArcNumRC")->GetResult();
+  pub_wheel_positions_.publish(dbw_pacifica_msgs::WheelPositionReport::ConstPtr(out));
+}
 
-          out.front_right.status = message->GetSignal("DBW_SonarArcNumFR")->GetResult();
-          out.front_left.status = message->GetSignal("DBW_SonarArcNumFL")->GetResult();
-          out.front_center.status = message->GetSignal("DBW_SonarArcNumFC")->GetResult();
+void DbwNode::recvTirePressureReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const TirePressureReportSignals &report = signals.tirePressureReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
+
+  dbw_pacifica_msgs::TirePressureReport &out = tire_pressure_report_;
+
+  if (!repeatsPayload(tire_pressure_payload_, *msg)) {
+    message->Decode(*msg, frame);
+    out.front_left  = frame.GetValue(report.frontLeft);
+    out.front_right = frame.GetValue(report.frontRight);
+    out.rear_left   = frame.GetValue(report.rearLeft);
+    out.rear_right  = frame.GetValue(report.rearRight);
+  }
 
-          pub_surround_.publish(out);
-        }
-      }
-      break;
-
-      case ID_VIN:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_VIN);
-
-        if (msg->dlc >= message->GetDlc()) {
-
-          message->SetFrame(msg);
-
-          if (message->GetSignal("DBW_VinMultiplexor")->GetResult() == VIN_MUX_VIN0) {
-            vin_.push_back(message->GetSignal("DBW_VinDigit_01")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_02")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_03")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_04")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_05")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_06")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_07")->GetResult());
-          } else if (message->GetSignal("DBW_VinMultiplexor")->GetResult() == VIN_MUX_VIN1) {
-            vin_.push_back(message->GetSignal("DBW_VinDigit_08")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_09")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_10")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_11")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_12")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_13")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_14")->GetResult());
-          } else if (message->GetSignal("DBW_VinMultiplexor")->GetResult() == VIN_MUX_VIN2) {
-            vin_.push_back(message->GetSignal("DBW_VinDigit_15")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_16")->GetResult());
-            vin_.push_back(message->GetSignal("DBW_VinDigit_17")->GetResult());
-            std_msgs::String msg; msg.data = vin_;
-            pub_vin_.publish(msg);
-            //ROS_INFO("Detected VIN: %s", vin_.c_str());
-          }
-        }
-      }
-      break;
+  out.header.stamp = msg->header.stamp;
 
-      case ID_REPORT_IMU:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_REPORT_IMU);
+  dbw_pacifica_msgs::TirePressureReport::Ptr published = tire_pressure_report_pool_.get();
+  *published = out;
+  pub_tire_pressure_.publish(dbw_pacifica_msgs::TirePressureReport::ConstPtr(published));
+}
 
-        if (msg->dlc >= message->GetDlc()) {
+void DbwNode::recvSurroundReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const SurroundReportSignals &report = signals.surroundReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          message->SetFrame(msg);
+  message->Decode(*msg, frame);
 
-          sensor_msgs::Imu out;
-          out.header.stamp = msg->header.stamp;
-          out.header.frame_id = frame_id_;
+  dbw_pacifica_msgs::SurroundReport::Ptr out = surround_report_pool_.get();
+  out->header.stamp = msg->header.stamp;
 
-          out.angular_velocity.z = (double)message->GetSignal("DBW_ImuYawRate")->GetResult();
+  out->front_radar_object_distance = frame.GetValue(report.frontRadarDistance);
+  out->rear_radar_object_distance = frame.GetValue(report.rearRadarDistance);
 
-          out.linear_acceleration.x = (double)message->GetSignal("DBW_ImuAccelX")->GetResult();
-          out.linear_acceleration.y = (double)message->GetSignal("DBW_ImuAccelY")->GetResult();
+  out->front_radar_distance_valid = frame.GetRawAs<bool>(report.frontRadarValid);
+  out->parking_sonar_data_valid = frame.GetRawAs<bool>(report.sonarValid);
 
-          pub_imu_.publish(out);
-        }
-      }
-      break;
+  out->rear_right.status = frame.GetRawAs<uint8_t>(report.sonarArcRearRight);
+  out->rear_left.status = frame.GetRawAs<uint8_t>(report.sonarArcRearLeft);
+  out->rear_center.status = frame.GetRawAs<uint8_t>(report.sonarArcRearCenter);
 
-      case ID_REPORT_DRIVER_INPUT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_REPORT_DRIVER_INPUT);
+  out->front_right.status = frame.GetRawAs<uint8_t>(report.sonarArcFrontRight);
+  out->front_left.status = frame.GetRawAs<uint8_t>(report.sonarArcFrontLeft);
+  out->front_center.status = frame.GetRawAs<uint8_t>(report.sonarArcFrontCenter);
 
-        if (msg->dlc >= message->GetDlc()) {
+  pub_surround_.publish(dbw_pacifica_msgs::SurroundReport::ConstPtr(out));
+}
 
-          message->SetFrame(msg);
+void DbwNode::recvVin(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const VinReportSignals &report = signals.vinReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
+
+  message->Decode(*msg, frame);
+
+  if (frame.GetValue(report.multiplexor) == VIN_MUX_VIN0) {
+    vin_.push_back(frame.GetValue(report.digits[0]));
+    vin_.push_back(frame.GetValue(report.digits[1]));
+    vin_.push_back(frame.GetValue(report.digits[2]));
+    vin_.push_back(frame.GetValue(report.digits[3]));
+    vin_.push_back(frame.GetValue(report.digits[4]));
+    vin_.push_back(frame.GetValue(report.digits[5]));
+    vin_.push_back(frame.GetValue(report.digits[6]));
+  } else if (frame.GetValue(report.multiplexor) == VIN_MUX_VIN1) {
+    vin_.push_back(frame.GetValue(report.digits[7]));
+    vin_.push_back(frame.GetValue(report.digits[8]));
+    vin_.push_back(frame.GetValue(report.digits[9]));
+    vin_.push_back(frame.GetValue(report.digits[10]));
+    vin_.push_back(frame.GetValue(report.digits[11]));
+    vin_.push_back(frame.GetValue(report.digits[12]));
+    vin_.push_back(frame.GetValue(report.digits[13]));
+  } else if (frame.GetValue(report.multiplexor) == VIN_MUX_VIN2) {
+    vin_.push_back(frame.GetValue(report.digits[14]));
+    vin_.push_back(frame.GetValue(report.digits[15]));
+    vin_.push_back(frame.GetValue(report.digits[16]));
+    std_msgs::String msg; msg.data = vin_;
+    pub_vin_.publish(msg);
+    //ROS_INFO("Detected VIN: %s", vin_.c_str());
+  }
+}
 
-          dbw_pacifica_msgs::DriverInputReport out;
-          out.header.stamp = msg->header.stamp;
+void DbwNode::recvImuReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const ImuReportSignals &report = signals.imuReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          out.turn_signal.value = message->GetSignal("DBW_DrvInptTurnSignal")->GetResult();
-          out.high_beam_headlights.status = message->GetSignal("DBW_DrvInptHiBeam")->GetResult();
-          out.wiper.status = message->GetSignal("DBW_DrvInptWiper")->GetResult();
+  message->Decode(*msg, frame);
 
-          out.cruise_resume_button = message->GetSignal("DBW_DrvInptCruiseResumeBtn")->GetResult() ? true : false;
-          out.cruise_cancel_button = message->GetSignal("DBW_DrvInptCruiseCancelBtn")->GetResult() ? true : false;
-          out.cruise_accel_button = message->GetSignal("DBW_DrvInptCruiseAccelBtn")->GetResult() ? true : false;
-          out.cruise_decel_button = message->GetSignal("DBW_DrvInptCruiseDecelBtn")->GetResult() ? true : false;
-          out.cruise_on_off_button = message->GetSignal("DBW_DrvInptCruiseOnOffBtn")->GetResult() ? true : false;
+  sensor_msgs::Imu::Ptr out = imu_pool_.get();
+  out->header.stamp = msg->header.stamp;
+  out->header.frame_id = frame_id_;
 
-          out.adaptive_cruise_on_off_button = message->GetSignal("DBW_DrvInptAccOnOffBtn")->GetResult() ? true : false;
-          out.adaptive_cruise_increase_distance_button = message->GetSignal("DBW_DrvInptAccIncDistBtn")->GetResult() ? true : false;
-          out.adaptive_cruise_decrease_distance_button = message->GetSignal("DBW_DrvInptAccDecDistBtn")->GetResult() ? true : false;
+  out->angular_velocity.z = (double)frame.GetValue(report.yawRate);
 
-          out.door_or_hood_ajar = message->GetSignal("DBW_OccupAnyDoorOrHoodAjar")->GetResult() ? true : false;
+  out->linear_acceleration.x = (double)frame.GetValue(report.accelX);
+  out->linear_acceleration.y = (double)frame.GetValue(report.accelY);
 
-          out.airbag_deployed = message->GetSignal("DBW_OccupAnyAirbagDeployed")->GetResult() ? true : false;
-          out.any_seatbelt_unbuckled = message->GetSignal("DBW_OccupAnySeatbeltUnbuckled")->GetResult() ? true : false;
+  pub_imu_.publish(sensor_msgs::Imu::ConstPtr(out));
+}
 
-          pub_driver_input_.publish(out);
-        }
-      }
-      break;
+void DbwNode::recvDriverInputReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const DriverInputReportSignals &report = signals.driverInputReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-      case ID_MISC_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_MISC_REPORT);
+  message->Decode(*msg, frame);
 
-        if (msg->dlc >= message->GetDlc()) {
+  dbw_pacifica_msgs::DriverInputReport::Ptr out = driver_input_report_pool_.get();
+  out->header.stamp = msg->header.stamp;
 
-          message->SetFrame(msg);
+  out->turn_signal.value = frame.GetRawAs<uint8_t>(report.turnSignal);
+  out->high_beam_headlights.status = frame.GetRawAs<uint8_t>(report.highBeam);
+  out->wiper.status = frame.GetRawAs<uint8_t>(report.wiper);
 
-          dbw_pacifica_msgs::MiscReport out;
-          out.header.stamp = msg->header.stamp;
+  out->cruise_resume_button = frame.GetRawAs<bool>(report.cruiseResumeButton);
+  out->cruise_cancel_button = frame.GetRawAs<bool>(report.cruiseCancelButton);
+  out->cruise_accel_button = frame.GetRawAs<bool>(report.cruiseAccelButton);
+  out->cruise_decel_button = frame.GetRawAs<bool>(report.cruiseDecelButton);
+  out->cruise_on_off_button = frame.GetRawAs<bool>(report.cruiseOnOffButton);
 
-          out.fuel_level = (double)message->GetSignal("DBW_MiscFuelLvl")->GetResult();
+  out->adaptive_cruise_on_off_button = frame.GetRawAs<bool>(report.adaptiveCruiseOnOffButton);
+  out->adaptive_cruise_increase_distance_button = frame.GetRawAs<bool>(report.adaptiveCruiseIncreaseDistanceButton);
+  out->adaptive_cruise_decrease_distance_button = frame.GetRawAs<bool>(report.adaptiveCruiseDecreaseDistanceButton);
 
-          out.drive_by_wire_enabled = (bool)message->GetSignal("DBW_MiscByWireEnabled")->GetResult();
-          out.vehicle_speed = (double)message->GetSignal("DBW_MiscVehicleSpeed")->GetResult();
+  out->door_or_hood_ajar = frame.GetRawAs<bool>(report.doorOrHoodAjar);
 
-          out.software_build_number = message->GetSignal("DBW_SoftwareBuildNumber")->GetResult();
-          out.general_actuator_fault = message->GetSignal("DBW_MiscFault")->GetResult() ? true : false;
-          out.by_wire_ready = message->GetSignal("DBW_MiscByWireReady")->GetResult() ? true : false;
-          out.general_driver_activity = message->GetSignal("DBW_MiscDriverActivity")->GetResult() ? true : false;
-          out.comms_fault = message->GetSignal("DBW_MiscAKitCommFault")->GetResult() ? true : false;        
+  out->airbag_deployed = frame.GetRawAs<bool>(report.airbagDeployed);
+  out->any_seatbelt_unbuckled = frame.GetRawAs<bool>(report.anySeatbeltUnbuckled);
 
-          out.ambient_temp = (double)message->GetSignal("DBW_AmbientTemp")->GetResult();
+  pub_driver_input_.publish(dbw_pacifica_msgs::DriverInputReport::ConstPtr(out));
+}
 
-          pub_misc_.publish(out);
-        }
-      }
-      break;
+void DbwNode::recvMiscReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const MiscReportSignals &report = signals.miscReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-      case ID_LOW_VOLTAGE_SYSTEM_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_LOW_VOLTAGE_SYSTEM_REPORT);
+  message->Decode(*msg, frame);
 
-        if (msg->dlc >= message->GetDlc()) {
+  dbw_pacifica_msgs::MiscReport::Ptr out = misc_report_pool_.get();
+  out->header.stamp = msg->header.stamp;
 
-          message->SetFrame(msg);
+  out->fuel_level = (double)frame.GetValue(report.fuelLevel);
 
-          dbw_pacifica_msgs::LowVoltageSystemReport lvSystemReport;
-          lvSystemReport.header.stamp = msg->header.stamp;
+  out->drive_by_wire_enabled = (bool)frame.GetValue(report.byWireEnabled);
+  out->vehicle_speed = (double)frame.GetValue(report.vehicleSpeed);
 
-          lvSystemReport.vehicle_battery_volts = (double)message->GetSignal("DBW_LvVehBattVlt")->GetResult();
-          lvSystemReport.vehicle_battery_current = (double)message->GetSignal("DBW_LvBattCurr")->GetResult();
-          lvSystemReport.vehicle_alternator_current = (double)message->GetSignal("DBW_LvAlternatorCurr")->GetResult();
+  out->software_build_number = frame.GetRawAs<uint16_t>(report.softwareBuildNumber);
+  out->general_actuator_fault = frame.GetRawAs<bool>(report.fault);
+  out->by_wire_ready = frame.GetRawAs<bool>(report.byWireReady);
+  out->general_driver_activity = frame.GetRawAs<bool>(report.driverActivity);
+  out->comms_fault = frame.GetRawAs<bool>(report.commsFault);        
 
-          lvSystemReport.dbw_battery_volts = (double)message->GetSignal("DBW_LvDbwBattVlt")->GetResult();
-          lvSystemReport.dcdc_current = (double)message->GetSignal("DBW_LvDcdcCurr")->GetResult();
+  if (report.ambientTemp != NULL) {
+    out->ambient_temp = (double)frame.GetValue(report.ambientTemp);
+  }
 
-          lvSystemReport.aux_battery_contactor = message->GetSignal("DBW_LvBattContactorCmd")->GetResult() ? true : false;
-          lvSystemReport.aux_inverter_contactor = message->GetSignal("DBW_LvInvtrContactorCmd")->GetResult() ? true : false;
+  pub_misc_.publish(dbw_pacifica_msgs::MiscReport::ConstPtr(out));
+}
 
-          pub_low_voltage_system_.publish(lvSystemReport);
-        }        
-      }
-      break;
+void DbwNode::recvLowVoltageSystemReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const LowVoltageSystemReportSignals &report = signals.lowVoltageSystemReport;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-      case ID_BRAKE_2_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_BRAKE_2_REPORT);
+  dbw_pacifica_msgs::LowVoltageSystemReport &lvSystemReport = low_voltage_system_report_;
 
-        if (msg->dlc >= message->GetDlc()) {
-          message->SetFrame(msg);
+  if (!repeatsPayload(low_voltage_system_payload_, *msg)) {
+    message->Decode(*msg, frame);
+    lvSystemReport.vehicle_battery_volts = (double)frame.GetValue(report.vehicleBatteryVolts);
+    lvSystemReport.vehicle_battery_current = (double)frame.GetValue(report.vehicleBatteryCurrent);
+    lvSystemReport.vehicle_alternator_current = (double)frame.GetValue(report.alternatorCurrent);
 
-          dbw_pacifica_msgs::Brake2Report brake2Report;
-          brake2Report.header.stamp = msg->header.stamp;
-          
-          brake2Report.brake_pressure = message->GetSignal("DBW_BrakePress_bar")->GetResult();
+    lvSystemReport.dbw_battery_volts = (double)frame.GetValue(report.dbwBatteryVolts);
+    lvSystemReport.dcdc_current = (double)frame.GetValue(report.dcdcCurrent);
 
-          brake2Report.estimated_road_slope = message->GetSignal("DBW_RoadSlopeEstimate")->GetResult();
+    lvSystemReport.aux_battery_contactor = frame.GetRawAs<bool>(report.batteryContactor);
+    lvSystemReport.aux_inverter_contactor = frame.GetRawAs<bool>(report.inverterContactor);
+  }
 
-          pub_brake_2_report_.publish(brake2Report);
-        }
-      }
-      break;
+  lvSystemReport.header.stamp = msg->header.stamp;
 
-      case ID_STEERING_2_REPORT:
-      {
-        NewEagle::DbcMessage* message = dbwDbc_.GetMessageById(ID_STEERING_2_REPORT);
+  dbw_pacifica_msgs::LowVoltageSystemReport::Ptr published = low_voltage_system_report_pool_.get();
+  *published = lvSystemReport;
+  pub_low_voltage_system_.publish(dbw_pacifica_msgs::LowVoltageSystemReport::ConstPtr(published));
+}
 
-        if (msg->dlc >= message->GetDlc()) {
-          message->SetFrame(msg);
+void DbwNode::recvBrake2Report(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const Brake2ReportSignals &report = signals.brake2Report;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
 
-          dbw_pacifica_msgs::Steering2Report steering2Report;
-          steering2Report.header.stamp = msg->header.stamp;
+  message->Decode(*msg, frame);
 
-          steering2Report.vehicle_curvature_actual = message->GetSignal("DBW_SteeringVehCurvatureAct")->GetResult();
-          
-          pub_steering_2_report_.publish(steering2Report);
-        }      
-      }
-      break;
-
-      case ID_BRAKE_CMD:
-        //ROS_WARN("DBW system: Another node on the CAN bus is commanding the vehicle!!! Subsystem: Brake. Id: 0x%03X", ID_BRAKE_CMD);
-        break;
-      case ID_ACCELERATOR_PEDAL_CMD:
-        //ROS_WARN("DBW system: Another node on the CAN bus is commanding the vehicle!!! Subsystem: Accelerator Pedal. Id: 0x%03X", ID_ACCELERATOR_PEDAL_CMD);
-        break;
-      case ID_STEERING_CMD:
-        //ROS_WARN("DBW system: Another node on the CAN bus is commanding the vehicle!!! Subsystem: Steering. Id: 0x%03X", ID_STEERING_CMD);
-        break;
-      case ID_GEAR_CMD:
-        //ROS_WARN("DBW system: Another node on the CAN bus is commanding the vehicle!!! Subsystem: Shifting. Id: 0x%03X", ID_GEAR_CMD);
-        break;
-    }
-  }
-#if 0
-  ROS_INFO("ena: %s, clr: %s, brake: %s, Accelerator Pedal: %s, steering: %s, gear: %s",
-           enabled() ? "true " : "false",
-           clear() ? "true " : "false",
-           override_brake_ ? "true " : "false",
-           override_accelerator_pedal_ ? "true " : "false",
-           override_steering_ ? "true " : "false",
-           override_gear_ ? "true " : "false"
-       );
-#endif
+  dbw_pacifica_msgs::Brake2Report::Ptr brake2Report = brake_2_report_pool_.get();
+  brake2Report->header.stamp = msg->header.stamp;
+
+  brake2Report->brake_pressure = frame.GetValue(report.brakePressure);
+
+  brake2Report->estimated_road_slope = frame.GetValue(report.roadSlopeEstimate);
+
+  pub_brake_2_report_.publish(dbw_pacifica_msgs::Brake2Report::ConstPtr(brake2Report));
+}
+
+void DbwNode::recvSteering2Report(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg)
+{
+  const Steering2ReportSignals &report = signals.steering2Report;
+  const NewEagle::DbcMessage* message = report.message;
+  NewEagle::DecodedFrame &frame = rx_frame_;
+
+  message->Decode(*msg, frame);
+
+  dbw_pacifica_msgs::Steering2Report::Ptr steering2Report = steering_2_report_pool_.get();
+  steering2Report->header.stamp = msg->header.stamp;
+
+  steering2Report->vehicle_curvature_actual = frame.GetValue(report.vehicleCurvatureActual);
+
+  pub_steering_2_report_.publish(dbw_pacifica_msgs::Steering2Report::ConstPtr(steering2Report));
 }
 
 void DbwNode::recvBrakeCmd(const dbw_pacifica_msgs::BrakeCmd::ConstPtr& msg)
 {
-  NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_BrakeRequest");
-  
-  message->GetSignal("AKit_BrakePedalReq")->SetResult(0);
-  message->GetSignal("AKit_BrakeCtrlEnblReq")->SetResult(0);
-  message->GetSignal("AKit_BrakeCtrlReqType")->SetResult(0);
-  message->GetSignal("AKit_BrakePcntTorqueReq")->SetResult(0);
-  message->GetSignal("AKit_SpeedModeAccelLim")->SetResult(0);
-  message->GetSignal("AKit_SpeedModeDecelLim")->SetResult(0);
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
+  const BrakeCmdSignals &cmd = dbc->signals.brakeCmd;
+  const NewEagle::DbcMessage* message = cmd.message;
+
+  NewEagle::DecodedFrame &values = cmd_frame_;
+  message->ResetToDefaults(values);
 
   if (enabled()) {
     if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::open_loop) {
-      message->GetSignal("AKit_BrakeCtrlReqType")->SetResult(0);
-      message->GetSignal("AKit_BrakePedalReq")->SetResult(msg->pedal_cmd);      
+      values.SetRaw(cmd.requestType, 0);
+      values.SetValue(cmd.pedalRequest, msg->pedal_cmd);      
     } else if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::closed_loop_actuator) {
-      message->GetSignal("AKit_BrakeCtrlReqType")->SetResult(1); 
-      message->GetSignal("AKit_BrakePcntTorqueReq")->SetResult(msg->torque_cmd);           
+      values.SetRaw(cmd.requestType, 1); 
+      values.SetValue(cmd.torqueRequest, msg->torque_cmd);           
     } else if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::closed_loop_vehicle) {
-      message->GetSignal("AKit_BrakeCtrlReqType")->SetResult(2);      
-      message->GetSignal("AKit_SpeedModeAccelLim")->SetResult(msg->accel_limit);
-      message->GetSignal("AKit_SpeedModeDecelLim")->SetResult(msg->decel_limit);      
+      values.SetRaw(cmd.requestType, 2);      
+      values.SetValue(cmd.accelLimit, msg->accel_limit);
+      values.SetValue(cmd.decelLimit, msg->decel_limit);      
     } else {
-      message->GetSignal("AKit_BrakeCtrlReqType")->SetResult(0);
+      values.SetRaw(cmd.requestType, 0);
     }    
 
     if(msg->enable) {
-      message->GetSignal("AKit_BrakeCtrlEnblReq")->SetResult(1);
+      values.SetRaw(cmd.enableRequest, 1);
     }
     
   }
 
-  NewEagle::DbcSignal* cnt = message->GetSignal("AKit_BrakeRollingCntr");
-  cnt->SetResult(msg->rolling_counter);
+  values.SetRaw(cmd.rollingCounter, msg->rolling_counter);
 
-  can_msgs::Frame frame = message->GetFrame();
+  can_msgs::Frame::Ptr frame = can_frame_pool_.get();
+  message->Encode(values, *frame);
+  dbc->brakeCmdData = payloadWord(frame->data.elems);
 
-  pub_can_.publish(frame);
+  pub_can_.publish(can_msgs::Frame::ConstPtr(frame));
 }
 
 void DbwNode::recvAcceleratorPedalCmd(const dbw_pacifica_msgs::AcceleratorPedalCmd::ConstPtr& msg)
 {
-  NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_AccelPdlRequest");
-
-  message->GetSignal("AKit_AccelPdlReq")->SetResult(0);
-  message->GetSignal("AKit_AccelPdlEnblReq")->SetResult(0);
-  message->GetSignal("Akit_AccelPdlIgnoreDriverOvrd")->SetResult(0);
-  message->GetSignal("AKit_AccelPdlRollingCntr")->SetResult(0);
-  message->GetSignal("AKit_AccelReqType")->SetResult(0);
-  message->GetSignal("AKit_AccelPcntTorqueReq")->SetResult(0);
-  message->GetSignal("AKit_AccelPdlChecksum")->SetResult(0);
-  message->GetSignal("AKit_SpeedReq")->SetResult(0);
-  message->GetSignal("AKit_SpeedModeRoadSlope")->SetResult(0);
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
+  const AcceleratorPedalCmdSignals &cmd = dbc->signals.acceleratorPedalCmd;
+  const NewEagle::DbcMessage* message = cmd.message;
+
+  NewEagle::DecodedFrame &values = cmd_frame_;
+  message->ResetToDefaults(values);
 
   if (enabled()) {
 
     if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::open_loop) {
-      message->GetSignal("AKit_AccelReqType")->SetResult(0);
-      message->GetSignal("AKit_AccelPdlReq")->SetResult(msg->pedal_cmd);
+      values.SetRaw(cmd.requestType, 0);
+      values.SetValue(cmd.pedalRequest, msg->pedal_cmd);
     } else if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::closed_loop_actuator) {
-      message->GetSignal("AKit_AccelReqType")->SetResult(1);
-      message->GetSignal("AKit_AccelPcntTorqueReq")->SetResult(msg->torque_cmd);
+      values.SetRaw(cmd.requestType, 1);
+      values.SetValue(cmd.torqueRequest, msg->torque_cmd);
     } else if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::closed_loop_vehicle) {
-      message->GetSignal("AKit_AccelReqType")->SetResult(2);      
+      values.SetRaw(cmd.requestType, 2);      
 
-      message->GetSignal("AKit_SpeedReq")->SetResult(msg->speed_cmd);
-      message->GetSignal("AKit_SpeedModeRoadSlope")->SetResult(msg->road_slope);
+      values.SetValue(cmd.speedRequest, msg->speed_cmd);
+      values.SetValue(cmd.roadSlope, msg->road_slope);
     } else {
-      message->GetSignal("AKit_AccelReqType")->SetResult(0);
+      values.SetRaw(cmd.requestType, 0);
     }
 
     if(msg->enable) {
-      message->GetSignal("AKit_AccelPdlEnblReq")->SetResult(1);
+      values.SetRaw(cmd.enableRequest, 1);
     }
   }
 
-  NewEagle::DbcSignal* cnt = message->GetSignal("AKit_AccelPdlRollingCntr");
-  cnt->SetResult(msg->rolling_counter);
+  values.SetRaw(cmd.rollingCounter, msg->rolling_counter);
 
   if (msg->ignore) {
-    message->GetSignal("Akit_AccelPdlIgnoreDriverOvrd")->SetResult(1);
+    values.SetRaw(cmd.ignoreDriverOverride, 1);
   }    
 
-  can_msgs::Frame frame = message->GetFrame();
+  can_msgs::Frame::Ptr frame = can_frame_pool_.get();
+  message->Encode(values, *frame);
+  dbc->acceleratorPedalCmdData = payloadWord(frame->data.elems);
 
-  pub_can_.publish(frame);
+  pub_can_.publish(can_msgs::Frame::ConstPtr(frame));
 }
 
 void DbwNode::recvSteeringCmd(const dbw_pacifica_msgs::SteeringCmd::ConstPtr& msg)
 {
-  NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_SteeringRequest");
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
+  const SteeringCmdSignals &cmd = dbc->signals.steeringCmd;
+  const NewEagle::DbcMessage* message = cmd.message;
 
-  message->GetSignal("AKit_SteeringWhlAngleReq")->SetResult(0);
-  message->GetSignal("AKit_SteeringWhlAngleVelocityLim")->SetResult(0);
-  message->GetSignal("AKit_SteerCtrlEnblReq")->SetResult(0);  
-  message->GetSignal("AKit_SteeringWhlIgnoreDriverOvrd")->SetResult(0);  
-  message->GetSignal("AKit_SteeringWhlPcntTrqReq")->SetResult(0);  
-  message->GetSignal("AKit_SteeringReqType")->SetResult(0);
-  message->GetSignal("AKit_SteeringVehCurvatureReq")->SetResult(0);
-  message->GetSignal("AKit_SteeringChecksum")->SetResult(0);
+  NewEagle::DecodedFrame &values = cmd_frame_;
+  message->ResetToDefaults(values);
 
   if (enabled()) {
     if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::open_loop) {
-      message->GetSignal("AKit_SteeringReqType")->SetResult(0);
-      message->GetSignal("AKit_SteeringWhlPcntTrqReq")->SetResult(msg->torque_cmd);      
+      values.SetRaw(cmd.requestType, 0);
+      values.SetValue(cmd.torqueRequest, msg->torque_cmd);      
     } else if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::closed_loop_actuator) {
-      message->GetSignal("AKit_SteeringReqType")->SetResult(1);      
+      values.SetRaw(cmd.requestType, 1);      
       double scmd = std::max((float)-470.0, std::min((float)470.0, (float)(msg->angle_cmd * (180 / M_PI * 1.0))));
-      message->GetSignal("AKit_SteeringWhlAngleReq")->SetResult(scmd);
+      values.SetValue(cmd.angleRequest, scmd);
     } else if (msg->control_type.value == dbw_pacifica_msgs::ActuatorControlMode::closed_loop_vehicle) {
-      message->GetSignal("AKit_SteeringReqType")->SetResult(2);      
-      message->GetSignal("AKit_SteeringVehCurvatureReq")->SetResult(msg->vehicle_curvature_cmd);
+      values.SetRaw(cmd.requestType, 2);      
+      values.SetValue(cmd.curvatureRequest, msg->vehicle_curvature_cmd);
     } else {
-      message->GetSignal("AKit_SteeringReqType")->SetResult(0);
+      values.SetRaw(cmd.requestType, 0);
     }    
 
     if (fabsf(msg->angle_velocity) > 0)
     {
       uint16_t vcmd =  std::max((float)1, std::min((float)254, (float)roundf(fabsf(msg->angle_velocity) * 180 / M_PI / 2)));
 
-      message->GetSignal("AKit_SteeringWhlAngleVelocityLim")->SetResult(vcmd);
+      values.SetValue(cmd.angleVelocityLimit, vcmd);
     }
     if(msg->enable) {
-      message->GetSignal("AKit_SteerCtrlEnblReq")->SetResult(1);
+      values.SetRaw(cmd.enableRequest, 1);
     }
   }
 
   if (msg->ignore) {
-    message->GetSignal("AKit_SteeringWhlIgnoreDriverOvrd")->SetResult(1);
+    values.SetRaw(cmd.ignoreDriverOverride, 1);
   }
 
-  message->GetSignal("AKit_SteerRollingCntr")->SetResult(msg->rolling_counter);
+  values.SetRaw(cmd.rollingCounter, msg->rolling_counter);
 
-  can_msgs::Frame frame = message->GetFrame();
+  can_msgs::Frame::Ptr frame = can_frame_pool_.get();
+  message->Encode(values, *frame);
+  dbc->steeringCmdData = payloadWord(frame->data.elems);
 
-  pub_can_.publish(frame);
+  pub_can_.publish(can_msgs::Frame::ConstPtr(frame));
 }
 
 void DbwNode::recvGearCmd(const dbw_pacifica_msgs::GearCmd::ConstPtr& msg)
 {
-  NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_PrndRequest");
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
+  const GearCmdSignals &cmd = dbc->signals.gearCmd;
+  const NewEagle::DbcMessage* message = cmd.message;
 
-  message->GetSignal("AKit_PrndCtrlEnblReq")->SetResult(0);
-  message->GetSignal("AKit_PrndStateReq")->SetResult(0);
-  message->GetSignal("AKit_PrndChecksum")->SetResult(0);
+  NewEagle::DecodedFrame &values = cmd_frame_;
+  message->ResetToDefaults(values);
 
   if (enabled()) {
     if(msg->enable)
     {
-      message->GetSignal("AKit_PrndCtrlEnblReq")->SetResult(1);
+      values.SetRaw(cmd.enableRequest, 1);
     }    
 
-    message->GetSignal("AKit_PrndStateReq")->SetResult(msg->cmd.gear);
+    values.SetRaw(cmd.stateRequest, msg->cmd.gear);
   }  
 
-  message->GetSignal("AKit_PrndRollingCntr")->SetResult(msg->rolling_counter);
+  values.SetRaw(cmd.rollingCounter, msg->rolling_counter);
 
-  can_msgs::Frame frame = message->GetFrame();
+  can_msgs::Frame::Ptr frame = can_frame_pool_.get();
+  message->Encode(values, *frame);
+  dbc->gearCmdData = payloadWord(frame->data.elems);
 
-  pub_can_.publish(frame);
+  pub_can_.publish(can_msgs::Frame::ConstPtr(frame));
 }
 
 void DbwNode::recvGlobalEnableCmd(const dbw_pacifica_msgs::GlobalEnableCmd::ConstPtr& msg)
 {
-  NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_GlobalEnbl");
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
+  const GlobalEnableCmdSignals &cmd = dbc->signals.globalEnableCmd;
+  const NewEagle::DbcMessage* message = cmd.message;
+  if (message == NULL) {
+    ROS_WARN_ONCE("DBC has no AKit_GlobalEnbl message, ignoring global enable commands");
+    return;
+  }
 
-  message->GetSignal("AKit_GlobalEnblRollingCntr")->SetResult(0);
-  message->GetSignal("AKit_GlobalByWireEnblReq")->SetResult(0);
-  message->GetSignal("AKit_EnblJoystickLimits")->SetResult(0);
-  message->GetSignal("AKit_SoftwareBuildNumber")->SetResult(0);
-  message->GetSignal("Akit_GlobalEnblChecksum")->SetResult(0);
+  NewEagle::DecodedFrame &values = cmd_frame_;
+  message->ResetToDefaults(values);
 
   if (enabled()) {
     if(msg->global_enable) {
-      message->GetSignal("AKit_GlobalByWireEnblReq")->SetResult(1);
+      values.SetRaw(cmd.byWireEnableRequest, 1);
     }
 
     if(msg->enable_joystick_limits) {
-      message->GetSignal("AKit_EnblJoystickLimits")->SetResult(1);
+      values.SetRaw(cmd.enableJoystickLimits, 1);
     }
 
-    message->GetSignal("AKit_SoftwareBuildNumber")->SetResult(msg->ecu_build_number);
+    values.SetRaw(cmd.softwareBuildNumber, msg->ecu_build_number);
   }  
    
-  message->GetSignal("AKit_GlobalEnblRollingCntr")->SetResult(msg->rolling_counter);
+  values.SetRaw(cmd.rollingCounter, msg->rolling_counter);
    
-  can_msgs::Frame frame = message->GetFrame();
+  can_msgs::Frame::Ptr frame = can_frame_pool_.get();
+  message->Encode(values, *frame);
 
-  pub_can_.publish(frame);      
+  pub_can_.publish(can_msgs::Frame::ConstPtr(frame));
 }
 
 void DbwNode::recvMiscCmd(const dbw_pacifica_msgs::MiscCmd::ConstPtr& msg)
 {
-  NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_OtherActuators");
-
-  message->GetSignal("AKit_TurnSignalReq")->SetResult(0);
-  message->GetSignal("AKit_RightRearDoorReq")->SetResult(0);
-  message->GetSignal("AKit_HighBeamReq")->SetResult(0);
-  message->GetSignal("AKit_FrontWiperReq")->SetResult(0);
-  message->GetSignal("AKit_RearWiperReq")->SetResult(0);
-  message->GetSignal("AKit_IgnitionReq")->SetResult(0);
-  message->GetSignal("AKit_LeftRearDoorReq")->SetResult(0);
-  message->GetSignal("AKit_LiftgateDoorReq")->SetResult(0);
-  message->GetSignal("AKit_BlockBasicCruiseCtrlBtns")->SetResult(0);
-  message->GetSignal("AKit_BlockAdapCruiseCtrlBtns")->SetResult(0);
-  message->GetSignal("AKit_BlockTurnSigStalkInpts")->SetResult(0);
-  message->GetSignal("AKit_OtherChecksum")->SetResult(0);
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
+  const MiscCmdSignals &cmd = dbc->signals.miscCmd;
+  const NewEagle::DbcMessage* message = cmd.message;
+  if (message == NULL) {
+    ROS_WARN_ONCE("DBC has no AKit_OtherActuators message, ignoring misc commands");
+    return;
+  }
+
+  NewEagle::DecodedFrame &values = cmd_frame_;
+  message->ResetToDefaults(values);
 
   if (enabled()) {
 
-    message->GetSignal("AKit_TurnSignalReq")->SetResult(msg->cmd.value);
+    values.SetRaw(cmd.turnSignalRequest, msg->cmd.value);
 
-    message->GetSignal("AKit_RightRearDoorReq")->SetResult(msg->door_request_right_rear.value);
-    message->GetSignal("AKit_HighBeamReq")->SetResult(msg->high_beam_cmd.status);
+    values.SetRaw(cmd.rightRearDoorRequest, msg->door_request_right_rear.value);
+    values.SetRaw(cmd.highBeamRequest, msg->high_beam_cmd.status);
 
-    message->GetSignal("AKit_FrontWiperReq")->SetResult(msg->front_wiper_cmd.status);
-    message->GetSignal("AKit_RearWiperReq")->SetResult(msg->rear_wiper_cmd.status);
+    values.SetRaw(cmd.frontWiperRequest, msg->front_wiper_cmd.status);
+    values.SetRaw(cmd.rearWiperRequest, msg->rear_wiper_cmd.status);
 
-    message->GetSignal("AKit_IgnitionReq")->SetResult(msg->ignition_cmd.status);
+    values.SetRaw(cmd.ignitionRequest, msg->ignition_cmd.status);
 
-    message->GetSignal("AKit_LeftRearDoorReq")->SetResult(msg->door_request_left_rear.value);
-    message->GetSignal("AKit_LiftgateDoorReq")->SetResult(msg->door_request_lift_gate.value);
+    values.SetRaw(cmd.leftRearDoorRequest, msg->door_request_left_rear.value);
+    values.SetRaw(cmd.liftgateDoorRequest, msg->door_request_lift_gate.value);
 
-//    message->GetSignal("AKit_SoftwareBuildNumber")->SetResult(msg->ecu_build_number);
+//    values.SetValue(cmd.softwareBuildNumber, msg->ecu_build_number);
 
-    message->GetSignal("AKit_BlockBasicCruiseCtrlBtns")->SetResult(msg->block_standard_cruise_buttons);
-    message->GetSignal("AKit_BlockAdapCruiseCtrlBtns")->SetResult(msg->block_adaptive_cruise_buttons);
-    message->GetSignal("AKit_BlockTurnSigStalkInpts")->SetResult(msg->block_turn_signal_stalk);
+    values.SetRaw(cmd.blockBasicCruiseButtons, msg->block_standard_cruise_buttons);
+    values.SetRaw(cmd.blockAdaptiveCruiseButtons, msg->block_adaptive_cruise_buttons);
+    values.SetRaw(cmd.blockTurnSignalStalk, msg->block_turn_signal_stalk);
 
   }
 
-  message->GetSignal("AKit_OtherRollingCntr")->SetResult(msg->rolling_counter);
+  values.SetRaw(cmd.rollingCounter, msg->rolling_counter);
 
-  can_msgs::Frame frame = message->GetFrame();
+  can_msgs::Frame::Ptr frame = can_frame_pool_.get();
+  message->Encode(values, *frame);
 
-  pub_can_.publish(frame);
+  pub_can_.publish(can_msgs::Frame::ConstPtr(frame));
 }
 
-bool DbwNode::publishDbwEnabled()
+// Called with the state from before and after a swap on state_, by the thread whose swap
+//  it was, so each flip of the enable is published once and without a lock.  Returns true
+//  when the swap flipped it.
+bool DbwNode::publishDbwEnabled(uint32_t previous, uint32_t state)
 {
-  bool change = false;
-  bool en = enabled();
-  if (prev_enable_ != en) {
-    std_msgs::Bool msg;
-    msg.data = en;
-    pub_sys_enable_.publish(msg);
-    change = true;
+  bool en = enabled(state);
+  if (enabled(previous) == en) {
+    return false;
   }
-  prev_enable_ = en;
-  return change;
+  std_msgs::Bool msg;
+  msg.data = en;
+  pub_sys_enable_.publish(msg);
+  return true;
 }
 
 void DbwNode::timerCallback(const ros::TimerEvent& event)
 {
-  if (clear()) {
-    can_msgs::Frame out;
-    out.is_extended = false;
-
-    if (override_brake_) {
+  std::shared_ptr<DbwDbc> dbc = std::atomic_load(&dbc_);
+  uint32_t state = state_.load();
+  if (clear(state)) {
+    if (state & STATE_OVERRIDE_BRAKE) {
       // Might have an issue with WatchdogCntr when these are set.
-      NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_BrakeRequest");
-      message->GetSignal("AKit_BrakePedalReq")->SetResult(0);
-      message->GetSignal("AKit_BrakeCtrlEnblReq")->SetResult(0);
+      const BrakeCmdSignals &cmd = dbc->signals.brakeCmd;
+      const NewEagle::DbcMessage* message = cmd.message;
+      NewEagle::DecodedFrame &values = timer_frame_;
+      restorePayload(message, dbc->brakeCmdData, values);
+      values.SetValue(cmd.pedalRequest, 0);
+      values.SetRaw(cmd.enableRequest, 0);
       //message->GetSignal("AKit_BrakePedalCtrlMode")->SetResult(0);
-      pub_can_.publish(message->GetFrame());
+      can_msgs::Frame::Ptr out = timer_frame_pool_.get();
+      message->Encode(values, *out);
+      pub_can_.publish(can_msgs::Frame::ConstPtr(out));
     }
 
-    if (override_accelerator_pedal_)
+    if (state & STATE_OVERRIDE_ACCELERATOR_PEDAL)
     {
       // Might have an issue with WatchdogCntr when these are set.
-      NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_AccelPdlRequest");
-      message->GetSignal("AKit_AccelPdlReq")->SetResult(0);
-      message->GetSignal("AKit_AccelPdlEnblReq")->SetResult(0);
-      message->GetSignal("Akit_AccelPdlIgnoreDriverOvrd")->SetResult(0);
+      const AcceleratorPedalCmdSignals &cmd = dbc->signals.acceleratorPedalCmd;
+      const NewEagle::DbcMessage* message = cmd.message;
+      NewEagle::DecodedFrame &values = timer_frame_;
+      restorePayload(message, dbc->acceleratorPedalCmdData, values);
+      values.SetValue(cmd.pedalRequest, 0);
+      values.SetRaw(cmd.enableRequest, 0);
+      values.SetRaw(cmd.ignoreDriverOverride, 0);
       //message->GetSignal("AKit_AccelPdlCtrlMode")->SetResult(0);
-      pub_can_.publish(message->GetFrame());
+      can_msgs::Frame::Ptr out = timer_frame_pool_.get();
+      message->Encode(values, *out);
+      pub_can_.publish(can_msgs::Frame::ConstPtr(out));
     }
 
-    if (override_steering_) {
+    if (state & STATE_OVERRIDE_STEERING) {
       // Might have an issue with WatchdogCntr when these are set.
-      NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_SteeringRequest");
-      message->GetSignal("AKit_SteeringWhlAngleReq")->SetResult(0);
-      message->GetSignal("AKit_SteeringWhlAngleVelocityLim")->SetResult(0);
-      message->GetSignal("AKit_SteeringWhlIgnoreDriverOvrd")->SetResult(0);
-      message->GetSignal("AKit_SteeringWhlPcntTrqReq")->SetResult(0);
+      const SteeringCmdSignals &cmd = dbc->signals.steeringCmd;
+      const NewEagle::DbcMessage* message = cmd.message;
+      NewEagle::DecodedFrame &values = timer_frame_;
+      restorePayload(message, dbc->steeringCmdData, values);
+      values.SetValue(cmd.angleRequest, 0);
+      values.SetValue(cmd.angleVelocityLimit, 0);
+      values.SetRaw(cmd.ignoreDriverOverride, 0);
+      values.SetValue(cmd.torqueRequest, 0);
       //message->GetSignal("AKit_SteeringWhlCtrlMode")->SetResult(0);
       //message->GetSignal("AKit_SteeringWhlCmdType")->SetResult(0);
 
-      pub_can_.publish(message->GetFrame());
+      can_msgs::Frame::Ptr out = timer_frame_pool_.get();
+      message->Encode(values, *out);
+      pub_can_.publish(can_msgs::Frame::ConstPtr(out));
     }
 
-    if (override_gear_) {
-      NewEagle::DbcMessage* message = dbwDbc_.GetMessage("AKit_GearRequest");
-      message->GetSignal("AKit_PrndStateCmd")->SetResult(0);
-      message->GetSignal("AKit_PrndChecksum")->SetResult(0);
-      pub_can_.publish(message->GetFrame());
+    if (state & STATE_OVERRIDE_GEAR) {
+      const GearCmdSignals &cmd = dbc->signals.gearCmd;
+      const NewEagle::DbcMessage* message = cmd.message;
+      NewEagle::DecodedFrame &values = timer_frame_;
+      restorePayload(message, dbc->gearCmdData, values);
+      values.SetRaw(cmd.stateRequest, 0);
+      if (cmd.checksum != NULL) {
+        values.SetRaw(cmd.checksum, 0);
+      }
+      can_msgs::Frame::Ptr out = timer_frame_pool_.get();
+      message->Encode(values, *out);
+      pub_can_.publish(can_msgs::Frame::ConstPtr(out));
     }
   }
 }
 
+// Decodes the payload last sent for a command message, for the timer to change and re-send.
+void DbwNode::restorePayload(const NewEagle::DbcMessage* message, const std::atomic<uint64_t> &data, NewEagle::DecodedFrame &values)
+{
+  uint64_t payload = data.load();
+  message->Decode((const uint8_t*)&payload, values);
+}
+
+// Sets or clears one state flag.  A fault or override raised while enabled also drops
+//  the enable, in the same swap.  Returns the state from before the change.
+uint32_t DbwNode::updateState(uint32_t flag, bool set)
+{
+  uint32_t state = state_.load();
+  while (!state_.compare_exchange_weak(state, nextState(state, flag, set))) {
+  }
+  return state;
+}
+
+uint32_t DbwNode::nextState(uint32_t state, uint32_t flag, bool set)
+{
+  uint32_t next = set ? (state | flag) : (state & ~flag);
+  if (set && enabled(state)) {
+    next &= ~STATE_ENABLE;
+  }
+  return next;
+}
+
 void DbwNode::enableSystem()
 {
-  if (!enable_) {
-    if (fault()) {
-      if (fault_steering_cal_) {
+  uint32_t state = state_.load();
+  while (!(state & STATE_ENABLE)) {
+    if (fault(state)) {
+      if (state & STATE_FAULT_STEERING_CAL) {
         ROS_WARN("DBW system not enabled. Steering calibration fault.");
       }
-      if (fault_brakes_) {
+      if (state & STATE_FAULT_BRAKES) {
         ROS_WARN("DBW system not enabled. Braking fault.");
       }
-      if (fault_accelerator_pedal_) {
+      if (state & STATE_FAULT_ACCELERATOR_PEDAL) {
         ROS_WARN("DBW system not enabled. Accelerator Pedal fault.");
       }
-      if (fault_steering_) {
+      if (state & STATE_FAULT_STEERING) {
         ROS_WARN("DBW system not enabled. Steering fault.");
       }
-      if (fault_watchdog_) {
+      if (state & STATE_FAULT_WATCHDOG) {
         ROS_WARN("DBW system not enabled. Watchdog fault.");
       }
-    } else {
-      enable_ = true;
-      if (publishDbwEnabled()) {
+      return;
+    }
+    if (state_.compare_exchange_weak(state, state | STATE_ENABLE)) {
+      if (publishDbwEnabled(state, state | STATE_ENABLE)) {
         ROS_INFO("DBW system enabled.");
       } else {
         ROS_INFO("DBW system enable requested. Waiting for ready.");
       }
+      return;
     }
   }
 }
 
 void DbwNode::disableSystem()
 {
-  if (enable_) {
-    enable_ = false;
-    publishDbwEnabled();
+  uint32_t state = state_.fetch_and(~STATE_ENABLE);
+  if (state & STATE_ENABLE) {
+    publishDbwEnabled(state, state & ~STATE_ENABLE);
     ROS_WARN("DBW system disabled.");
   }
 }
 
 void DbwNode::buttonCancel()
 {
-  if (enable_) {
-    enable_ = false;
-    publishDbwEnabled();
+  uint32_t state = state_.fetch_and(~STATE_ENABLE);
+  if (state & STATE_ENABLE) {
+    publishDbwEnabled(state, state & ~STATE_ENABLE);
     ROS_WARN("DBW system disabled. Cancel button pressed.");
   }
 }
 
 void DbwNode::overrideBrake(bool override)
 {
-  bool en = enabled();
-  if (override && en) {
-    enable_ = false;
-  }
-  override_brake_ = override;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_OVERRIDE_BRAKE, override);
+  if (publishDbwEnabled(state, nextState(state, STATE_OVERRIDE_BRAKE, override))) {
+    if (enabled(state)) {
       ROS_WARN("DBW system disabled. Driver override on brake/Accelerator Pedal pedal.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -990,13 +1226,9 @@ void DbwNode::overrideBrake(bool override)
 
 void DbwNode::overrideAcceleratorPedal(bool override)
 {
-  bool en = enabled();
-  if (override && en) {
-    enable_ = false;
-  }
-  override_accelerator_pedal_ = override;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_OVERRIDE_ACCELERATOR_PEDAL, override);
+  if (publishDbwEnabled(state, nextState(state, STATE_OVERRIDE_ACCELERATOR_PEDAL, override))) {
+    if (enabled(state)) {
       ROS_WARN("DBW system disabled. Driver override on brake/Accelerator Pedal pedal.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1006,13 +1238,9 @@ void DbwNode::overrideAcceleratorPedal(bool override)
 
 void DbwNode::overrideSteering(bool override)
 {
-  bool en = enabled();
-  if (override && en) {
-    enable_ = false;
-  }
-  override_steering_ = override;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_OVERRIDE_STEERING, override);
+  if (publishDbwEnabled(state, nextState(state, STATE_OVERRIDE_STEERING, override))) {
+    if (enabled(state)) {
       ROS_WARN("DBW system disabled. Driver override on steering wheel.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1022,13 +1250,9 @@ void DbwNode::overrideSteering(bool override)
 
 void DbwNode::overrideGear(bool override)
 {
-  bool en = enabled();
-  if (override && en) {
-    enable_ = false;
-  }
-  override_gear_ = override;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_OVERRIDE_GEAR, override);
+  if (publishDbwEnabled(state, nextState(state, STATE_OVERRIDE_GEAR, override))) {
+    if (enabled(state)) {
       ROS_WARN("DBW system disabled. Driver override on shifter.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1065,13 +1289,9 @@ void DbwNode::timeoutSteering(bool timeout, bool enabled)
 
 void DbwNode::faultBrakes(bool fault)
 {
-  bool en = enabled();
-  if (fault && en) {
-    enable_ = false;
-  }
-  fault_brakes_ = fault;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_FAULT_BRAKES, fault);
+  if (publishDbwEnabled(state, nextState(state, STATE_FAULT_BRAKES, fault))) {
+    if (enabled(state)) {
       ROS_ERROR("DBW system disabled. Braking fault.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1081,13 +1301,9 @@ void DbwNode::faultBrakes(bool fault)
 
 void DbwNode::faultAcceleratorPedal(bool fault)
 {
-  bool en = enabled();
-  if (fault && en) {
-    enable_ = false;
-  }
-  fault_accelerator_pedal_ = fault;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_FAULT_ACCELERATOR_PEDAL, fault);
+  if (publishDbwEnabled(state, nextState(state, STATE_FAULT_ACCELERATOR_PEDAL, fault))) {
+    if (enabled(state)) {
       ROS_ERROR("DBW system disabled. Accelerator Pedal fault.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1097,13 +1313,9 @@ void DbwNode::faultAcceleratorPedal(bool fault)
 
 void DbwNode::faultSteering(bool fault)
 {
-  bool en = enabled();
-  if (fault && en) {
-    enable_ = false;
-  }
-  fault_steering_ = fault;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_FAULT_STEERING, fault);
+  if (publishDbwEnabled(state, nextState(state, STATE_FAULT_STEERING, fault))) {
+    if (enabled(state)) {
       ROS_ERROR("DBW system disabled. Steering fault.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1113,13 +1325,9 @@ void DbwNode::faultSteering(bool fault)
 
 void DbwNode::faultSteeringCal(bool fault)
 {
-  bool en = enabled();
-  if (fault && en) {
-    enable_ = false;
-  }
-  fault_steering_cal_ = fault;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_FAULT_STEERING_CAL, fault);
+  if (publishDbwEnabled(state, nextState(state, STATE_FAULT_STEERING_CAL, fault))) {
+    if (enabled(state)) {
       ROS_ERROR("DBW system disabled. Steering calibration fault.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1129,13 +1337,9 @@ void DbwNode::faultSteeringCal(bool fault)
 
 void DbwNode::faultWatchdog(bool fault, uint8_t src, bool braking)
 {
-  bool en = enabled();
-  if (fault && en) {
-    enable_ = false;
-  }
-  fault_watchdog_ = fault;
-  if (publishDbwEnabled()) {
-    if (en) {
+  uint32_t state = updateState(STATE_FAULT_WATCHDOG, fault);
+  if (publishDbwEnabled(state, nextState(state, STATE_FAULT_WATCHDOG, fault))) {
+    if (enabled(state)) {
       ROS_ERROR("DBW system disabled. Watchdog fault.");
     } else {
       ROS_INFO("DBW system enabled.");
@@ -1231,7 +1435,10 @@ void DbwNode::publishJointStates(const ros::Time &stamp, const dbw_pacifica_msgs
     }
   }
   joint_state_.header.stamp = stamp;
-  pub_joint_states_.publish(joint_state_);
+
+  sensor_msgs::JointState::Ptr out = joint_state_pool_.get();
+  *out = joint_state_;
+  pub_joint_states_.publish(sensor_msgs::JointState::ConstPtr(out));
 }
 
 } // dbw_pacifica_can
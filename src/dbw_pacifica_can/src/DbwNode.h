@@ -37,6 +37,10 @@
 #define _DBW_NODE_H_
 
 #include <ros/ros.h>
+#include <ros/callback_queue.h>
+
+#include <atomic>
+#include <memory>
 
 // ROS messages
 #include <can_msgs/Frame.h>
@@ -60,6 +64,8 @@
 #include <dbw_pacifica_msgs/Brake2Report.h>
 #include <dbw_pacifica_msgs/Steering2Report.h>
 #include <dbw_pacifica_msgs/GlobalEnableCmd.h>
+#include <dbw_pacifica_msgs/ReloadDbc.h>
+#include <kvaser_interface/FrameArray.h>
 
 
 #include <sensor_msgs/Imu.h>
@@ -74,6 +80,12 @@
 #include <dbc/DbcSignal.h>
 #include <dbc/Dbc.h>
 #include <dbc/DbcBuilder.h>
+#include <dbc/DbcCache.h>
+#include <dbc/DbcRegistry.h>
+
+#include "DbwSignals.h"
+#include "MessagePool.h"
+#include <dbw_pacifica_can/dispatch.h>
 
 #include <pdu_msgs/RelayCommand.h>
 #include <pdu_msgs/RelayState.h>
@@ -88,10 +100,86 @@ public:
   ~DbwNode();
 
 private:
+  typedef void (DbwNode::*ReportHandler)(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+
+  // recvCAN dispatch entry: the handler for one report ID and the shortest frame it takes.
+  struct ReportRoute
+  {
+    ReportHandler handler;
+    uint8_t minDlc;
+  };
+
+  // A loaded DBC, the signals resolved against it and the recvCAN dispatch table built
+  //  from them.  The pointers are into dbc, so all of it is only ever replaced together.
+  //  The Dbc comes from DbcRegistry and is only read: every thread decodes and encodes
+  //  through a DecodedFrame of its own.
+  //
+  // The override timer re-sends the last command frames on its own thread, decoded from
+  //  the payloads the command handlers leave in the *CmdData words.
+  struct DbwDbc
+  {
+    std::shared_ptr<const NewEagle::Dbc> dbc;
+    DbwSignals signals;
+    ReportRoute routes[ID_REPORT_COUNT]; // indexed by CAN ID - ID_REPORT_FIRST
+
+    std::atomic<uint64_t> brakeCmdData;
+    std::atomic<uint64_t> acceleratorPedalCmdData;
+    std::atomic<uint64_t> steeringCmdData;
+    std::atomic<uint64_t> gearCmdData;
+
+    uint32_t generation; // counts loads, so the RX thread sees when its caches are stale
+  };
+
+  // Frees a DbwDbc on the reload thread.  It is queued by the deleter of the last
+  //  reference, which may be dropped by any callback; dropped unrun, it frees it anyway.
+  class DbwDbcRelease : public ros::CallbackInterface
+  {
+  public:
+    explicit DbwDbcRelease(DbwDbc *dbc) : dbc_(dbc) {}
+    virtual CallResult call();
+
+  private:
+    std::unique_ptr<DbwDbc> dbc_;
+  };
+
+  // Enable, override and fault flags, one bit each in state_.  Every thread reads them
+  //  with one load and changes them with one compare-and-swap, so the RX, command and
+  //  timer threads never wait on each other for them.
+  enum {
+    STATE_ENABLE                     = 1 << 0,
+    STATE_OVERRIDE_BRAKE             = 1 << 1,
+    STATE_OVERRIDE_ACCELERATOR_PEDAL = 1 << 2,
+    STATE_OVERRIDE_STEERING          = 1 << 3,
+    STATE_OVERRIDE_GEAR              = 1 << 4,
+    STATE_FAULT_BRAKES               = 1 << 5,
+    STATE_FAULT_ACCELERATOR_PEDAL    = 1 << 6,
+    STATE_FAULT_STEERING             = 1 << 7,
+    STATE_FAULT_STEERING_CAL         = 1 << 8,
+    STATE_FAULT_WATCHDOG             = 1 << 9,
+    STATE_OVERRIDE = STATE_OVERRIDE_BRAKE | STATE_OVERRIDE_ACCELERATOR_PEDAL | STATE_OVERRIDE_STEERING | STATE_OVERRIDE_GEAR,
+    STATE_FAULT = STATE_FAULT_BRAKES | STATE_FAULT_ACCELERATOR_PEDAL | STATE_FAULT_STEERING | STATE_FAULT_STEERING_CAL | STATE_FAULT_WATCHDOG,
+  };
+
   void timerCallback(const ros::TimerEvent& event);
   void recvEnable(const std_msgs::Empty::ConstPtr& msg);
   void recvDisable(const std_msgs::Empty::ConstPtr& msg);
   void recvCAN(const can_msgs::Frame::ConstPtr& msg);
+  void recvCANArray(const kvaser_interface::FrameArray::ConstPtr& msg);
+  void recvBrakeReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvAcceleratorPedalReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvSteeringReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvGearReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvWheelSpeedReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvWheelPositionReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvTirePressureReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvSurroundReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvVin(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvImuReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvDriverInputReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvMiscReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvLowVoltageSystemReport(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvBrake2Report(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
+  void recvSteering2Report(const DbwSignals &signals, const can_msgs::Frame::ConstPtr& msg);
   void recvCanImu(const std::vector<can_msgs::Frame::ConstPtr> &msgs);
   void recvCanGps(const std::vector<can_msgs::Frame::ConstPtr> &msgs);
   void recvBrakeCmd(const dbw_pacifica_msgs::BrakeCmd::ConstPtr& msg);
@@ -100,19 +188,33 @@ private:
   void recvGearCmd(const dbw_pacifica_msgs::GearCmd::ConstPtr& msg);
   void recvMiscCmd(const dbw_pacifica_msgs::MiscCmd::ConstPtr& msg);
   void recvGlobalEnableCmd(const dbw_pacifica_msgs::GlobalEnableCmd::ConstPtr& msg);
+  bool reloadDbc(dbw_pacifica_msgs::ReloadDbc::Request &req, dbw_pacifica_msgs::ReloadDbc::Response &res);
+  std::shared_ptr<DbwDbc> loadDbc(const std::string &path, const std::string &text);
+  void releaseDbc(DbwDbc *dbc);
+  static void setRoute(DbwDbc &loaded, uint32_t id, ReportHandler handler, uint8_t minDlc);
+  static uint64_t encodedPayload(const NewEagle::DbcMessage* message);
+  static uint64_t payloadWord(const uint8_t* data);
+  static void restorePayload(const NewEagle::DbcMessage* message, const std::atomic<uint64_t> &data, NewEagle::DecodedFrame &values);
+
+  // Callbacks run on three queues, each with its own thread: can_rx decoding, command
+  //  encoding (with enable/disable) and the override timer.  A burst of reports then
+  //  no longer holds up a command.  Declared ahead of the subscriptions and timer so
+  //  the queues outlive them.
+  ros::CallbackQueue rx_queue_;
+  ros::CallbackQueue cmd_queue_;
+  ros::CallbackQueue timer_queue_;
+
+  // Signal values of the frame being decoded or encoded on each of those threads
+  NewEagle::DecodedFrame rx_frame_;
+  NewEagle::DecodedFrame cmd_frame_;
+  NewEagle::DecodedFrame timer_frame_;
 
   ros::Timer timer_;
-  bool prev_enable_;
-  bool enable_;
-  bool override_brake_;
-  bool override_accelerator_pedal_;
-  bool override_steering_;
-  bool override_gear_;
-  bool fault_brakes_;
-  bool fault_accelerator_pedal_;
-  bool fault_steering_;
-  bool fault_steering_cal_;
-  bool fault_watchdog_;
+  std::atomic<uint32_t> state_;
+  uint32_t updateState(uint32_t flag, bool set);
+  static uint32_t nextState(uint32_t state, uint32_t flag, bool set);
+
+  // Only touched on the RX thread
   bool fault_watchdog_using_brakes_;
   bool fault_watchdog_warned_;
   bool timeout_brakes_;
@@ -122,11 +224,14 @@ private:
   bool enabled_accelerator_pedal_;
   bool enabled_steering_;
   bool gear_warned_;
-  inline bool fault() { return fault_brakes_ || fault_accelerator_pedal_ || fault_steering_ || fault_steering_cal_ || fault_watchdog_; }
-  inline bool override() { return override_brake_ || override_accelerator_pedal_ || override_steering_ || override_gear_; }
-  inline bool clear() { return enable_ && override(); }
-  inline bool enabled() { return enable_ && !fault() && !override(); }
-  bool publishDbwEnabled();
+  uint32_t rx_generation_; // generation of the DBC the report caches were built with
+  void resetReports();
+  static inline bool fault(uint32_t state) { return state & STATE_FAULT; }
+  static inline bool override(uint32_t state) { return state & STATE_OVERRIDE; }
+  static inline bool clear(uint32_t state) { return (state & STATE_ENABLE) && override(state); }
+  static inline bool enabled(uint32_t state) { return (state & STATE_ENABLE) && !fault(state) && !override(state); }
+  inline bool enabled() { return enabled(state_.load()); }
+  bool publishDbwEnabled(uint32_t previous, uint32_t state);
   void enableSystem();
   void disableSystem();
   void buttonCancel();
@@ -158,6 +263,19 @@ private:
   // Licensing
   std::string vin_;
 
+  // Last reports built from frames that repeat for long stretches, and the payloads
+  //  they were built from; a repeated frame only restamps them and publishes a copy
+  struct ReportPayload
+  {
+    bool valid;
+    uint64_t data;
+  };
+  static bool repeatsPayload(ReportPayload &last, const can_msgs::Frame &msg);
+  dbw_pacifica_msgs::TirePressureReport tire_pressure_report_;
+  dbw_pacifica_msgs::LowVoltageSystemReport low_voltage_system_report_;
+  ReportPayload tire_pressure_payload_;
+  ReportPayload low_voltage_system_payload_;
+
   // Frame ID
   std::string frame_id_;
 
@@ -173,6 +291,7 @@ private:
   ros::Subscriber sub_enable_;
   ros::Subscriber sub_disable_;
   ros::Subscriber sub_can_;
+  ros::Subscriber sub_can_array_;
   ros::Subscriber sub_brake_;
   ros::Subscriber sub_accelerator_pedal_;
   ros::Subscriber sub_steering_;
@@ -202,12 +321,47 @@ private:
   ros::Publisher pub_brake_2_report_;
   ros::Publisher pub_steering_2_report_;
 
-  NewEagle::Dbc dbwDbc_;
+  // Published messages come out of these and go out as ConstPtr, so nodelets in the
+  //  same manager get them without a copy.  Each is used from one thread only.
+  MessagePool<can_msgs::Frame> can_frame_pool_;
+  MessagePool<can_msgs::Frame> timer_frame_pool_;
+  MessagePool<dbw_pacifica_msgs::BrakeReport> brake_report_pool_;
+  MessagePool<dbw_pacifica_msgs::AcceleratorPedalReport> accel_pedal_report_pool_;
+  MessagePool<dbw_pacifica_msgs::SteeringReport> steering_report_pool_;
+  MessagePool<dbw_pacifica_msgs::GearReport> gear_report_pool_;
+  MessagePool<dbw_pacifica_msgs::WheelSpeedReport> wheel_speed_report_pool_;
+  MessagePool<dbw_pacifica_msgs::WheelPositionReport> wheel_position_report_pool_;
+  MessagePool<dbw_pacifica_msgs::TirePressureReport> tire_pressure_report_pool_;
+  MessagePool<dbw_pacifica_msgs::SurroundReport> surround_report_pool_;
+  MessagePool<sensor_msgs::Imu> imu_pool_;
+  MessagePool<dbw_pacifica_msgs::DriverInputReport> driver_input_report_pool_;
+  MessagePool<dbw_pacifica_msgs::MiscReport> misc_report_pool_;
+  MessagePool<dbw_pacifica_msgs::LowVoltageSystemReport> low_voltage_system_report_pool_;
+  MessagePool<dbw_pacifica_msgs::Brake2Report> brake_2_report_pool_;
+  MessagePool<dbw_pacifica_msgs::Steering2Report> steering_2_report_pool_;
+  MessagePool<sensor_msgs::JointState> joint_state_pool_;
+
+  // Callbacks take their own reference to the current DBC on entry, so a reload can
+  //  swap in a new one while a decode still finishes on the old.
+  std::shared_ptr<DbwDbc> dbc_;
+  uint32_t dbc_generation_;
   std::string dbcFile_;
+  std::string dbcPath_;
+  std::string dbcCacheDir_;
+
+  // Reloads are built on their own queue and thread, so reports keep flowing meanwhile.
+  ros::CallbackQueue reload_queue_;
+  ros::ServiceServer srv_reload_dbc_;
 
   // Test stuff
   ros::Publisher pdu1_relay_pub_;
   uint32_t count_;
+
+  // Declared last so the threads stop before the rest of the node is torn down.
+  boost::shared_ptr<ros::AsyncSpinner> reload_spinner_;
+  boost::shared_ptr<ros::AsyncSpinner> rx_spinner_;
+  boost::shared_ptr<ros::AsyncSpinner> cmd_spinner_;
+  boost::shared_ptr<ros::AsyncSpinner> timer_spinner_;
 };
 
 } // dbw_pacifica_can
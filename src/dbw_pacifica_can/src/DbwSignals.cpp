@@ -0,0 +1,270 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "DbwSignals.h"
+#include <stdio.h>
+#include <dbw_pacifica_can/dispatch.h>
+
+namespace dbw_pacifica_can
+{
+
+void DbwSignals::Resolve(const NewEagle::Dbc &dbc)
+{
+  const NewEagle::DbcMessage* message;
+
+  // Reports are matched by CAN ID, the same way recvCAN dispatches them.
+  message = dbc.ResolveMessageById(ID_BRAKE_REPORT);
+  brakeReport.message = message;
+  brakeReport.faultCh1 = message->ResolveSignal("DBW_BrakeFault_Ch1");
+  brakeReport.faultCh2 = message->ResolveSignal("DBW_BrakeFault_Ch2");
+  brakeReport.fault = message->ResolveSignal("DBW_BrakeFault");
+  brakeReport.driverActivity = message->ResolveSignal("DBW_BrakeDriverActivity");
+  brakeReport.pedalDriverInput = message->ResolveSignal("DBW_BrakePdlDriverInput");
+  brakeReport.pedalPositionFeedback = message->ResolveSignal("DBW_BrakePdlPosnFdbck");
+  brakeReport.enabled = message->ResolveSignal("DBW_BrakeEnabled");
+  brakeReport.rollingCounter = message->ResolveSignal("DBW_BrakeRollingCntr");
+  brakeReport.torqueActual = message->ResolveSignal("DBW_BrakePcntTorqueActual");
+  brakeReport.interventionActive = message->ResolveSignal("DBW_BrakeInterventionActv");
+  brakeReport.interventionReady = message->ResolveSignal("DBW_BrakeInterventionReady");
+  brakeReport.parkingBrakeStatus = message->ResolveSignal("DBW_BrakeParkingBrkStatus");
+  brakeReport.controlType = message->ResolveSignal("DBW_BrakeCtrlType");
+
+  message = dbc.ResolveMessageById(ID_ACCEL_PEDAL_REPORT);
+  acceleratorPedalReport.message = message;
+  acceleratorPedalReport.faultCh1 = message->ResolveSignal("DBW_AccelPdlFault_Ch1");
+  acceleratorPedalReport.faultCh2 = message->ResolveSignal("DBW_AccelPdlFault_Ch2");
+  acceleratorPedalReport.fault = message->ResolveSignal("DBW_AccelPdlFault");
+  acceleratorPedalReport.driverActivity = message->ResolveSignal("DBW_AccelPdlDriverActivity");
+  acceleratorPedalReport.pedalDriverInput = message->ResolveSignal("DBW_AccelPdlDriverInput");
+  acceleratorPedalReport.pedalPositionFeedback = message->ResolveSignal("DBW_AccelPdlPosnFdbck");
+  acceleratorPedalReport.enabled = message->ResolveSignal("DBW_AccelPdlEnabled");
+  acceleratorPedalReport.ignoreDriver = message->ResolveSignal("DBW_AccelPdlIgnoreDriver");
+  acceleratorPedalReport.torqueActual = message->ResolveSignal("DBW_AccelPcntTorqueActual");
+  acceleratorPedalReport.controlType = message->ResolveSignal("DBW_AccelCtrlType");
+  acceleratorPedalReport.rollingCounter = message->ResolveSignal("DBW_AccelPdlRollingCntr");
+
+  message = dbc.ResolveMessageById(ID_STEERING_REPORT);
+  steeringReport.message = message;
+  steeringReport.fault = message->ResolveSignal("DBW_SteeringFault");
+  steeringReport.driverActivity = message->ResolveSignal("DBW_SteeringDriverActivity");
+  steeringReport.wheelAngleActual = message->ResolveSignal("DBW_SteeringWhlAngleAct");
+  steeringReport.wheelAngleDesired = message->ResolveSignal("DBW_SteeringWhlAngleDes");
+  steeringReport.wheelTorqueCommand = message->ResolveSignal("DBW_SteeringWhlPcntTrqCmd");
+  steeringReport.enabled = message->ResolveSignal("DBW_SteeringEnabled");
+  steeringReport.rollingCounter = message->ResolveSignal("DBW_SteeringRollingCntr");
+  steeringReport.controlType = message->ResolveSignal("DBW_SteeringCtrlType");
+  steeringReport.overheatPreventMode = message->ResolveSignal("DBW_OverheatPreventMode");
+
+  message = dbc.ResolveMessageById(ID_GEAR_REPORT);
+  gearReport.message = message;
+  gearReport.driverActivity = message->ResolveSignal("DBW_PrndDriverActivity");
+  gearReport.enabled = message->ResolveSignal("DBW_PrndCtrlEnabled");
+  gearReport.stateActual = message->ResolveSignal("DBW_PrndStateActual");
+  gearReport.fault = message->ResolveSignal("DBW_PrndFault");
+  gearReport.stateReject = message->ResolveSignal("DBW_PrndStateReject");
+
+  message = dbc.ResolveMessageById(ID_REPORT_WHEEL_SPEED);
+  wheelSpeedReport.message = message;
+  wheelSpeedReport.frontLeft = message->ResolveSignal("DBW_WhlRpm_FL");
+  wheelSpeedReport.frontRight = message->ResolveSignal("DBW_WhlRpm_FR");
+  wheelSpeedReport.rearLeft = message->ResolveSignal("DBW_WhlRpm_RL");
+  wheelSpeedReport.rearRight = message->ResolveSignal("DBW_WhlRpm_RR");
+
+  message = dbc.ResolveMessageById(ID_REPORT_WHEEL_POSITION);
+  wheelPositionReport.message = message;
+  wheelPositionReport.frontLeft = message->ResolveSignal("DBW_WhlPulseCnt_FL");
+  wheelPositionReport.frontRight = message->ResolveSignal("DBW_WhlPulseCnt_FR");
+  wheelPositionReport.rearLeft = message->ResolveSignal("DBW_WhlPulseCnt_RL");
+  wheelPositionReport.rearRight = message->ResolveSignal("DBW_WhlPulseCnt_RR");
+  wheelPositionReport.pulsesPerRev = message->ResolveSignal("DBW_WhlPulsesPerRev");
+
+  message = dbc.ResolveMessageById(ID_REPORT_TIRE_PRESSURE);
+  tirePressureReport.message = message;
+  tirePressureReport.frontLeft = message->ResolveSignal("DBW_TirePressFL");
+  tirePressureReport.frontRight = message->ResolveSignal("DBW_TirePressFR");
+  tirePressureReport.rearLeft = message->ResolveSignal("DBW_TirePressRL");
+  tirePressureReport.rearRight = message->ResolveSignal("DBW_TirePressRR");
+
+  message = dbc.ResolveMessageById(ID_REPORT_SURROUND);
+  surroundReport.message = message;
+  surroundReport.frontRadarDistance = message->ResolveSignal("DBW_Reserved2");
+  surroundReport.rearRadarDistance = message->ResolveSignal("DBW_SonarRearDist");
+  surroundReport.frontRadarValid = message->ResolveSignal("DBW_Reserved3");
+  surroundReport.sonarValid = message->ResolveSignal("DBW_SonarVld");
+  surroundReport.sonarArcRearRight = message->ResolveSignal("DBW_SonarArcNumRR");
+  surroundReport.sonarArcRearLeft = message->ResolveSignal("DBW_SonarArcNumRL");
+  surroundReport.sonarArcRearCenter = message->ResolveSignal("DBW_SonarArcNumRC");
+  surroundReport.sonarArcFrontRight = message->ResolveSignal("DBW_SonarArcNumFR");
+  surroundReport.sonarArcFrontLeft = message->ResolveSignal("DBW_SonarArcNumFL");
+  surroundReport.sonarArcFrontCenter = message->ResolveSignal("DBW_SonarArcNumFC");
+
+  message = dbc.ResolveMessageById(ID_VIN);
+  vinReport.message = message;
+  vinReport.multiplexor = message->ResolveSignal("DBW_VinMultiplexor");
+  for (int i = 0; i < VinReportSignals::DIGIT_COUNT; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "DBW_VinDigit_%02d", i + 1);
+    vinReport.digits[i] = message->ResolveSignal(name);
+  }
+
+  message = dbc.ResolveMessageById(ID_REPORT_IMU);
+  imuReport.message = message;
+  imuReport.yawRate = message->ResolveSignal("DBW_ImuYawRate");
+  imuReport.accelX = message->ResolveSignal("DBW_ImuAccelX");
+  imuReport.accelY = message->ResolveSignal("DBW_ImuAccelY");
+
+  message = dbc.ResolveMessageById(ID_REPORT_DRIVER_INPUT);
+  driverInputReport.message = message;
+  driverInputReport.turnSignal = message->ResolveSignal("DBW_DrvInptTurnSignal");
+  driverInputReport.highBeam = message->ResolveSignal("DBW_DrvInptHiBeam");
+  driverInputReport.wiper = message->ResolveSignal("DBW_DrvInptWiper");
+  driverInputReport.cruiseResumeButton = message->ResolveSignal("DBW_DrvInptCruiseResumeBtn");
+  driverInputReport.cruiseCancelButton = message->ResolveSignal("DBW_DrvInptCruiseCancelBtn");
+  driverInputReport.cruiseAccelButton = message->ResolveSignal("DBW_DrvInptCruiseAccelBtn");
+  driverInputReport.cruiseDecelButton = message->ResolveSignal("DBW_DrvInptCruiseDecelBtn");
+  driverInputReport.cruiseOnOffButton = message->ResolveSignal("DBW_DrvInptCruiseOnOffBtn");
+  driverInputReport.adaptiveCruiseOnOffButton = message->ResolveSignal("DBW_DrvInptAccOnOffBtn");
+  driverInputReport.adaptiveCruiseIncreaseDistanceButton = message->ResolveSignal("DBW_DrvInptAccIncDistBtn");
+  driverInputReport.adaptiveCruiseDecreaseDistanceButton = message->ResolveSignal("DBW_DrvInptAccDecDistBtn");
+  driverInputReport.doorOrHoodAjar = message->ResolveSignal("DBW_OccupAnyDoorOrHoodAjar");
+  driverInputReport.airbagDeployed = message->ResolveSignal("DBW_OccupAnyAirbagDeployed");
+  driverInputReport.anySeatbeltUnbuckled = message->ResolveSignal("DBW_OccupAnySeatbeltUnbuckled");
+
+  message = dbc.ResolveMessageById(ID_MISC_REPORT);
+  miscReport.message = message;
+  miscReport.fuelLevel = message->ResolveSignal("DBW_MiscFuelLvl");
+  miscReport.byWireEnabled = message->ResolveSignal("DBW_MiscByWireEnabled");
+  miscReport.vehicleSpeed = message->ResolveSignal("DBW_MiscVehicleSpeed");
+  miscReport.softwareBuildNumber = message->ResolveSignal("DBW_SoftwareBuildNumber");
+  miscReport.fault = message->ResolveSignal("DBW_MiscFault");
+  miscReport.byWireReady = message->ResolveSignal("DBW_MiscByWireReady");
+  miscReport.driverActivity = message->ResolveSignal("DBW_MiscDriverActivity");
+  miscReport.commsFault = message->ResolveSignal("DBW_MiscAKitCommFault");
+  miscReport.ambientTemp = message->GetSignal("DBW_AmbientTemp");
+
+  message = dbc.ResolveMessageById(ID_LOW_VOLTAGE_SYSTEM_REPORT);
+  lowVoltageSystemReport.message = message;
+  lowVoltageSystemReport.vehicleBatteryVolts = message->ResolveSignal("DBW_LvVehBattVlt");
+  lowVoltageSystemReport.vehicleBatteryCurrent = message->ResolveSignal("DBW_LvBattCurr");
+  lowVoltageSystemReport.alternatorCurrent = message->ResolveSignal("DBW_LvAlternatorCurr");
+  lowVoltageSystemReport.dbwBatteryVolts = message->ResolveSignal("DBW_LvDbwBattVlt");
+  lowVoltageSystemReport.dcdcCurrent = message->ResolveSignal("DBW_LvDcdcCurr");
+  lowVoltageSystemReport.batteryContactor = message->ResolveSignal("DBW_LvBattContactorCmd");
+  lowVoltageSystemReport.inverterContactor = message->ResolveSignal("DBW_LvInvtrContactorCmd");
+
+  message = dbc.ResolveMessageById(ID_BRAKE_2_REPORT);
+  brake2Report.message = message;
+  brake2Report.brakePressure = message->ResolveSignal("DBW_BrakePress_bar");
+  brake2Report.roadSlopeEstimate = message->ResolveSignal("DBW_RoadSlopeEstimate");
+
+  message = dbc.ResolveMessageById(ID_STEERING_2_REPORT);
+  steering2Report.message = message;
+  steering2Report.vehicleCurvatureActual = message->ResolveSignal("DBW_SteeringVehCurvatureAct");
+
+  // Commands are built by name.
+  message = dbc.ResolveMessage("AKit_BrakeRequest");
+  brakeCmd.message = message;
+  brakeCmd.pedalRequest = message->ResolveSignal("AKit_BrakePedalReq");
+  brakeCmd.enableRequest = message->ResolveSignal("AKit_BrakeCtrlEnblReq");
+  brakeCmd.requestType = message->ResolveSignal("AKit_BrakeCtrlReqType");
+  brakeCmd.torqueRequest = message->ResolveSignal("AKit_BrakePcntTorqueReq");
+  brakeCmd.accelLimit = message->ResolveSignal("AKit_SpeedModeAccelLim");
+  brakeCmd.decelLimit = message->ResolveSignal("AKit_SpeedModeDecelLim");
+  brakeCmd.rollingCounter = message->ResolveSignal("AKit_BrakeRollingCntr");
+
+  message = dbc.ResolveMessage("AKit_AccelPdlRequest");
+  acceleratorPedalCmd.message = message;
+  acceleratorPedalCmd.pedalRequest = message->ResolveSignal("AKit_AccelPdlReq");
+  acceleratorPedalCmd.enableRequest = message->ResolveSignal("AKit_AccelPdlEnblReq");
+  acceleratorPedalCmd.ignoreDriverOverride = message->ResolveSignal("Akit_AccelPdlIgnoreDriverOvrd");
+  acceleratorPedalCmd.rollingCounter = message->ResolveSignal("AKit_AccelPdlRollingCntr");
+  acceleratorPedalCmd.requestType = message->ResolveSignal("AKit_AccelReqType");
+  acceleratorPedalCmd.torqueRequest = message->ResolveSignal("AKit_AccelPcntTorqueReq");
+  acceleratorPedalCmd.checksum = message->GetSignal("AKit_AccelPdlChecksum");
+  acceleratorPedalCmd.speedRequest = message->ResolveSignal("AKit_SpeedReq");
+  acceleratorPedalCmd.roadSlope = message->ResolveSignal("AKit_SpeedModeRoadSlope");
+
+  message = dbc.ResolveMessage("AKit_SteeringRequest");
+  steeringCmd.message = message;
+  steeringCmd.angleRequest = message->ResolveSignal("AKit_SteeringWhlAngleReq");
+  steeringCmd.angleVelocityLimit = message->ResolveSignal("AKit_SteeringWhlAngleVelocityLim");
+  steeringCmd.enableRequest = message->ResolveSignal("AKit_SteerCtrlEnblReq");
+  steeringCmd.ignoreDriverOverride = message->ResolveSignal("AKit_SteeringWhlIgnoreDriverOvrd");
+  steeringCmd.torqueRequest = message->ResolveSignal("AKit_SteeringWhlPcntTrqReq");
+  steeringCmd.requestType = message->ResolveSignal("AKit_SteeringReqType");
+  steeringCmd.curvatureRequest = message->ResolveSignal("AKit_SteeringVehCurvatureReq");
+  steeringCmd.checksum = message->GetSignal("AKit_SteeringChecksum");
+  steeringCmd.rollingCounter = message->ResolveSignal("AKit_SteerRollingCntr");
+
+  message = dbc.ResolveMessage("AKit_PrndRequest");
+  gearCmd.message = message;
+  gearCmd.enableRequest = message->ResolveSignal("AKit_PrndCtrlEnblReq");
+  gearCmd.stateRequest = message->ResolveSignal("AKit_PrndStateReq");
+  gearCmd.checksum = message->GetSignal("AKit_PrndChecksum");
+  gearCmd.rollingCounter = message->ResolveSignal("AKit_PrndRollingCntr");
+
+  // New_Eagle_DBW.dbc predates these two messages, like the checksums and the
+  //  ambient temperature looked up with GetSignal above.  Missing ones stay NULL.
+  globalEnableCmd = GlobalEnableCmdSignals();
+  message = dbc.GetMessage("AKit_GlobalEnbl");
+  if (message != NULL) {
+    globalEnableCmd.message = message;
+    globalEnableCmd.rollingCounter = message->ResolveSignal("AKit_GlobalEnblRollingCntr");
+    globalEnableCmd.byWireEnableRequest = message->ResolveSignal("AKit_GlobalByWireEnblReq");
+    globalEnableCmd.enableJoystickLimits = message->ResolveSignal("AKit_EnblJoystickLimits");
+    globalEnableCmd.softwareBuildNumber = message->ResolveSignal("AKit_SoftwareBuildNumber");
+    globalEnableCmd.checksum = message->ResolveSignal("Akit_GlobalEnblChecksum");
+  }
+
+  miscCmd = MiscCmdSignals();
+  message = dbc.GetMessage("AKit_OtherActuators");
+  if (message != NULL) {
+    miscCmd.message = message;
+    miscCmd.turnSignalRequest = message->ResolveSignal("AKit_TurnSignalReq");
+    miscCmd.rightRearDoorRequest = message->ResolveSignal("AKit_RightRearDoorReq");
+    miscCmd.highBeamRequest = message->ResolveSignal("AKit_HighBeamReq");
+    miscCmd.frontWiperRequest = message->ResolveSignal("AKit_FrontWiperReq");
+    miscCmd.rearWiperRequest = message->ResolveSignal("AKit_RearWiperReq");
+    miscCmd.ignitionRequest = message->ResolveSignal("AKit_IgnitionReq");
+    miscCmd.leftRearDoorRequest = message->ResolveSignal("AKit_LeftRearDoorReq");
+    miscCmd.liftgateDoorRequest = message->ResolveSignal("AKit_LiftgateDoorReq");
+    miscCmd.blockBasicCruiseButtons = message->ResolveSignal("AKit_BlockBasicCruiseCtrlBtns");
+    miscCmd.blockAdaptiveCruiseButtons = message->ResolveSignal("AKit_BlockAdapCruiseCtrlBtns");
+    miscCmd.blockTurnSignalStalk = message->ResolveSignal("AKit_BlockTurnSigStalkInpts");
+    miscCmd.checksum = message->ResolveSignal("AKit_OtherChecksum");
+    miscCmd.rollingCounter = message->ResolveSignal("AKit_OtherRollingCntr");
+  }
+}
+
+} // dbw_pacifica_can
@@ -0,0 +1,335 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _DBW_SIGNALS_H_
+#define _DBW_SIGNALS_H_
+
+#include <dbc/Dbc.h>
+#include <dbc/DbcMessage.h>
+#include <dbc/DbcSignal.h>
+
+namespace dbw_pacifica_can
+{
+
+// DBC messages and signals used by DbwNode.  Resolved once against the loaded DBC
+//  so a missing message or signal fails at startup instead of mid-drive, and the
+//  CAN callbacks only dereference pointers.  The few that only exist in some DBC
+//  revisions are marked optional below and left NULL when absent.
+
+struct BrakeReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* faultCh1;
+  const NewEagle::DbcSignal* faultCh2;
+  const NewEagle::DbcSignal* fault;
+  const NewEagle::DbcSignal* driverActivity;
+  const NewEagle::DbcSignal* pedalDriverInput;
+  const NewEagle::DbcSignal* pedalPositionFeedback;
+  const NewEagle::DbcSignal* enabled;
+  const NewEagle::DbcSignal* rollingCounter;
+  const NewEagle::DbcSignal* torqueActual;
+  const NewEagle::DbcSignal* interventionActive;
+  const NewEagle::DbcSignal* interventionReady;
+  const NewEagle::DbcSignal* parkingBrakeStatus;
+  const NewEagle::DbcSignal* controlType;
+};
+
+struct AcceleratorPedalReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* faultCh1;
+  const NewEagle::DbcSignal* faultCh2;
+  const NewEagle::DbcSignal* fault;
+  const NewEagle::DbcSignal* driverActivity;
+  const NewEagle::DbcSignal* pedalDriverInput;
+  const NewEagle::DbcSignal* pedalPositionFeedback;
+  const NewEagle::DbcSignal* enabled;
+  const NewEagle::DbcSignal* ignoreDriver;
+  const NewEagle::DbcSignal* torqueActual;
+  const NewEagle::DbcSignal* controlType;
+  const NewEagle::DbcSignal* rollingCounter;
+};
+
+struct SteeringReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* fault;
+  const NewEagle::DbcSignal* driverActivity;
+  const NewEagle::DbcSignal* wheelAngleActual;
+  const NewEagle::DbcSignal* wheelAngleDesired;
+  const NewEagle::DbcSignal* wheelTorqueCommand;
+  const NewEagle::DbcSignal* enabled;
+  const NewEagle::DbcSignal* rollingCounter;
+  const NewEagle::DbcSignal* controlType;
+  const NewEagle::DbcSignal* overheatPreventMode;
+};
+
+struct GearReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* driverActivity;
+  const NewEagle::DbcSignal* enabled;
+  const NewEagle::DbcSignal* stateActual;
+  const NewEagle::DbcSignal* fault;
+  const NewEagle::DbcSignal* stateReject;
+};
+
+struct WheelSpeedReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* frontLeft;
+  const NewEagle::DbcSignal* frontRight;
+  const NewEagle::DbcSignal* rearLeft;
+  const NewEagle::DbcSignal* rearRight;
+};
+
+struct WheelPositionReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* frontLeft;
+  const NewEagle::DbcSignal* frontRight;
+  const NewEagle::DbcSignal* rearLeft;
+  const NewEagle::DbcSignal* rearRight;
+  const NewEagle::DbcSignal* pulsesPerRev;
+};
+
+struct TirePressureReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* frontLeft;
+  const NewEagle::DbcSignal* frontRight;
+  const NewEagle::DbcSignal* rearLeft;
+  const NewEagle::DbcSignal* rearRight;
+};
+
+struct SurroundReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* frontRadarDistance;
+  const NewEagle::DbcSignal* rearRadarDistance;
+  const NewEagle::DbcSignal* frontRadarValid;
+  const NewEagle::DbcSignal* sonarValid;
+  const NewEagle::DbcSignal* sonarArcRearRight;
+  const NewEagle::DbcSignal* sonarArcRearLeft;
+  const NewEagle::DbcSignal* sonarArcRearCenter;
+  const NewEagle::DbcSignal* sonarArcFrontRight;
+  const NewEagle::DbcSignal* sonarArcFrontLeft;
+  const NewEagle::DbcSignal* sonarArcFrontCenter;
+};
+
+struct VinReportSignals
+{
+  enum { DIGIT_COUNT = 17 };
+
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* multiplexor;
+  const NewEagle::DbcSignal* digits[DIGIT_COUNT];
+};
+
+struct ImuReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* yawRate;
+  const NewEagle::DbcSignal* accelX;
+  const NewEagle::DbcSignal* accelY;
+};
+
+struct DriverInputReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* turnSignal;
+  const NewEagle::DbcSignal* highBeam;
+  const NewEagle::DbcSignal* wiper;
+  const NewEagle::DbcSignal* cruiseResumeButton;
+  const NewEagle::DbcSignal* cruiseCancelButton;
+  const NewEagle::DbcSignal* cruiseAccelButton;
+  const NewEagle::DbcSignal* cruiseDecelButton;
+  const NewEagle::DbcSignal* cruiseOnOffButton;
+  const NewEagle::DbcSignal* adaptiveCruiseOnOffButton;
+  const NewEagle::DbcSignal* adaptiveCruiseIncreaseDistanceButton;
+  const NewEagle::DbcSignal* adaptiveCruiseDecreaseDistanceButton;
+  const NewEagle::DbcSignal* doorOrHoodAjar;
+  const NewEagle::DbcSignal* airbagDeployed;
+  const NewEagle::DbcSignal* anySeatbeltUnbuckled;
+};
+
+struct MiscReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* fuelLevel;
+  const NewEagle::DbcSignal* byWireEnabled;
+  const NewEagle::DbcSignal* vehicleSpeed;
+  const NewEagle::DbcSignal* softwareBuildNumber;
+  const NewEagle::DbcSignal* fault;
+  const NewEagle::DbcSignal* byWireReady;
+  const NewEagle::DbcSignal* driverActivity;
+  const NewEagle::DbcSignal* commsFault;
+  const NewEagle::DbcSignal* ambientTemp;  // optional
+};
+
+struct LowVoltageSystemReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* vehicleBatteryVolts;
+  const NewEagle::DbcSignal* vehicleBatteryCurrent;
+  const NewEagle::DbcSignal* alternatorCurrent;
+  const NewEagle::DbcSignal* dbwBatteryVolts;
+  const NewEagle::DbcSignal* dcdcCurrent;
+  const NewEagle::DbcSignal* batteryContactor;
+  const NewEagle::DbcSignal* inverterContactor;
+};
+
+struct Brake2ReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* brakePressure;
+  const NewEagle::DbcSignal* roadSlopeEstimate;
+};
+
+struct Steering2ReportSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* vehicleCurvatureActual;
+};
+
+struct BrakeCmdSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* pedalRequest;
+  const NewEagle::DbcSignal* enableRequest;
+  const NewEagle::DbcSignal* requestType;
+  const NewEagle::DbcSignal* torqueRequest;
+  const NewEagle::DbcSignal* accelLimit;
+  const NewEagle::DbcSignal* decelLimit;
+  const NewEagle::DbcSignal* rollingCounter;
+};
+
+struct AcceleratorPedalCmdSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* pedalRequest;
+  const NewEagle::DbcSignal* enableRequest;
+  const NewEagle::DbcSignal* ignoreDriverOverride;
+  const NewEagle::DbcSignal* rollingCounter;
+  const NewEagle::DbcSignal* requestType;
+  const NewEagle::DbcSignal* torqueRequest;
+  const NewEagle::DbcSignal* checksum;  // optional
+  const NewEagle::DbcSignal* speedRequest;
+  const NewEagle::DbcSignal* roadSlope;
+};
+
+struct SteeringCmdSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* angleRequest;
+  const NewEagle::DbcSignal* angleVelocityLimit;
+  const NewEagle::DbcSignal* enableRequest;
+  const NewEagle::DbcSignal* ignoreDriverOverride;
+  const NewEagle::DbcSignal* torqueRequest;
+  const NewEagle::DbcSignal* requestType;
+  const NewEagle::DbcSignal* curvatureRequest;
+  const NewEagle::DbcSignal* checksum;  // optional
+  const NewEagle::DbcSignal* rollingCounter;
+};
+
+struct GearCmdSignals
+{
+  const NewEagle::DbcMessage* message;
+  const NewEagle::DbcSignal* enableRequest;
+  const NewEagle::DbcSignal* stateRequest;
+  const NewEagle::DbcSignal* checksum;  // optional
+  const NewEagle::DbcSignal* rollingCounter;
+};
+
+struct GlobalEnableCmdSignals
+{
+  const NewEagle::DbcMessage* message;  // optional, with all its signals
+  const NewEagle::DbcSignal* rollingCounter;
+  const NewEagle::DbcSignal* byWireEnableRequest;
+  const NewEagle::DbcSignal* enableJoystickLimits;
+  const NewEagle::DbcSignal* softwareBuildNumber;
+  const NewEagle::DbcSignal* checksum;
+};
+
+struct MiscCmdSignals
+{
+  const NewEagle::DbcMessage* message;  // optional, with all its signals
+  const NewEagle::DbcSignal* turnSignalRequest;
+  const NewEagle::DbcSignal* rightRearDoorRequest;
+  const NewEagle::DbcSignal* highBeamRequest;
+  const NewEagle::DbcSignal* frontWiperRequest;
+  const NewEagle::DbcSignal* rearWiperRequest;
+  const NewEagle::DbcSignal* ignitionRequest;
+  const NewEagle::DbcSignal* leftRearDoorRequest;
+  const NewEagle::DbcSignal* liftgateDoorRequest;
+  const NewEagle::DbcSignal* blockBasicCruiseButtons;
+  const NewEagle::DbcSignal* blockAdaptiveCruiseButtons;
+  const NewEagle::DbcSignal* blockTurnSignalStalk;
+  const NewEagle::DbcSignal* checksum;
+  const NewEagle::DbcSignal* rollingCounter;
+};
+
+struct DbwSignals
+{
+  BrakeReportSignals brakeReport;
+  AcceleratorPedalReportSignals acceleratorPedalReport;
+  SteeringReportSignals steeringReport;
+  GearReportSignals gearReport;
+  WheelSpeedReportSignals wheelSpeedReport;
+  WheelPositionReportSignals wheelPositionReport;
+  TirePressureReportSignals tirePressureReport;
+  SurroundReportSignals surroundReport;
+  VinReportSignals vinReport;
+  ImuReportSignals imuReport;
+  DriverInputReportSignals driverInputReport;
+  MiscReportSignals miscReport;
+  LowVoltageSystemReportSignals lowVoltageSystemReport;
+  Brake2ReportSignals brake2Report;
+  Steering2ReportSignals steering2Report;
+
+  BrakeCmdSignals brakeCmd;
+  AcceleratorPedalCmdSignals acceleratorPedalCmd;
+  SteeringCmdSignals steeringCmd;
+  GearCmdSignals gearCmd;
+  GlobalEnableCmdSignals globalEnableCmd;
+  MiscCmdSignals miscCmd;
+
+  // Throws std::runtime_error naming the first required message or signal missing
+  //  from the DBC.
+  void Resolve(const NewEagle::Dbc &dbc);
+};
+
+} // dbw_pacifica_can
+
+#endif // _DBW_SIGNALS_H_
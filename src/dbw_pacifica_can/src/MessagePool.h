@@ -0,0 +1,84 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018 New Eagle
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of New Eagle nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef _MESSAGE_POOL_H_
+#define _MESSAGE_POOL_H_
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace dbw_pacifica_can
+{
+
+// Messages DbwNode publishes by pointer, so subscribers in the same nodelet manager
+//  get the object itself instead of a serialized copy.  Such a subscriber may still
+//  be reading a message after publish returns, so a slot is only handed out again
+//  once the pool holds the last reference to it; until then a new one is allocated.
+//
+// A reused message comes back as its last publish left it.  Each caller fills the
+//  same fields every time, so there is nothing stale to clear.
+template<typename M>
+class MessagePool
+{
+public:
+  explicit MessagePool(size_t size = 4) : slots_(size), next_(0) {}
+
+  boost::shared_ptr<M> get()
+  {
+    for (size_t n = 0; n < slots_.size(); n++) {
+      boost::shared_ptr<M> &slot = slots_[next_];
+      next_ = (next_ + 1) % slots_.size();
+
+      if (!slot) {
+        slot = boost::make_shared<M>();
+        return slot;
+      }
+      if (slot.unique()) {
+        return slot;
+      }
+    }
+    return boost::make_shared<M>();
+  }
+
+private:
+  std::vector<boost::shared_ptr<M> > slots_;
+  size_t next_;
+};
+
+} // dbw_pacifica_can
+
+#endif // _MESSAGE_POOL_H_
+
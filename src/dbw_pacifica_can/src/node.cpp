@@ -45,8 +45,8 @@ int main(int argc, char **argv)
   // create DbwNode class
   dbw_pacifica_can::DbwNode n(node, priv_nh);
 
-  // handle callbacks until shut down
-  ros::spin();
+  // DbwNode runs its callbacks on its own threads; wait here until shut down
+  ros::waitForShutdown();
 
   return 0;
 }
@@ -12,6 +12,7 @@
 #include <ros/ros.h>
 #include <kvaser_interface.h>
 #include <can_msgs/Frame.h>
+#include <kvaser_interface/FrameArray.h>
 
 using namespace AS::CAN;
 
@@ -23,6 +24,41 @@ std::mutex keep_going_mut;
 KvaserCan can_reader, can_writer;
 ros::Publisher can_tx_pub;
 
+// Batching mode, on when batch_frames > 0: frames read off the bus go out together on
+// can_tx_array, once batch_frames of them are collected or the first is batch_usecs old,
+// whichever comes first.
+int batch_frames = 0;
+int batch_usecs = 1000;
+ros::Publisher can_tx_array_pub;
+
+kvaser_interface::FrameArray::Ptr new_batch()
+{
+  kvaser_interface::FrameArray::Ptr batch = boost::make_shared<kvaser_interface::FrameArray>();
+  batch->header.frame_id = "0";
+  batch->frames.reserve(batch_frames);
+  return batch;
+}
+
+// Fills a frame read off the bus the same way for can_tx and can_tx_array.
+void fill_frame(can_msgs::Frame& frame, long id, const uint8_t* msg, unsigned int size, bool extended)
+{
+  frame.header.frame_id = "0";
+  frame.header.stamp = ros::Time::now();
+  frame.id = id;
+  frame.dlc = size;
+  frame.is_extended = extended;
+  std::copy(msg, msg + 8, frame.data.begin());
+}
+
+void publish_batch(kvaser_interface::FrameArray::Ptr& batch)
+{
+  batch->header.stamp = ros::Time::now();
+  can_tx_array_pub.publish(kvaser_interface::FrameArray::ConstPtr(batch));
+
+  // Subscribers in the same process may still hold the one just published.
+  batch = new_batch();
+}
+
 void can_read()
 {
   long id;
@@ -41,6 +77,12 @@ void can_read()
 
   return_statuses ret;
 
+  kvaser_interface::FrameArray::Ptr batch;
+  std::chrono::system_clock::time_point batch_deadline;
+
+  if (batch_frames > 0)
+    batch = new_batch();
+
   while (keep_going)
   {
     std::chrono::system_clock::time_point next_time = std::chrono::system_clock::now();
@@ -57,19 +99,38 @@ void can_read()
     {
       while ((ret = can_reader.read(&id, msg, &size, &extended, &t)) == OK)
       {
-        can_msgs::Frame can_pub_msg;
-        can_pub_msg.header.frame_id = "0";
-        can_pub_msg.id = id;
-        can_pub_msg.dlc = size;
-        std::copy(msg, msg + 8, can_pub_msg.data.begin());
-        can_pub_msg.header.stamp = ros::Time::now();
-        can_tx_pub.publish(can_pub_msg);
+        if (batch_frames > 0)
+        {
+          if (batch->frames.empty())
+            batch_deadline = std::chrono::system_clock::now() + std::chrono::microseconds(batch_usecs);
+
+          batch->frames.resize(batch->frames.size() + 1);
+          fill_frame(batch->frames.back(), id, msg, size, extended);
+
+          if (batch->frames.size() >= (size_t)batch_frames || std::chrono::system_clock::now() >= batch_deadline)
+            publish_batch(batch);
+        }
+        else
+        {
+          can_msgs::Frame can_pub_msg;
+          fill_frame(can_pub_msg, id, msg, size, extended);
+          can_tx_pub.publish(can_pub_msg);
+        }
       }
 
       if (ret != NO_MESSAGES_RECEIVED)
         ROS_WARN_THROTTLE(0.5, "Kvaser CAN Interface - Error reading CAN message: %d - %s", ret, return_status_desc(ret).c_str());
     }
 
+    // A partial batch goes out once its time is up, so wake for that if it comes first.
+    if (batch_frames > 0 && !batch->frames.empty())
+    {
+      if (std::chrono::system_clock::now() >= batch_deadline)
+        publish_batch(batch);
+      else if (batch_deadline < next_time)
+        next_time = batch_deadline;
+    }
+
     std::this_thread::sleep_until(next_time);
 
     //Set local to global immediately before next loop.
@@ -87,7 +148,7 @@ void can_read()
   }
 }
 
-void can_rx_callback(const can_msgs::Frame::ConstPtr& msg)
+void write_frame(const can_msgs::Frame& msg)
 {
   return_statuses ret;
 
@@ -104,13 +165,24 @@ void can_rx_callback(const can_msgs::Frame::ConstPtr& msg)
 
   if (can_writer.is_open())
   {
-    ret = can_writer.write(msg->id, const_cast<unsigned char*>(&(msg->data[0])), msg->dlc, msg->is_extended);
+    ret = can_writer.write(msg.id, const_cast<unsigned char*>(&(msg.data[0])), msg.dlc, msg.is_extended);
 
     if (ret != OK)
       ROS_WARN_THROTTLE(0.5, "Kvaser CAN Interface - CAN send error: %d - %s", ret, return_status_desc(ret).c_str());
   }
 }
 
+void can_rx_callback(const can_msgs::Frame::ConstPtr& msg)
+{
+  write_frame(*msg);
+}
+
+void can_rx_array_callback(const kvaser_interface::FrameArray::ConstPtr& msg)
+{
+  for (size_t i = 0; i < msg->frames.size(); i++)
+    write_frame(msg->frames[i]);
+}
+
 int main(int argc, char** argv)
 {
   bool exit = false;
@@ -124,6 +196,7 @@ int main(int argc, char** argv)
   can_tx_pub = n.advertise<can_msgs::Frame>("can_tx", 500);
 
   ros::Subscriber can_rx_sub = n.subscribe("can_rx", 500, can_rx_callback);
+  ros::Subscriber can_rx_array_sub = n.subscribe("can_rx_array", 50, can_rx_array_callback);
 
   // Wait for time to be valid
   while (ros::Time::now().nsec == 0);
@@ -161,9 +234,28 @@ int main(int argc, char** argv)
     }
   }
 
+  if (priv.getParam("can_batch_frames", batch_frames))
+  {
+    ROS_INFO("Kvaser CAN Interface - Got can_batch_frames: %d", batch_frames);
+  }
+
+  if (priv.getParam("can_batch_usecs", batch_usecs))
+  {
+    ROS_INFO("Kvaser CAN Interface - Got can_batch_usecs: %d", batch_usecs);
+
+    if (batch_usecs < 0)
+    {
+      ROS_ERROR("Kvaser CAN Interface - Batch period is invalid.");
+      exit = true;
+    }
+  }
+
   if (exit)
     return 0;
 
+  if (batch_frames > 0)
+    can_tx_array_pub = n.advertise<kvaser_interface::FrameArray>("can_tx_array", 50);
+
   // Start CAN receiving thread.
   std::thread can_read_thread(can_read);
 
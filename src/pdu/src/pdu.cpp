@@ -38,6 +38,7 @@
 // pdu1_relay_pub_.publish(msg);
 
 #include <sstream>
+#include <stdexcept>
 
 #include "pdu.h"
 
@@ -47,7 +48,14 @@ namespace NewEagle
   {
     int32_t id;
     priv_nh.getParam("id", id);
-    priv_nh.getParam("pdu_dbc_file", pduFile_);
+    priv_nh.getParam("pdu_dbc_path", pduPath_);
+    if (pduPath_.empty())
+    {
+      priv_nh.getParam("pdu_dbc_file", pduFile_);
+    }
+
+    std::string dbcCacheDir = NewEagle::DbcCache::DefaultDirectory();
+    priv_nh.getParam("dbc_cache_dir", dbcCacheDir);
 
     id_ = (uint32_t)id;
 
@@ -56,7 +64,21 @@ namespace NewEagle
     fuseStatusAddr_ = FUSE_STATUS_BASE_ADDR + id_;
 
     // This should be a class, initialized with a unique CAN ID
-    pduDbc_ = NewEagle::DbcBuilder().NewDbc(pduFile_);
+    if (!pduPath_.empty())
+    {
+      pduDbc_ = NewEagle::DbcRegistry::LoadFile(pduPath_, dbcCacheDir);
+    }
+    else
+    {
+      pduDbc_ = NewEagle::DbcRegistry::Load(pduFile_, dbcCacheDir);
+    }
+
+    try {
+      resolveSignals();
+    } catch (const std::runtime_error &e) {
+      ROS_FATAL("PDU DBC is missing a required message or signal: %s", e.what());
+      throw;
+    }
 
     count_ = 0;
     // Set up Publishers
@@ -67,10 +89,37 @@ namespace NewEagle
 
     // Set up Subscribers
     sub_can_ = node.subscribe("can_rx", 100, &pdu::recvCAN, this, ros::TransportHints().tcpNoDelay(true));
+    sub_can_array_ = node.subscribe("can_rx_array", 10, &pdu::recvCANArray, this, ros::TransportHints().tcpNoDelay(true));
 
     sub_relay_cmd_ = node.subscribe("relay_cmd", 1, &pdu::recvRelayCmd, this, ros::TransportHints().tcpNoDelay(true));
   }
 
+  void pdu::resolveSignals()
+  {
+    relayStatus_ = pduDbc_->ResolveMessage("RelayStatus");
+    fuseStatus_ = pduDbc_->ResolveMessage("FuseStatus");
+    relayCommand_ = pduDbc_->ResolveMessage("RelayCommand");
+
+    for (int i = 0; i < RELAY_COUNT; i++) {
+      std::ostringstream name;
+      name << "Relay" << (i + 1);
+      relayStatusSignals_[i] = relayStatus_->ResolveSignal(name.str());
+      relayCommandSignals_[i] = relayCommand_->ResolveSignal(name.str());
+    }
+
+    for (int i = 0; i < FUSE_COUNT; i++) {
+      std::ostringstream name;
+      name << "Fuse" << (i + 1);
+      fuseStatusSignals_[i] = fuseStatus_->ResolveSignal(name.str());
+    }
+
+    relayCommandMessageId_ = relayCommand_->ResolveSignal("MessageID");
+    relayCommandGridAddress_ = relayCommand_->ResolveSignal("GridAddress");
+
+    // Encode needs a value for every signal of the message, not only the ones set per command.
+    relayCommandFrame_.Values.assign(relayCommand_->GetSignals()->size(), 0.0);
+  }
+
   void pdu::recvCAN(const can_msgs::Frame::ConstPtr& msg)
   {
     if (!msg->is_rtr && !msg->is_error && msg->is_extended)
@@ -79,19 +128,20 @@ namespace NewEagle
       {
         ROS_INFO("Relay Status");
 
-        NewEagle::DbcMessage* message = pduDbc_.GetMessage("RelayStatus");
-        message->SetFrame(msg);
+        const NewEagle::DbcMessage* message = relayStatus_;
+        NewEagle::DecodedFrame &frame = relayStatusFrame_;
+        message->Decode(*msg, frame);
 
         pdu_msgs::RelayReport out;
 
-        out.relay_1.value = message->GetSignal("Relay1")->GetResult();
-        out.relay_2.value = message->GetSignal("Relay2")->GetResult();
-        out.relay_3.value = message->GetSignal("Relay3")->GetResult();
-        out.relay_4.value = message->GetSignal("Relay4")->GetResult();
-        out.relay_5.value = message->GetSignal("Relay5")->GetResult();
-        out.relay_6.value = message->GetSignal("Relay6")->GetResult();
-        out.relay_7.value = message->GetSignal("Relay7")->GetResult();
-        out.relay_8.value = message->GetSignal("Relay8")->GetResult();
+        out.relay_1.value = frame.GetValue(relayStatusSignals_[0]);
+        out.relay_2.value = frame.GetValue(relayStatusSignals_[1]);
+        out.relay_3.value = frame.GetValue(relayStatusSignals_[2]);
+        out.relay_4.value = frame.GetValue(relayStatusSignals_[3]);
+        out.relay_5.value = frame.GetValue(relayStatusSignals_[4]);
+        out.relay_6.value = frame.GetValue(relayStatusSignals_[5]);
+        out.relay_7.value = frame.GetValue(relayStatusSignals_[6]);
+        out.relay_8.value = frame.GetValue(relayStatusSignals_[7]);
 
         relay_report_pub_.publish(out);
       }
@@ -99,52 +149,64 @@ namespace NewEagle
       {
         ROS_INFO("Fuse Status");
 
-        NewEagle::DbcMessage* message = pduDbc_.GetMessage("FuseStatus");
-        message->SetFrame(msg);
+        const NewEagle::DbcMessage* message = fuseStatus_;
+        NewEagle::DecodedFrame &frame = fuseStatusFrame_;
+        message->Decode(*msg, frame);
 
         pdu_msgs::FuseReport out;
 
-        out.fuse_1.value = message->GetSignal("Fuse1")->GetResult();
-        out.fuse_2.value = message->GetSignal("Fuse2")->GetResult();
-        out.fuse_3.value = message->GetSignal("Fuse3")->GetResult();
-        out.fuse_4.value = message->GetSignal("Fuse4")->GetResult();
-        out.fuse_5.value = message->GetSignal("Fuse5")->GetResult();
-        out.fuse_6.value = message->GetSignal("Fuse6")->GetResult();
-        out.fuse_7.value = message->GetSignal("Fuse7")->GetResult();
-        out.fuse_8.value = message->GetSignal("Fuse8")->GetResult();
-        out.fuse_9.value = message->GetSignal("Fuse9")->GetResult();
-        out.fuse_10.value = message->GetSignal("Fuse10")->GetResult();
-        out.fuse_11.value = message->GetSignal("Fuse11")->GetResult();
-        out.fuse_12.value = message->GetSignal("Fuse12")->GetResult();
-        out.fuse_13.value = message->GetSignal("Fuse13")->GetResult();
-        out.fuse_14.value = message->GetSignal("Fuse14")->GetResult();
-        out.fuse_15.value = message->GetSignal("Fuse15")->GetResult();
-        out.fuse_16.value = message->GetSignal("Fuse16")->GetResult();
+        out.fuse_1.value = frame.GetValue(fuseStatusSignals_[0]);
+        out.fuse_2.value = frame.GetValue(fuseStatusSignals_[1]);
+        out.fuse_3.value = frame.GetValue(fuseStatusSignals_[2]);
+        out.fuse_4.value = frame.GetValue(fuseStatusSignals_[3]);
+        out.fuse_5.value = frame.GetValue(fuseStatusSignals_[4]);
+        out.fuse_6.value = frame.GetValue(fuseStatusSignals_[5]);
+        out.fuse_7.value = frame.GetValue(fuseStatusSignals_[6]);
+        out.fuse_8.value = frame.GetValue(fuseStatusSignals_[7]);
+        out.fuse_9.value = frame.GetValue(fuseStatusSignals_[8]);
+        out.fuse_10.value = frame.GetValue(fuseStatusSignals_[9]);
+        out.fuse_11.value = frame.GetValue(fuseStatusSignals_[10]);
+        out.fuse_12.value = frame.GetValue(fuseStatusSignals_[11]);
+        out.fuse_13.value = frame.GetValue(fuseStatusSignals_[12]);
+        out.fuse_14.value = frame.GetValue(fuseStatusSignals_[13]);
+        out.fuse_15.value = frame.GetValue(fuseStatusSignals_[14]);
+        out.fuse_16.value = frame.GetValue(fuseStatusSignals_[15]);
 
         fuse_report_pub_.publish(out);
       }
     }
   }
 
+  // Frames batched by the bridge, handed to recvCAN as pointers into the array.
+  void pdu::recvCANArray(const kvaser_interface::FrameArray::ConstPtr& msg)
+  {
+    for (size_t i = 0; i < msg->frames.size(); i++)
+    {
+      recvCAN(can_msgs::Frame::ConstPtr(msg, &msg->frames[i]));
+    }
+  }
+
   void pdu::recvRelayCmd(const pdu_msgs::RelayCommand::ConstPtr& msg)
   {
     ROS_INFO("Relay Command");
 
-    NewEagle::DbcMessage* message = pduDbc_.GetMessage("RelayCommand");
+    const NewEagle::DbcMessage* message = relayCommand_;
+    NewEagle::DecodedFrame &values = relayCommandFrame_;
 
-    message->GetSignal("MessageID")->SetResult(0x80); // Always 0x80
-    message->GetSignal("GridAddress")->SetResult(0x00); // Always 0x00
+    values.SetValue(relayCommandMessageId_, 0x80); // Always 0x80
+    values.SetValue(relayCommandGridAddress_, 0x00); // Always 0x00
 
-    message->GetSignal("Relay1")->SetResult(msg->relay_1.value);
-    message->GetSignal("Relay2")->SetResult(msg->relay_2.value);
-    message->GetSignal("Relay3")->SetResult(msg->relay_3.value);
-    message->GetSignal("Relay4")->SetResult(msg->relay_4.value);
-    message->GetSignal("Relay5")->SetResult(msg->relay_5.value);
-    message->GetSignal("Relay6")->SetResult(msg->relay_6.value);
-    message->GetSignal("Relay7")->SetResult(msg->relay_7.value);
-    message->GetSignal("Relay8")->SetResult(msg->relay_8.value);
+    values.SetValue(relayCommandSignals_[0], msg->relay_1.value);
+    values.SetValue(relayCommandSignals_[1], msg->relay_2.value);
+    values.SetValue(relayCommandSignals_[2], msg->relay_3.value);
+    values.SetValue(relayCommandSignals_[3], msg->relay_4.value);
+    values.SetValue(relayCommandSignals_[4], msg->relay_5.value);
+    values.SetValue(relayCommandSignals_[5], msg->relay_6.value);
+    values.SetValue(relayCommandSignals_[6], msg->relay_7.value);
+    values.SetValue(relayCommandSignals_[7], msg->relay_8.value);
 
-    can_msgs::Frame frame = message->GetFrame();
+    can_msgs::Frame frame;
+    message->Encode(values, frame);
 
     // DBC file has the base address.  Modify the ID to send to correct device
     frame.id = relayCommandAddr_;
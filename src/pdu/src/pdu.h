@@ -39,6 +39,7 @@
 
 // ROS messages
 #include <can_msgs/Frame.h>
+#include <kvaser_interface/FrameArray.h>
 #include <pdu_msgs/FuseReport.h>
 #include <pdu_msgs/RelayReport.h>
 #include <pdu_msgs/RelayCommand.h>
@@ -50,6 +51,10 @@
 #include <dbc/DbcSignal.h>
 #include <dbc/Dbc.h>
 #include <dbc/DbcBuilder.h>
+#include <dbc/DbcCache.h>
+#include <dbc/DbcRegistry.h>
+
+#include <memory>
 
 namespace NewEagle
 {
@@ -61,6 +66,11 @@ namespace NewEagle
       RELAY_COMMAND_BASE_ADDR = 0x18ef0000
     };
 
+    enum {
+      RELAY_COUNT = 8,
+      FUSE_COUNT = 16
+    };
+
     public:
       pdu(ros::NodeHandle &node, ros::NodeHandle &priv_nh);
 
@@ -72,14 +82,35 @@ namespace NewEagle
 
       uint32_t count_;
 
-      NewEagle::Dbc pduDbc_;
+      // Shared read-only with every other PDU in the process, so frames are decoded into
+      //  and encoded from this instance's own DecodedFrames.
+      std::shared_ptr<const NewEagle::Dbc> pduDbc_;
       std::string pduFile_;
+      std::string pduPath_;
+
+      // Resolved once at startup so a mismatched DBC fails before any frames arrive.
+      const NewEagle::DbcMessage* relayStatus_;
+      const NewEagle::DbcMessage* fuseStatus_;
+      const NewEagle::DbcMessage* relayCommand_;
+      const NewEagle::DbcSignal* relayStatusSignals_[RELAY_COUNT];
+      const NewEagle::DbcSignal* fuseStatusSignals_[FUSE_COUNT];
+      const NewEagle::DbcSignal* relayCommandSignals_[RELAY_COUNT];
+      const NewEagle::DbcSignal* relayCommandMessageId_;
+      const NewEagle::DbcSignal* relayCommandGridAddress_;
+
+      NewEagle::DecodedFrame relayStatusFrame_;
+      NewEagle::DecodedFrame fuseStatusFrame_;
+      NewEagle::DecodedFrame relayCommandFrame_;
+
+      void resolveSignals();
 
       void recvCAN(const can_msgs::Frame::ConstPtr& msg);
+      void recvCANArray(const kvaser_interface::FrameArray::ConstPtr& msg);
       void recvRelayCmd(const pdu_msgs::RelayCommand::ConstPtr& msg);
 
       // Subscribed topics
       ros::Subscriber sub_can_;
+      ros::Subscriber sub_can_array_;
       ros::Subscriber sub_relay_cmd_;
 
       // Published topics